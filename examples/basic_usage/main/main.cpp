@@ -63,7 +63,12 @@ extern "C" void app_main(void)
          * NOTE: If this were a sensor, normally here you would wait for a 'warmup time'
          * if required by the datasheet before performing a reading.
          *
-         * vTaskDelay(pdMS_TO_TICKS(warmup_ms));
+         * PowerSession pairs the turn_on() with a turn_off() on every return path
+         * and waits only what is left of the warm-up:
+         *
+         * PowerSession session;
+         * PowerSession::acquire(led_power, timer, warmup_us, session);
+         * session.wait_ready();
          * sensor.read();
          */
 
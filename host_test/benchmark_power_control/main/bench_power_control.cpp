@@ -0,0 +1,204 @@
+#include "benchmark/benchmark.h"
+
+#include "driver/gpio.h"
+
+#include "concurrent_power_control.hpp"
+#include "power_control.hpp"
+#include "power_group.hpp"
+#include "shared_power_control.hpp"
+#include "static_power_control.hpp"
+
+using namespace power_control;
+
+/**
+ * @brief IGpioHAL that does nothing, so only the component's own overhead is measured
+ */
+class NoopGpioHAL final : public IGpioHAL
+{
+public:
+    esp_err_t reset_pin(gpio_num_t) override { return ESP_OK; }
+    esp_err_t config(const gpio_config_t &) override { return ESP_OK; }
+    esp_err_t set_level(gpio_num_t, bool level) override
+    {
+        benchmark::DoNotOptimize(level);
+        return ESP_OK;
+    }
+    esp_err_t set_drive_capability(gpio_num_t, gpio_drive_cap_t) override { return ESP_OK; }
+    esp_err_t set_levels_mask(uint64_t set_mask, uint64_t clear_mask) override
+    {
+        benchmark::DoNotOptimize(set_mask);
+        benchmark::DoNotOptimize(clear_mask);
+        return ESP_OK;
+    }
+    esp_err_t get_level(gpio_num_t, bool &level) override
+    {
+        level = false;
+        return ESP_OK;
+    }
+};
+
+static constexpr gpio_num_t BENCH_PIN = GPIO_NUM_4;
+
+// ---- HAL dispatch ----
+
+static void BM_IGpioHAL_SetLevel(benchmark::State &state)
+{
+    NoopGpioHAL noop;
+    IGpioHAL &hal = noop;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hal.set_level(BENCH_PIN, true));
+    }
+}
+BENCHMARK(BM_IGpioHAL_SetLevel);
+
+// ---- PowerControl ----
+
+static void BM_PowerControl_Init(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    PowerControl pc(hal, BENCH_PIN);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.init());
+        state.PauseTiming();
+        pc.deinit();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_PowerControl_Init);
+
+static void BM_PowerControl_TurnOn(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    PowerControl pc(hal, BENCH_PIN);
+    pc.init();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.turn_on());
+    }
+}
+BENCHMARK(BM_PowerControl_TurnOn);
+
+static void BM_PowerControl_Toggle(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    PowerControl pc(hal, BENCH_PIN);
+    pc.init();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.toggle());
+    }
+}
+BENCHMARK(BM_PowerControl_Toggle);
+
+static void BM_PowerControl_TurnOn_Idempotent(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    PowerControl pc(hal, BENCH_PIN);
+    pc.set_idempotent(true);
+    pc.init();
+    pc.turn_on();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.turn_on());
+    }
+}
+BENCHMARK(BM_PowerControl_TurnOn_Idempotent);
+
+static void BM_PowerControl_TurnOn_ReadbackVerify(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    PowerControl pc(hal, BENCH_PIN, true); // Noop HAL reads LOW = ON for active LOW
+    pc.set_readback_verify(true);
+    pc.init();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.turn_on());
+    }
+}
+BENCHMARK(BM_PowerControl_TurnOn_ReadbackVerify);
+
+#if CONFIG_POWER_CONTROL_ISR_API
+static void BM_PowerControl_TurnOnFromIsr(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    PowerControl pc(hal, BENCH_PIN);
+    pc.init();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.turn_on_from_isr());
+    }
+}
+BENCHMARK(BM_PowerControl_TurnOnFromIsr);
+#endif
+
+// ---- Variants ----
+
+static void BM_ConcurrentPowerControl_TurnOn(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    ConcurrentPowerControl pc(hal, BENCH_PIN);
+    pc.init();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.turn_on());
+    }
+}
+BENCHMARK(BM_ConcurrentPowerControl_TurnOn);
+
+static void BM_ConcurrentPowerControl_Toggle(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    ConcurrentPowerControl pc(hal, BENCH_PIN);
+    pc.init();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.toggle());
+    }
+}
+BENCHMARK(BM_ConcurrentPowerControl_Toggle);
+
+static void BM_StaticPowerControl_TurnOn(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    StaticPowerControl<BENCH_PIN, false, NoopGpioHAL> pc(hal);
+    pc.init();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.turn_on());
+    }
+}
+BENCHMARK(BM_StaticPowerControl_TurnOn);
+
+static void BM_StaticPowerControl_Toggle(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    StaticPowerControl<BENCH_PIN, false, NoopGpioHAL> pc(hal);
+    pc.init();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pc.toggle());
+    }
+}
+BENCHMARK(BM_StaticPowerControl_Toggle);
+
+static void BM_PowerGroup_TurnOnAll(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    const PowerGroup::Rail rails[] = {
+        {GPIO_NUM_4, false},
+        {GPIO_NUM_5, true},
+        {GPIO_NUM_6, false},
+    };
+    PowerGroup group(hal, rails, 3);
+    group.init();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(group.turn_on_all());
+    }
+}
+BENCHMARK(BM_PowerGroup_TurnOnAll);
+
+static void BM_SharedPowerControl_AcquireRelease(benchmark::State &state)
+{
+    NoopGpioHAL hal;
+    PowerControl pc(hal, BENCH_PIN);
+    pc.init();
+    SharedPowerControl shared(pc);
+    shared.acquire(); // Keep a reference so the loop measures the uncontended fast path
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shared.acquire());
+        benchmark::DoNotOptimize(shared.release());
+    }
+    shared.release();
+}
+BENCHMARK(BM_SharedPowerControl_AcquireRelease);
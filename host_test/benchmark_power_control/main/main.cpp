@@ -0,0 +1,18 @@
+#include <cstdlib>
+
+#include "benchmark/benchmark.h"
+
+extern "C" void app_main(void)
+{
+    // JSON by default so results can be stored and compared between releases.
+    // Other flags can be set through the environment, e.g. BENCHMARK_FILTER=PowerControl.
+    char arg0[] = "benchmark_power_control";
+    char arg1[] = "--benchmark_format=json";
+    char *argv[] = {arg0, arg1, nullptr};
+    int argc = 2;
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    exit(0);
+}
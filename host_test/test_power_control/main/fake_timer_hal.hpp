@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "i_timer_hal.hpp"
+
+/**
+ * @brief ITimerHAL fake driven by a manually advanced virtual clock
+ *
+ * Timers fire synchronously from advance(), in deadline order.
+ */
+class FakeTimerHAL : public power_control::ITimerHAL
+{
+public:
+    struct Timer
+    {
+        power_control::timer_callback_t callback;
+        void *arg;
+        int64_t deadline_us;
+        bool armed;
+        bool deleted;
+    };
+
+    int64_t get_time_us() override { return now_us; }
+
+    esp_err_t create(power_control::timer_callback_t callback, void *arg, power_control::timer_handle_t *out) override
+    {
+        if (fail_create) {
+            return ESP_ERR_NO_MEM;
+        }
+        timers.push_back({callback, arg, 0, false, false});
+        *out = reinterpret_cast<power_control::timer_handle_t>(timers.size()); // 1-based index
+        return ESP_OK;
+    }
+
+    esp_err_t start_once(power_control::timer_handle_t handle, uint64_t timeout_us) override
+    {
+        Timer &t = get(handle);
+        if (t.armed) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        t.deadline_us = now_us + static_cast<int64_t>(timeout_us);
+        t.armed = true;
+        starts++;
+        return ESP_OK;
+    }
+
+    esp_err_t stop(power_control::timer_handle_t handle) override
+    {
+        get(handle).armed = false;
+        return ESP_OK;
+    }
+
+    esp_err_t remove(power_control::timer_handle_t handle) override
+    {
+        get(handle).deleted = true;
+        return ESP_OK;
+    }
+
+    /// Delays advance the virtual clock, firing the timers that expire meanwhile
+    void delay_us(uint32_t us) override
+    {
+        delayed_us += us;
+        advance(us);
+    }
+
+    /**
+     * @brief Advance the virtual clock, firing every timer that expires on the way
+     */
+    void advance(int64_t us)
+    {
+        const int64_t target = now_us + us;
+        while (true) {
+            Timer *next = nullptr;
+            for (Timer &t : timers) {
+                if (t.armed && !t.deleted && t.deadline_us <= target &&
+                    (next == nullptr || t.deadline_us < next->deadline_us)) {
+                    next = &t;
+                }
+            }
+            if (next == nullptr) {
+                break;
+            }
+            now_us = next->deadline_us;
+            next->armed = false;
+            next->callback(next->arg);
+        }
+        now_us = target;
+    }
+
+    bool is_armed(size_t index) const { return index < timers.size() && timers[index].armed; }
+
+    Timer &get(power_control::timer_handle_t handle) { return timers[reinterpret_cast<uintptr_t>(handle) - 1]; }
+
+    int64_t now_us = 0;
+    int starts = 0;
+    int64_t delayed_us = 0;
+    bool fail_create = false;
+    std::vector<Timer> timers;
+};
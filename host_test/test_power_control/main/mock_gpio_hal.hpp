@@ -0,0 +1,20 @@
+#pragma once
+
+#include "gmock/gmock.h"
+
+#include "driver/gpio.h"
+
+#include "i_gpio_hal.hpp"
+
+class MockGpioHAL : public power_control::IGpioHAL
+{
+public:
+    MOCK_METHOD(esp_err_t, reset_pin, (gpio_num_t pin), (override));
+    MOCK_METHOD(esp_err_t, config, (const gpio_config_t &config), (override));
+    MOCK_METHOD(esp_err_t, set_level, (gpio_num_t pin, bool level), (override));
+    MOCK_METHOD(esp_err_t, set_drive_capability, (gpio_num_t gpio_num, gpio_drive_cap_t strength), (override));
+    MOCK_METHOD(esp_err_t, set_levels_mask, (uint64_t set_mask, uint64_t clear_mask), (override));
+    MOCK_METHOD(esp_err_t, get_level, (gpio_num_t pin, bool &level), (override));
+    MOCK_METHOD(esp_err_t, set_hold, (gpio_num_t pin, bool enable), (override));
+    MOCK_METHOD(esp_err_t, set_deep_sleep_hold, (bool enable), (override));
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "gmock/gmock.h"
+
+#include "driver/gpio.h"
+
+#include "i_ledc_hal.hpp"
+
+class MockLedcHAL : public power_control::ILedcHAL
+{
+public:
+    MOCK_METHOD(esp_err_t, start_ramp, (gpio_num_t gpio, bool inverted, uint32_t ramp_time_ms), (override));
+    MOCK_METHOD(esp_err_t, stop, (gpio_num_t gpio), (override));
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "fake_timer_hal.hpp"
+#include "power_control.hpp"
+#include "recording_gpio_hal.hpp"
+
+/**
+ * @brief Three initialized rails on a RecordingGpioHAL, for the PowerProfileGroup-based tests
+ *
+ * SetUp() clears the events recorded by init_all(), so tests see only their own writes.
+ */
+class ProfileRailsTest : public ::testing::Test
+{
+protected:
+    RecordingGpioHAL hal;
+    FakeTimerHAL fake_timer;
+
+    // GPIO4 and GPIO6 active HIGH, GPIO5 active LOW
+    power_control::PowerControl sensor{hal, fake_timer, GPIO_NUM_4, false, false};
+    power_control::PowerControl modem{hal, fake_timer, GPIO_NUM_5, true, false};
+    power_control::PowerControl heater{hal, fake_timer, GPIO_NUM_6, false, false};
+    power_control::PowerControl *const rails[3] = {&sensor, &modem, &heater};
+
+    const uint64_t PIN_4 = 1ULL << GPIO_NUM_4;
+    const uint64_t PIN_5 = 1ULL << GPIO_NUM_5;
+    const uint64_t PIN_6 = 1ULL << GPIO_NUM_6;
+
+    void SetUp() override
+    {
+        ASSERT_EQ(ESP_OK, power_control::PowerControl::init_all(rails));
+        hal.events.clear();
+    }
+};
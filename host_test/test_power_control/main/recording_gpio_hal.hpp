@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "driver/gpio.h"
+
+#include "i_gpio_hal.hpp"
+
+/**
+ * @brief IGpioHAL fake that records every call as one event
+ *
+ * A batched call (set_levels_mask(), reset_pins_mask(), set_drive_capability_mask())
+ * is captured as a single event holding its masks, so a test can assert that a
+ * group of rails really switched in one write. Levels written by either path are
+ * tracked per pin and can be read back with get_level().
+ *
+ * With `batched = false` the batched calls fall back to the IGpioHAL per-pin
+ * defaults, which then show up as one event per pin.
+ */
+class RecordingGpioHAL : public power_control::IGpioHAL
+{
+public:
+    enum class Op
+    {
+        RESET_PIN,
+        CONFIG,
+        SET_LEVEL,
+        SET_DRIVE_CAPABILITY,
+        SET_LEVELS_MASK,
+        RESET_PINS_MASK,
+        SET_DRIVE_CAPABILITY_MASK,
+    };
+
+    struct Event
+    {
+        Op op;
+        uint64_t mask;       ///< Pin (as a bit), config pin_bit_mask or set/reset/drive mask
+        uint64_t clear_mask; ///< set_levels_mask() clear mask
+        int value;           ///< Level or drive capability
+    };
+
+    explicit RecordingGpioHAL(bool batched = true)
+        : batched_(batched)
+    {
+    }
+
+    esp_err_t reset_pin(gpio_num_t pin) override
+    {
+        return record({Op::RESET_PIN, bit(pin), 0, 0});
+    }
+
+    esp_err_t config(const gpio_config_t &config) override
+    {
+        return record({Op::CONFIG, config.pin_bit_mask, 0, config.mode});
+    }
+
+    esp_err_t set_level(gpio_num_t pin, bool level) override
+    {
+        esp_err_t ret = record({Op::SET_LEVEL, bit(pin), 0, level});
+        if (ret == ESP_OK) {
+            levels = level ? (levels | bit(pin)) : (levels & ~bit(pin));
+        }
+        return ret;
+    }
+
+    esp_err_t set_drive_capability(gpio_num_t pin, gpio_drive_cap_t strength) override
+    {
+        return record({Op::SET_DRIVE_CAPABILITY, bit(pin), 0, strength});
+    }
+
+    esp_err_t set_levels_mask(uint64_t set_mask, uint64_t clear_mask) override
+    {
+        if (!batched_) {
+            return IGpioHAL::set_levels_mask(set_mask, clear_mask);
+        }
+        if ((set_mask & clear_mask) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        esp_err_t ret = record({Op::SET_LEVELS_MASK, set_mask, clear_mask, 0});
+        if (ret == ESP_OK) {
+            levels = (levels | set_mask) & ~clear_mask;
+        }
+        return ret;
+    }
+
+    esp_err_t reset_pins_mask(uint64_t mask) override
+    {
+        if (!batched_) {
+            return IGpioHAL::reset_pins_mask(mask);
+        }
+        return record({Op::RESET_PINS_MASK, mask, 0, 0});
+    }
+
+    esp_err_t set_drive_capability_mask(uint64_t mask, gpio_drive_cap_t strength) override
+    {
+        if (!batched_) {
+            return IGpioHAL::set_drive_capability_mask(mask, strength);
+        }
+        return record({Op::SET_DRIVE_CAPABILITY_MASK, mask, 0, strength});
+    }
+
+    esp_err_t get_level(gpio_num_t pin, bool &level) override
+    {
+        level = (levels & bit(pin)) != 0;
+        return ESP_OK;
+    }
+
+    /**
+     * @brief Number of recorded events of one kind
+     */
+    size_t count(Op op) const
+    {
+        size_t n = 0;
+        for (const Event &e : events) {
+            n += e.op == op ? 1 : 0;
+        }
+        return n;
+    }
+
+    std::vector<Event> events;
+    uint64_t levels = 0;    ///< Bit N set = GPIO N driven HIGH
+    uint64_t fail_mask = 0; ///< Calls touching one of these pins return fail_error
+    esp_err_t fail_error = ESP_FAIL;
+
+private:
+    static uint64_t bit(gpio_num_t pin) { return (pin >= 0 && pin < GPIO_NUM_MAX) ? (1ULL << pin) : 0; }
+
+    esp_err_t record(const Event &event)
+    {
+        events.push_back(event);
+        return ((event.mask | event.clear_mask) & fail_mask) != 0 ? fail_error : ESP_OK;
+    }
+
+    bool batched_;
+};
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstdint>
+
+#include "driver/gpio.h"
+
+#include "fake_timer_hal.hpp"
+#include "i_gpio_hal.hpp"
+
+/**
+ * @brief IGpioHAL simulation of the GPIO pads, timed by a FakeTimerHAL virtual clock
+ *
+ * Unlike MockGpioHAL, no call has to be expected: the simulation behaves like the
+ * pads of the chip and a test only checks the outcome. Each pin models its output
+ * enable, output register, pad level, drive capability and hold latch:
+ * - The pad follows the output register when the pin is configured as output, and
+ *   reads LOW otherwise.
+ * - A held pad keeps its level; writes only reach the output register, and the pad
+ *   takes them over when the hold is released.
+ * - reset_pin() returns the pin to its reset state (input, LOW, GPIO_DRIVE_CAP_2,
+ *   not held).
+ *
+ * Every pad edge is timestamped with the virtual clock, so a test can read the
+ * number of edges and the HIGH time of a pin after advancing the clock by hours
+ * of simulated duty cycling. deep_sleep() models a deep-sleep cycle of the chip.
+ */
+class SimGpioHAL : public power_control::IGpioHAL
+{
+public:
+    struct Pin
+    {
+        bool output = false;                       ///< Output enabled by config()
+        bool out_level = false;                    ///< Output register
+        bool pad = false;                          ///< Level on the pad
+        bool held = false;                         ///< Pad latched by set_hold()
+        gpio_drive_cap_t drive = GPIO_DRIVE_CAP_2; ///< Drive capability
+        uint32_t edges = 0;                        ///< Pad level changes
+        int64_t high_us = 0;                       ///< Closed HIGH periods
+        int64_t changed_at_us = 0;                 ///< Time of the last pad change
+    };
+
+    explicit SimGpioHAL(FakeTimerHAL &clock)
+        : clock_(clock)
+    {
+    }
+
+    esp_err_t reset_pin(gpio_num_t pin) override
+    {
+        esp_err_t ret = check(bit(pin));
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        Pin &p = pins[pin];
+        p.output = false;
+        p.out_level = false;
+        p.held = false;
+        p.drive = GPIO_DRIVE_CAP_2;
+        update_pad(pin);
+        return ESP_OK;
+    }
+
+    esp_err_t config(const gpio_config_t &config) override
+    {
+        esp_err_t ret = check(config.pin_bit_mask);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        for (int n = 0; n < GPIO_NUM_MAX; n++) {
+            if ((config.pin_bit_mask & (1ULL << n)) != 0) {
+                pins[n].output = (config.mode & GPIO_MODE_OUTPUT) != 0;
+                update_pad(static_cast<gpio_num_t>(n));
+            }
+        }
+        return ESP_OK;
+    }
+
+    esp_err_t set_level(gpio_num_t pin, bool level) override
+    {
+        esp_err_t ret = check(bit(pin));
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        pins[pin].out_level = level;
+        update_pad(pin);
+        return ESP_OK;
+    }
+
+    esp_err_t set_drive_capability(gpio_num_t pin, gpio_drive_cap_t strength) override
+    {
+        esp_err_t ret = check(bit(pin));
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (strength < GPIO_DRIVE_CAP_0 || strength >= GPIO_DRIVE_CAP_MAX) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        pins[pin].drive = strength;
+        return ESP_OK;
+    }
+
+    /// All pins of the mask change at the same virtual time
+    esp_err_t set_levels_mask(uint64_t set_mask, uint64_t clear_mask) override
+    {
+        if ((set_mask & clear_mask) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        esp_err_t ret = check(set_mask | clear_mask);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        for (int n = 0; n < GPIO_NUM_MAX; n++) {
+            const uint64_t pin_bit = 1ULL << n;
+            if (((set_mask | clear_mask) & pin_bit) != 0) {
+                pins[n].out_level = (set_mask & pin_bit) != 0;
+                update_pad(static_cast<gpio_num_t>(n));
+            }
+        }
+        return ESP_OK;
+    }
+
+    esp_err_t get_level(gpio_num_t pin, bool &level) override
+    {
+        esp_err_t ret = check(bit(pin));
+        if (ret == ESP_OK) {
+            level = pins[pin].pad;
+        }
+        return ret;
+    }
+
+    esp_err_t set_hold(gpio_num_t pin, bool enable) override
+    {
+        esp_err_t ret = check(bit(pin));
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        pins[pin].held = enable;
+        update_pad(pin);
+        return ESP_OK;
+    }
+
+    esp_err_t set_deep_sleep_hold(bool enable) override
+    {
+        deep_sleep_hold = enable;
+        return ESP_OK;
+    }
+
+    /**
+     * @brief Simulate a deep-sleep cycle of @p sleep_us
+     *
+     * Pads held with the deep-sleep hold enabled keep their level; every other pin
+     * falls back to its reset state when the chip goes to sleep. The registers and
+     * the timers do not survive: output registers are cleared and pending timers
+     * are dropped before the virtual clock jumps ahead. The rails must afterwards
+     * be constructed again, as after a real wake-up.
+     */
+    void deep_sleep(int64_t sleep_us)
+    {
+        for (int n = 0; n < GPIO_NUM_MAX; n++) {
+            Pin &p = pins[n];
+            p.held = p.held && deep_sleep_hold;
+            p.output = false;
+            p.out_level = false;
+            p.drive = GPIO_DRIVE_CAP_2;
+            update_pad(static_cast<gpio_num_t>(n));
+        }
+        for (FakeTimerHAL::Timer &t : clock_.timers) {
+            t.armed = false;
+            t.deleted = true;
+        }
+        clock_.now_us += sleep_us;
+    }
+
+    /**
+     * @brief Level on the pad of @p pin
+     */
+    bool level(gpio_num_t pin) const { return pins[pin].pad; }
+
+    /**
+     * @brief Number of pad level changes of @p pin
+     */
+    uint32_t edges(gpio_num_t pin) const { return pins[pin].edges; }
+
+    /**
+     * @brief Time the pad of @p pin has been HIGH, including the current period
+     */
+    int64_t high_time_us(gpio_num_t pin) const
+    {
+        const Pin &p = pins[pin];
+        return p.high_us + (p.pad ? clock_.now_us - p.changed_at_us : 0);
+    }
+
+    Pin pins[GPIO_NUM_MAX] = {};
+    bool deep_sleep_hold = false; ///< Chip-wide deep-sleep hold enabled
+    uint64_t fail_mask = 0;       ///< Calls touching one of these pins return fail_error
+    esp_err_t fail_error = ESP_FAIL;
+
+private:
+    static uint64_t bit(gpio_num_t pin) { return (pin >= 0 && pin < GPIO_NUM_MAX) ? (1ULL << pin) : 0; }
+
+    esp_err_t check(uint64_t mask) const
+    {
+        if (mask == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        return (mask & fail_mask) != 0 ? fail_error : ESP_OK;
+    }
+
+    void update_pad(gpio_num_t pin)
+    {
+        Pin &p = pins[pin];
+        if (p.held) {
+            return; // Latched until the hold is released
+        }
+        const bool pad = p.output && p.out_level;
+        if (pad == p.pad) {
+            return;
+        }
+        if (p.pad) {
+            p.high_us += clock_.now_us - p.changed_at_us;
+        }
+        p.pad = pad;
+        p.changed_at_us = clock_.now_us;
+        p.edges++;
+    }
+
+    FakeTimerHAL &clock_;
+};
@@ -0,0 +1,166 @@
+#include <atomic>
+#include <thread>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "concurrent_power_control.hpp"
+#include "mock_gpio_hal.hpp"
+
+using ::testing::_;
+using ::testing::Field;
+using ::testing::Return;
+
+using namespace power_control;
+
+/**
+ * @brief Minimal thread-safe HAL keeping the output register as an atomic word
+ */
+class AtomicGpioHAL : public IGpioHAL
+{
+public:
+    esp_err_t reset_pin(gpio_num_t) override { return ESP_OK; }
+    esp_err_t config(const gpio_config_t &) override { return ESP_OK; }
+    esp_err_t set_level(gpio_num_t pin, bool level) override
+    {
+        return level ? set_levels_mask(1ULL << pin, 0) : set_levels_mask(0, 1ULL << pin);
+    }
+    esp_err_t set_drive_capability(gpio_num_t, gpio_drive_cap_t) override { return ESP_OK; }
+    esp_err_t set_levels_mask(uint64_t set_mask, uint64_t clear_mask) override
+    {
+        out.fetch_and(~clear_mask);
+        out.fetch_or(set_mask);
+        std::this_thread::yield(); // Widen the race window between tasks
+        return ESP_OK;
+    }
+
+    std::atomic<uint64_t> out{0};
+};
+
+class ConcurrentPowerControlTest : public ::testing::Test
+{
+protected:
+    MockGpioHAL mock_gpio;
+    const gpio_num_t TEST_PIN = GPIO_NUM_4;
+    const uint64_t PIN_MASK = 1ULL << GPIO_NUM_4;
+
+    void expect_init(uint64_t set_mask, uint64_t clear_mask)
+    {
+        EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, config(Field(&gpio_config_t::pin_bit_mask, PIN_MASK))).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, set_levels_mask(set_mask, clear_mask)).WillOnce(Return(ESP_OK));
+    }
+};
+
+TEST_F(ConcurrentPowerControlTest, NormalLogic_SingleStorePerSwitch)
+{
+    ConcurrentPowerControl pc(mock_gpio, TEST_PIN, false, false);
+    expect_init(0, PIN_MASK);
+    ASSERT_EQ(ESP_OK, pc.init());
+    EXPECT_TRUE(pc.is_initialized());
+    EXPECT_FALSE(pc.is_on());
+
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_MASK, 0)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(pc.is_on());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, PIN_MASK)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.toggle());
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(ConcurrentPowerControlTest, InvertedLogic_InitOnAndTurnOff)
+{
+    ConcurrentPowerControl pc(mock_gpio, TEST_PIN, true, true);
+    expect_init(0, PIN_MASK); // ON = LOW
+    ASSERT_EQ(ESP_OK, pc.init());
+    EXPECT_TRUE(pc.is_on());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_MASK, 0)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(ConcurrentPowerControlTest, Operations_FailWhenNotInitialized)
+{
+    ConcurrentPowerControl pc(mock_gpio, TEST_PIN);
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_off());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.toggle());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.set_drive_capability(GPIO_DRIVE_CAP_3));
+    EXPECT_EQ(ESP_OK, pc.deinit()); // No-op
+}
+
+TEST_F(ConcurrentPowerControlTest, HalFailure_RestoresPreviousState)
+{
+    ConcurrentPowerControl pc(mock_gpio, TEST_PIN);
+    expect_init(0, PIN_MASK);
+    ASSERT_EQ(ESP_OK, pc.init());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_MASK, 0)).WillOnce(Return(ESP_FAIL));
+    EXPECT_EQ(ESP_FAIL, pc.turn_on());
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(ConcurrentPowerControlTest, Init_FailureLeavesUninitialized)
+{
+    ConcurrentPowerControl pc(mock_gpio, TEST_PIN);
+
+    EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.init());
+    EXPECT_FALSE(pc.is_initialized());
+
+    ConcurrentPowerControl invalid(mock_gpio, GPIO_NUM_NC);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, invalid.init());
+}
+
+TEST_F(ConcurrentPowerControlTest, Deinit_ForcesLowAndResets)
+{
+    ConcurrentPowerControl pc(mock_gpio, TEST_PIN, false, true);
+    expect_init(PIN_MASK, 0);
+    ASSERT_EQ(ESP_OK, pc.init());
+    EXPECT_EQ(ESP_OK, pc.init()); // Idempotent
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, PIN_MASK)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_ERR_INVALID_STATE));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.deinit());
+    EXPECT_FALSE(pc.is_initialized());
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(ConcurrentPowerControlTest, RacingSwitches_PinMatchesFinalState)
+{
+    AtomicGpioHAL hal;
+    ConcurrentPowerControl pc(hal, TEST_PIN);
+    ASSERT_EQ(ESP_OK, pc.init());
+
+    for (int round = 0; round < 50; round++) {
+        std::thread on_task([&] {
+            for (int i = 0; i < 200; i++) {
+                pc.turn_on();
+            }
+        });
+        std::thread off_task([&] {
+            for (int i = 0; i < 200; i++) {
+                pc.turn_off();
+            }
+        });
+        std::thread toggle_task([&] {
+            for (int i = 0; i < 200; i++) {
+                pc.toggle();
+            }
+        });
+        on_task.join();
+        off_task.join();
+        toggle_task.join();
+
+        // Whatever the interleaving, the pin converges to the logical state
+        ASSERT_EQ(pc.is_on(), (hal.out.load() & PIN_MASK) != 0) << "round " << round;
+    }
+}
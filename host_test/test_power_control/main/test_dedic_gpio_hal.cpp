@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "dedic_gpio_hal.hpp"
+#include "power_group.hpp"
+
+using namespace power_control;
+
+// Linux has no Dedicated GPIO peripheral, so only the bundle bookkeeping and the
+// GpioHAL fallback guards are exercised; no call reaches the GPIO driver mock.
+
+TEST(DedicGpioHALTest, BundleChannelsFollowPinOrder)
+{
+    const gpio_num_t pins[] = {GPIO_NUM_6, GPIO_NUM_4, GPIO_NUM_5};
+    DedicGpioHAL hal(pins);
+
+    EXPECT_EQ((1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_5) | (1ULL << GPIO_NUM_6), hal.get_pin_mask());
+    EXPECT_EQ(0x1u, hal.to_channels(1ULL << GPIO_NUM_6));
+    EXPECT_EQ(0x6u, hal.to_channels((1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_5)));
+    EXPECT_EQ(0u, hal.to_channels(1ULL << GPIO_NUM_7)); // Not in the bundle
+}
+
+TEST(DedicGpioHALTest, InvalidPinListsLeaveTheBundleEmpty)
+{
+    const gpio_num_t duplicated[] = {GPIO_NUM_4, GPIO_NUM_4};
+    const gpio_num_t invalid[] = {GPIO_NUM_4, GPIO_NUM_NC};
+    const gpio_num_t too_many[] = {
+        GPIO_NUM_0, GPIO_NUM_1, GPIO_NUM_2, GPIO_NUM_3, GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_6, GPIO_NUM_7, GPIO_NUM_8};
+
+    EXPECT_EQ(0u, DedicGpioHAL(duplicated).get_pin_mask());
+    EXPECT_EQ(0u, DedicGpioHAL(invalid).get_pin_mask());
+    EXPECT_EQ(0u, DedicGpioHAL(too_many, 9).get_pin_mask());
+}
+
+TEST(DedicGpioHALTest, NoBundleWithoutThePeripheral)
+{
+    const gpio_num_t pins[] = {GPIO_NUM_4};
+    DedicGpioHAL hal(pins);
+
+    EXPECT_FALSE(hal.is_active());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, hal.write_channels(0x1, 0x1));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, hal.set_levels_mask(1ULL << GPIO_NUM_4, 1ULL << GPIO_NUM_4));
+}
+
+TEST(DedicGpioHALTest, PowerGroupOutsideBundleIsNotBound)
+{
+    const gpio_num_t pins[] = {GPIO_NUM_4, GPIO_NUM_5};
+    DedicGpioHAL hal(pins);
+    const PowerGroup::Rail rails[] = {{GPIO_NUM_4, false}, {GPIO_NUM_7, false}};
+
+    // Falls back to IGpioHAL writes; not initialized, so nothing reaches the driver
+    PowerGroup group(hal, rails, 2);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, group.turn_on_all());
+}
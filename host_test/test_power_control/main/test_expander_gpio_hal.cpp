@@ -0,0 +1,229 @@
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "expander_gpio_hal.hpp"
+#include "i_register_bus.hpp"
+#include "power_control.hpp"
+#include "power_group.hpp"
+
+using namespace power_control;
+
+/// Register file of an expander, with one entry per bus transaction
+class FakeRegisterBus : public IRegisterBus
+{
+public:
+    struct Write
+    {
+        uint8_t reg;
+        uint16_t value;
+    };
+
+    esp_err_t write_registers(uint8_t reg, const uint8_t *data, size_t len) override
+    {
+        if (fail_writes) {
+            return ESP_ERR_TIMEOUT;
+        }
+        memcpy(&regs[reg], data, len);
+        writes.push_back({reg, static_cast<uint16_t>(data[0] | (len > 1 ? data[1] << 8 : 0))});
+        return ESP_OK;
+    }
+
+    esp_err_t read_registers(uint8_t reg, uint8_t *data, size_t len) override
+    {
+        reads++;
+        memcpy(data, &regs[reg], len);
+        return ESP_OK;
+    }
+
+    uint16_t reg16(uint8_t reg) const { return static_cast<uint16_t>(regs[reg] | (regs[reg + 1] << 8)); }
+
+    uint8_t regs[256] = {};
+    std::vector<Write> writes;
+    int reads = 0;
+    bool fail_writes = false;
+};
+
+class ExpanderGpioHALTest : public ::testing::Test
+{
+protected:
+    static constexpr uint8_t TCA_INPUT = 0x00;
+    static constexpr uint8_t TCA_OUTPUT = 0x02;
+    static constexpr uint8_t TCA_CONFIG = 0x06;
+
+    FakeRegisterBus bus;
+    ExpanderGpioHAL expander{bus, ExpanderChip::TCA9555};
+
+    void SetUp() override
+    {
+        // TCA9555 power-on state: outputs HIGH, every pin an input
+        bus.regs[TCA_OUTPUT] = bus.regs[TCA_OUTPUT + 1] = 0xFF;
+        bus.regs[TCA_CONFIG] = bus.regs[TCA_CONFIG + 1] = 0xFF;
+        ASSERT_EQ(ESP_OK, expander.init());
+        bus.reads = 0;
+    }
+};
+
+TEST_F(ExpanderGpioHALTest, Init_LoadsShadowFromChip)
+{
+    EXPECT_EQ(0xFFFF, expander.get_output_shadow());
+    EXPECT_EQ(0xFFFF, expander.get_input_mask());
+    EXPECT_FALSE(expander.has_pending());
+    EXPECT_TRUE(bus.writes.empty());
+}
+
+TEST_F(ExpanderGpioHALTest, CallsBeforeInitAreRejected)
+{
+    ExpanderGpioHAL fresh(bus, ExpanderChip::TCA9555);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, fresh.set_level(GPIO_NUM_0, true));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, fresh.flush());
+    EXPECT_TRUE(bus.writes.empty());
+}
+
+TEST_F(ExpanderGpioHALTest, PowerControlRailOnExpanderPin)
+{
+    PowerControl rail(expander, GPIO_NUM_3, false, false);
+    ASSERT_EQ(ESP_OK, rail.init());
+
+    EXPECT_EQ(0xFFFF & ~(1u << 3), bus.reg16(TCA_CONFIG)); // P03 output
+    EXPECT_EQ(0xFFFF & ~(1u << 3), bus.reg16(TCA_OUTPUT)); // Driven LOW (OFF)
+
+    bus.writes.clear();
+    ASSERT_EQ(ESP_OK, rail.turn_on());
+    ASSERT_EQ(1u, bus.writes.size());
+    EXPECT_EQ(TCA_OUTPUT, bus.writes[0].reg);
+    EXPECT_EQ(0xFFFF, bus.writes[0].value); // Both ports in one transaction
+}
+
+TEST_F(ExpanderGpioHALTest, OutputsAreWrittenBeforeDirection)
+{
+    expander.begin_batch();
+    ASSERT_EQ(ESP_OK, expander.set_level(GPIO_NUM_1, false));
+    gpio_config_t io_conf = {};
+    io_conf.mode = GPIO_MODE_INPUT_OUTPUT;
+    io_conf.pin_bit_mask = 1ULL << GPIO_NUM_1;
+    ASSERT_EQ(ESP_OK, expander.config(io_conf));
+    EXPECT_TRUE(bus.writes.empty());
+    ASSERT_EQ(ESP_OK, expander.end_batch());
+
+    ASSERT_EQ(2u, bus.writes.size());
+    EXPECT_EQ(TCA_OUTPUT, bus.writes[0].reg);
+    EXPECT_EQ(TCA_CONFIG, bus.writes[1].reg);
+}
+
+TEST_F(ExpanderGpioHALTest, GroupOfEightRailsSwitchesInOneWrite)
+{
+    PowerGroup::Rail rails[8];
+    for (int i = 0; i < 8; i++) {
+        rails[i] = {static_cast<gpio_num_t>(8 + i), false};
+    }
+    PowerGroup group(expander, rails, 8);
+    ASSERT_EQ(ESP_OK, group.init());
+
+    bus.writes.clear();
+    ASSERT_EQ(ESP_OK, group.turn_on_all());
+    ASSERT_EQ(1u, bus.writes.size());
+    EXPECT_EQ(0xFF00, bus.reg16(TCA_OUTPUT) & 0xFF00);
+}
+
+TEST_F(ExpanderGpioHALTest, BatchCoalescesIndividualRails)
+{
+    PowerControl gps(expander, GPIO_NUM_0);
+    PowerControl lna(expander, GPIO_NUM_1);
+    PowerControl modem(expander, GPIO_NUM_2, false, true);
+    PowerControl *const rails[] = {&gps, &lna, &modem};
+    ASSERT_EQ(ESP_OK, PowerControl::init_all(rails));
+    bus.writes.clear();
+
+    expander.begin_batch();
+    ASSERT_EQ(ESP_OK, gps.turn_on());
+    ASSERT_EQ(ESP_OK, lna.turn_on());
+    ASSERT_EQ(ESP_OK, modem.turn_off());
+    EXPECT_TRUE(bus.writes.empty());
+    EXPECT_TRUE(expander.has_pending());
+
+    ASSERT_EQ(ESP_OK, expander.end_batch());
+    ASSERT_EQ(1u, bus.writes.size());
+    EXPECT_EQ(0x3u, bus.reg16(TCA_OUTPUT) & 0x7);
+    EXPECT_FALSE(expander.has_pending());
+}
+
+TEST_F(ExpanderGpioHALTest, NestedBatchesFlushOnOutermostEnd)
+{
+    expander.begin_batch();
+    expander.begin_batch();
+    ASSERT_EQ(ESP_OK, expander.set_level(GPIO_NUM_4, false));
+    ASSERT_EQ(ESP_OK, expander.end_batch());
+    EXPECT_TRUE(bus.writes.empty());
+    ASSERT_EQ(ESP_OK, expander.end_batch());
+    EXPECT_EQ(1u, bus.writes.size());
+
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, expander.end_batch());
+}
+
+TEST_F(ExpanderGpioHALTest, FailedWriteOutsideBatchRestoresShadow)
+{
+    bus.fail_writes = true;
+    EXPECT_EQ(ESP_ERR_TIMEOUT, expander.set_level(GPIO_NUM_4, false));
+    EXPECT_EQ(0xFFFF, expander.get_output_shadow());
+    EXPECT_FALSE(expander.has_pending());
+}
+
+TEST_F(ExpanderGpioHALTest, FailedBatchFlushIsRetried)
+{
+    expander.begin_batch();
+    ASSERT_EQ(ESP_OK, expander.set_level(GPIO_NUM_4, false));
+    bus.fail_writes = true;
+    EXPECT_EQ(ESP_ERR_TIMEOUT, expander.end_batch());
+    EXPECT_TRUE(expander.has_pending());
+
+    bus.fail_writes = false;
+    ASSERT_EQ(ESP_OK, expander.flush());
+    EXPECT_EQ(0xFFFF & ~(1u << 4), bus.reg16(TCA_OUTPUT));
+}
+
+TEST_F(ExpanderGpioHALTest, PinsOutsideExpanderAreRejected)
+{
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, expander.set_level(GPIO_NUM_16, true));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, expander.set_levels_mask(1ULL << 20, 0));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, expander.set_levels_mask(1, 1));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, expander.reset_pin(GPIO_NUM_NC));
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, expander.set_drive_capability(GPIO_NUM_0, GPIO_DRIVE_CAP_3));
+    EXPECT_TRUE(bus.writes.empty());
+}
+
+TEST_F(ExpanderGpioHALTest, GetLevelReadsInputPortOrPendingLevel)
+{
+    bus.regs[TCA_INPUT] = 0x20;
+    bool level = false;
+    ASSERT_EQ(ESP_OK, expander.get_level(GPIO_NUM_5, level));
+    EXPECT_TRUE(level);
+    EXPECT_EQ(1, bus.reads);
+
+    // Output with a level pending in a batch: report the pending level
+    gpio_config_t io_conf = {};
+    io_conf.mode = GPIO_MODE_OUTPUT;
+    io_conf.pin_bit_mask = 1ULL << GPIO_NUM_5;
+    ASSERT_EQ(ESP_OK, expander.config(io_conf));
+    expander.begin_batch();
+    ASSERT_EQ(ESP_OK, expander.set_level(GPIO_NUM_5, false));
+    ASSERT_EQ(ESP_OK, expander.get_level(GPIO_NUM_5, level));
+    EXPECT_FALSE(level);
+    EXPECT_EQ(1, bus.reads);
+}
+
+TEST(ExpanderGpioHALChipTest, Mcp23017RegisterMap)
+{
+    FakeRegisterBus bus;
+    bus.regs[0x00] = bus.regs[0x01] = 0xFF; // IODIR: all inputs
+    ExpanderGpioHAL expander(bus, ExpanderChip::MCP23017);
+    ASSERT_EQ(ESP_OK, expander.init());
+
+    PowerControl rail(expander, GPIO_NUM_9, true, false);
+    ASSERT_EQ(ESP_OK, rail.init());
+    EXPECT_EQ(1u << 9, bus.reg16(0x14));             // OLAT: GPB1 HIGH (OFF, active LOW)
+    EXPECT_EQ(0xFFFF & ~(1u << 9), bus.reg16(0x00)); // IODIR: GPB1 output
+}
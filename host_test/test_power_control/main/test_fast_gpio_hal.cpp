@@ -0,0 +1,31 @@
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "fast_gpio_hal.hpp"
+
+using namespace power_control;
+
+// Only the fast-path guards are exercised here: configured pins reach the
+// GPIO driver mock, which has no expectations set up in these tests.
+
+TEST(FastGpioHALTest, SetLevel_RejectsUnconfiguredPin)
+{
+    FastGpioHAL hal;
+
+    EXPECT_EQ(0u, hal.get_output_mask());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, hal.set_level(GPIO_NUM_4, true));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, hal.set_level(GPIO_NUM_NC, true));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, hal.set_level(GPIO_NUM_MAX, false));
+}
+
+TEST(FastGpioHALTest, SetLevelsMask_RejectsUnconfiguredPins)
+{
+    FastGpioHAL hal;
+
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, hal.set_levels_mask(1ULL << GPIO_NUM_4, 0));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, hal.set_levels_mask(0, 1ULL << GPIO_NUM_5));
+
+    // Empty masks are a valid no-op
+    EXPECT_EQ(ESP_OK, hal.set_levels_mask(0, 0));
+}
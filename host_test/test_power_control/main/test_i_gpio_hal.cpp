@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "recording_gpio_hal.hpp"
+
+using Op = RecordingGpioHAL::Op;
+
+// IGpioHAL batched defaults, exercised through a HAL that only implements the per-pin calls
+
+TEST(IGpioHALTest, SetLevelsMask_DefaultWritesEachPin)
+{
+    RecordingGpioHAL hal(false);
+
+    EXPECT_EQ(ESP_OK, hal.set_levels_mask((1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_6), 1ULL << GPIO_NUM_5));
+
+    ASSERT_EQ(3u, hal.events.size());
+    EXPECT_EQ(3u, hal.count(Op::SET_LEVEL));
+    EXPECT_EQ(1ULL << GPIO_NUM_4, hal.events[0].mask);
+    EXPECT_EQ(1, hal.events[0].value);
+    EXPECT_EQ(1ULL << GPIO_NUM_5, hal.events[1].mask);
+    EXPECT_EQ(0, hal.events[1].value);
+    EXPECT_EQ((1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_6), hal.levels);
+}
+
+TEST(IGpioHALTest, SetLevelsMask_DefaultRejectsOverlappingMasks)
+{
+    RecordingGpioHAL hal(false);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, hal.set_levels_mask(1ULL << GPIO_NUM_4, 1ULL << GPIO_NUM_4));
+    EXPECT_TRUE(hal.events.empty());
+}
+
+TEST(IGpioHALTest, ResetPinsMask_DefaultResetsEveryPinAndReturnsFirstError)
+{
+    RecordingGpioHAL hal(false);
+    hal.fail_mask = 1ULL << GPIO_NUM_5;
+
+    EXPECT_EQ(
+        ESP_FAIL,
+        hal.reset_pins_mask((1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_5) | (1ULL << GPIO_NUM_6)));
+
+    EXPECT_EQ(3u, hal.count(Op::RESET_PIN)); // GPIO6 still reset
+}
+
+TEST(IGpioHALTest, SetDriveCapabilityMask_DefaultSetsEachPin)
+{
+    RecordingGpioHAL hal(false);
+
+    EXPECT_EQ(ESP_OK, hal.set_drive_capability_mask((1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_7), GPIO_DRIVE_CAP_3));
+
+    ASSERT_EQ(2u, hal.count(Op::SET_DRIVE_CAPABILITY));
+    EXPECT_EQ(GPIO_DRIVE_CAP_3, hal.events[1].value);
+    EXPECT_EQ(1ULL << GPIO_NUM_7, hal.events[1].mask);
+}
+
+TEST(IGpioHALTest, BatchedCallsAreRecordedAsOneEvent)
+{
+    RecordingGpioHAL hal;
+    const uint64_t pins = (1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_5);
+
+    EXPECT_EQ(ESP_OK, hal.reset_pins_mask(pins));
+    EXPECT_EQ(ESP_OK, hal.set_drive_capability_mask(pins, GPIO_DRIVE_CAP_0));
+    EXPECT_EQ(ESP_OK, hal.set_levels_mask(pins, 0));
+
+    ASSERT_EQ(3u, hal.events.size());
+    EXPECT_EQ(Op::RESET_PINS_MASK, hal.events[0].op);
+    EXPECT_EQ(Op::SET_DRIVE_CAPABILITY_MASK, hal.events[1].op);
+    EXPECT_EQ(Op::SET_LEVELS_MASK, hal.events[2].op);
+    EXPECT_EQ(pins, hal.levels);
+}
@@ -0,0 +1,193 @@
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "fake_timer_hal.hpp"
+#include "mock_power_control.hpp"
+#include "power_budget.hpp"
+
+using ::testing::InSequence;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace power_control;
+
+class PowerBudgetTest : public ::testing::Test
+{
+protected:
+    FakeTimerHAL fake_timer;
+    NiceMock<MockPowerControl> modem;
+    NiceMock<MockPowerControl> heater;
+    NiceMock<MockPowerControl> camera;
+
+    void SetUp() override
+    {
+        for (MockPowerControl *rail : {&modem, &heater, &camera}) {
+            ON_CALL(*rail, is_initialized()).WillByDefault(Return(true));
+            ON_CALL(*rail, turn_on()).WillByDefault(Return(ESP_OK));
+            ON_CALL(*rail, turn_off()).WillByDefault(Return(ESP_OK));
+        }
+    }
+};
+
+TEST_F(PowerBudgetTest, OverBudgetTurnOnIsQueuedAndAdmittedInOrder)
+{
+    PowerBudget budget(fake_timer, 500);
+    BudgetedRail modem_rail(budget, modem, 300, 300);
+    BudgetedRail heater_rail(budget, heater, 250, 250);
+    BudgetedRail camera_rail(budget, camera, 150, 150);
+
+    EXPECT_CALL(modem, turn_on()).Times(1);
+    EXPECT_EQ(ESP_OK, modem_rail.turn_on());
+    EXPECT_EQ(300u, budget.get_used_ma());
+
+    // Heater does not fit; camera would, but must not overtake the heater
+    EXPECT_CALL(heater, turn_on()).Times(0);
+    EXPECT_CALL(camera, turn_on()).Times(0);
+    EXPECT_EQ(ESP_OK, heater_rail.turn_on());
+    EXPECT_EQ(ESP_OK, camera_rail.turn_on());
+    EXPECT_TRUE(heater_rail.is_pending());
+    EXPECT_TRUE(camera_rail.is_pending());
+    EXPECT_EQ(2u, budget.get_waiting_count());
+    ::testing::Mock::VerifyAndClearExpectations(&heater);
+    ::testing::Mock::VerifyAndClearExpectations(&camera);
+
+    // Modem off: both waiting rails fit (250 + 150) and are admitted from this call
+    EXPECT_CALL(heater, turn_on()).Times(1);
+    EXPECT_CALL(camera, turn_on()).Times(1);
+    EXPECT_EQ(ESP_OK, modem_rail.turn_off());
+    EXPECT_FALSE(heater_rail.is_pending());
+    EXPECT_EQ(400u, budget.get_used_ma());
+    EXPECT_EQ(0u, budget.get_waiting_count());
+}
+
+TEST_F(PowerBudgetTest, InrushIsReservedOnlyForItsDuration)
+{
+    PowerBudget budget(fake_timer, 500);
+    BudgetedRail modem_rail(budget, modem, 400, 120, 2000);
+    BudgetedRail heater_rail(budget, heater, 300, 300);
+
+    EXPECT_EQ(ESP_OK, modem_rail.turn_on());
+    EXPECT_EQ(400u, modem_rail.get_reserved_ma());
+
+    EXPECT_CALL(heater, turn_on()).Times(0);
+    EXPECT_EQ(ESP_OK, heater_rail.turn_on());
+    fake_timer.advance(1999);
+    ::testing::Mock::VerifyAndClearExpectations(&heater);
+
+    EXPECT_CALL(heater, turn_on()).Times(1);
+    fake_timer.advance(1);
+    EXPECT_EQ(120u, modem_rail.get_reserved_ma());
+    EXPECT_EQ(420u, budget.get_used_ma());
+}
+
+TEST_F(PowerBudgetTest, TurnOffWhilePendingDropsRequest)
+{
+    PowerBudget budget(fake_timer, 100);
+    BudgetedRail modem_rail(budget, modem, 100, 100);
+    BudgetedRail heater_rail(budget, heater, 100, 100);
+
+    ASSERT_EQ(ESP_OK, modem_rail.turn_on());
+    ASSERT_EQ(ESP_OK, heater_rail.turn_on());
+
+    EXPECT_CALL(heater, turn_on()).Times(0);
+    EXPECT_CALL(heater, turn_off()).Times(0);
+    EXPECT_EQ(ESP_OK, heater_rail.turn_off());
+    EXPECT_FALSE(heater_rail.is_pending());
+    EXPECT_EQ(ESP_OK, modem_rail.turn_off());
+    EXPECT_EQ(0u, budget.get_used_ma());
+}
+
+TEST_F(PowerBudgetTest, TurnOffDuringAdmissionHandsTheRailBack)
+{
+    PowerBudget budget(fake_timer, 100);
+    BudgetedRail modem_rail(budget, modem, 100, 100);
+    BudgetedRail heater_rail(budget, heater, 100, 100);
+
+    ASSERT_EQ(ESP_OK, modem_rail.turn_on());
+    ASSERT_EQ(ESP_OK, heater_rail.turn_on());
+    ASSERT_TRUE(heater_rail.is_pending());
+
+    // Another task turns the heater OFF while the modem release is switching it ON
+    {
+        InSequence s;
+        EXPECT_CALL(heater, turn_on()).WillOnce(Invoke([&] {
+            EXPECT_EQ(ESP_OK, heater_rail.turn_off());
+            return ESP_OK;
+        }));
+        EXPECT_CALL(heater, turn_off()).WillOnce(Return(ESP_OK));
+    }
+    EXPECT_EQ(ESP_OK, modem_rail.turn_off());
+    EXPECT_FALSE(heater_rail.is_pending());
+    EXPECT_EQ(0u, heater_rail.get_reserved_ma());
+    EXPECT_EQ(0u, budget.get_used_ma()); // No reservation left behind
+
+    // The rail can be requested again
+    EXPECT_CALL(heater, turn_on()).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, heater_rail.turn_on());
+    EXPECT_EQ(100u, budget.get_used_ma());
+}
+
+TEST_F(PowerBudgetTest, Failures)
+{
+    PowerBudget budget(fake_timer, 200);
+    BudgetedRail too_big(budget, modem, 300, 100);
+    BudgetedRail heater_rail(budget, heater, 100, 100);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, too_big.turn_on());
+
+    // Failed switch gives the reservation back
+    EXPECT_CALL(heater, turn_on()).WillOnce(Return(ESP_FAIL)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_FAIL, heater_rail.turn_on());
+    EXPECT_EQ(0u, budget.get_used_ma());
+
+    // Failed turn-off keeps it
+    ASSERT_EQ(ESP_OK, heater_rail.turn_on());
+    EXPECT_CALL(heater, turn_off()).WillOnce(Return(ESP_FAIL));
+    EXPECT_EQ(ESP_FAIL, heater_rail.turn_off());
+    EXPECT_EQ(100u, budget.get_used_ma());
+
+    ON_CALL(camera, is_initialized()).WillByDefault(Return(false));
+    BudgetedRail uninit(budget, camera, 10, 10);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, uninit.turn_on());
+}
+
+TEST_F(PowerBudgetTest, ConcurrentAdmissionNeverExceedsBudget)
+{
+    constexpr int THREADS = 4;
+    constexpr int ITERATIONS = 2000;
+    PowerBudget budget(fake_timer, 250);
+    std::vector<NiceMock<MockPowerControl>> rails(THREADS);
+    std::vector<BudgetedRail *> budgeted;
+    for (auto &rail : rails) {
+        ON_CALL(rail, is_initialized()).WillByDefault(Return(true));
+        ON_CALL(rail, turn_on()).WillByDefault([&budget]() {
+            EXPECT_LE(budget.get_used_ma(), 250u);
+            return ESP_OK;
+        });
+        ON_CALL(rail, turn_off()).WillByDefault(Return(ESP_OK));
+        budgeted.push_back(new BudgetedRail(budget, rail, 100, 100));
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < ITERATIONS; i++) {
+                budgeted[t]->turn_on();
+                budgeted[t]->turn_off();
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+
+    EXPECT_EQ(0u, budget.get_used_ma());
+    EXPECT_EQ(0u, budget.get_waiting_count());
+    for (BudgetedRail *rail : budgeted) {
+        delete rail;
+    }
+}
@@ -0,0 +1,192 @@
+#include <atomic>
+
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "power_command_queue.hpp"
+#include "power_control.hpp"
+#include "power_profile.hpp"
+#include "profile_rails_fixture.hpp"
+#include "recording_gpio_hal.hpp"
+
+using namespace power_control;
+
+using Op = RecordingGpioHAL::Op;
+
+class PowerCommandQueueTest : public ProfileRailsTest
+{
+protected:
+    PowerProfileGroup group{rails};
+
+    /// Completion callback storing the result in an std::atomic<esp_err_t>
+    static void store_result(esp_err_t result, void *arg)
+    {
+        static_cast<std::atomic<esp_err_t> *>(arg)->store(result);
+    }
+};
+
+TEST_F(PowerCommandQueueTest, DrainAppliesTheBatchInOneWrite)
+{
+    PowerCommandQueue queue(group);
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_4, PowerAction::ON));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_5, PowerAction::ON));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_6, PowerAction::OFF)); // Already OFF
+    EXPECT_EQ(3u, queue.get_pending());
+    EXPECT_TRUE(hal.events.empty()); // Nothing written by post()
+
+    EXPECT_EQ(3u, queue.drain());
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(Op::SET_LEVELS_MASK, hal.events[0].op);
+    EXPECT_EQ(PIN_4, hal.events[0].mask);
+    EXPECT_EQ(PIN_5, hal.events[0].clear_mask); // Active LOW ON
+    EXPECT_TRUE(sensor.is_on());
+    EXPECT_TRUE(modem.is_on());
+    EXPECT_FALSE(heater.is_on());
+    EXPECT_EQ(0u, queue.get_pending());
+    EXPECT_EQ(0u, queue.drain());
+}
+
+TEST_F(PowerCommandQueueTest, CommandsAreAppliedInOrder)
+{
+    PowerCommandQueue queue(group);
+    ASSERT_EQ(ESP_OK, sensor.turn_on());
+    hal.events.clear();
+
+    // Switched back and forth within one batch: the rails end where they started
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_6, PowerAction::ON));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_6, PowerAction::OFF));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_4, PowerAction::TOGGLE));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_4, PowerAction::TOGGLE));
+    EXPECT_EQ(4u, queue.drain());
+    EXPECT_TRUE(hal.events.empty());
+    EXPECT_TRUE(sensor.is_on());
+    EXPECT_FALSE(heater.is_on());
+
+    // Last command for a rail wins
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_4, PowerAction::OFF));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_6, PowerAction::TOGGLE));
+    EXPECT_EQ(2u, queue.drain());
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(PIN_6, hal.events[0].mask);
+    EXPECT_EQ(PIN_4, hal.events[0].clear_mask);
+}
+
+TEST_F(PowerCommandQueueTest, PostRejectsForeignRailsAndActions)
+{
+    PowerCommandQueue queue(group);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, queue.post(GPIO_NUM_7, PowerAction::ON));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, queue.post(GPIO_NUM_NC, PowerAction::ON));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, queue.post(GPIO_NUM_4, static_cast<PowerAction>(7)));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, queue.post_from_isr(GPIO_NUM_7, PowerAction::ON, nullptr));
+    EXPECT_EQ(0u, queue.get_pending());
+}
+
+TEST_F(PowerCommandQueueTest, FullQueueDropsTheCommand)
+{
+    PowerCommandQueue queue(group);
+    for (size_t i = 0; i < PowerCommandQueue::DEPTH; i++) {
+        ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_4, PowerAction::ON));
+    }
+    EXPECT_EQ(ESP_ERR_NO_MEM, queue.post(GPIO_NUM_4, PowerAction::OFF));
+    EXPECT_EQ(PowerCommandQueue::DEPTH, queue.get_pending());
+
+    EXPECT_EQ(PowerCommandQueue::DEPTH, queue.drain());
+    EXPECT_TRUE(sensor.is_on());
+
+    // Slots are reused after the drain
+    for (size_t round = 0; round < 3; round++) {
+        for (size_t i = 0; i < PowerCommandQueue::DEPTH; i++) {
+            ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_5, PowerAction::TOGGLE));
+        }
+        EXPECT_EQ(PowerCommandQueue::DEPTH, queue.drain());
+    }
+    EXPECT_FALSE(modem.is_on()); // Even number of toggles
+}
+
+TEST_F(PowerCommandQueueTest, CallbacksReceiveTheBatchResult)
+{
+    PowerCommandQueue queue(group);
+    std::atomic<esp_err_t> first{ESP_FAIL};
+    std::atomic<esp_err_t> second{ESP_FAIL};
+
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_4, PowerAction::ON, store_result, &first));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_6, PowerAction::ON, store_result, &second));
+    EXPECT_EQ(2u, queue.drain());
+    EXPECT_EQ(ESP_OK, first.load());
+    EXPECT_EQ(ESP_OK, second.load());
+
+    // A failed write fails every command of the batch and leaves the rails unchanged
+    hal.fail_mask = PIN_5;
+    hal.fail_error = ESP_ERR_TIMEOUT;
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_4, PowerAction::OFF, store_result, &first));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_5, PowerAction::ON, store_result, &second));
+    EXPECT_EQ(2u, queue.drain());
+    EXPECT_EQ(ESP_ERR_TIMEOUT, first.load());
+    EXPECT_EQ(ESP_ERR_TIMEOUT, second.load());
+    EXPECT_TRUE(sensor.is_on());
+    EXPECT_FALSE(modem.is_on());
+}
+
+TEST_F(PowerCommandQueueTest, UnswitchableRailOnlyFailsItsOwnCommand)
+{
+    PowerCommandQueue queue(group);
+    std::atomic<esp_err_t> first{ESP_FAIL};
+    std::atomic<esp_err_t> rejected{ESP_OK};
+    std::atomic<esp_err_t> last{ESP_FAIL};
+
+    // A rail of the group that cannot be switched does not block the others...
+    ASSERT_EQ(ESP_OK, modem.deinit());
+    hal.events.clear();
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_4, PowerAction::ON, store_result, &first));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_5, PowerAction::TOGGLE, store_result, &rejected));
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_6, PowerAction::ON, store_result, &last));
+    EXPECT_EQ(3u, queue.drain());
+
+    // ...and only its own command fails, before the write
+    EXPECT_EQ(ESP_OK, first.load());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, rejected.load());
+    EXPECT_EQ(ESP_OK, last.load());
+    EXPECT_TRUE(sensor.is_on());
+    EXPECT_FALSE(modem.is_on());
+    EXPECT_TRUE(heater.is_on());
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(PIN_4 | PIN_6, hal.events[0].mask | hal.events[0].clear_mask);
+}
+
+TEST_F(PowerCommandQueueTest, IsrPostWithoutPowerTask)
+{
+    PowerCommandQueue queue(group);
+    BaseType_t woken = pdFALSE;
+
+    ASSERT_EQ(ESP_OK, queue.post_from_isr(GPIO_NUM_6, PowerAction::ON, &woken));
+    EXPECT_EQ(pdFALSE, woken); // No task to wake
+    EXPECT_EQ(1u, queue.get_pending());
+    EXPECT_EQ(1u, queue.drain());
+    EXPECT_TRUE(heater.is_on());
+}
+
+TEST_F(PowerCommandQueueTest, PowerTaskAppliesPostedCommands)
+{
+    PowerCommandQueue queue(group);
+    ASSERT_EQ(ESP_OK, queue.start(5));
+    EXPECT_TRUE(queue.is_running());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, queue.start(5));
+
+    // Completion by task notification
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_4, PowerAction::ON, xTaskGetCurrentTaskHandle()));
+    uint32_t result = ESP_FAIL;
+    ASSERT_EQ(pdTRUE, xTaskNotifyWait(0, UINT32_MAX, &result, portMAX_DELAY));
+    EXPECT_EQ(static_cast<uint32_t>(ESP_OK), result);
+
+    // Commands still queued when stop() is called are applied before the task exits
+    ASSERT_EQ(ESP_OK, queue.post(GPIO_NUM_6, PowerAction::ON));
+    EXPECT_EQ(ESP_OK, queue.stop());
+    EXPECT_FALSE(queue.is_running());
+    EXPECT_EQ(0u, queue.get_pending());
+    EXPECT_TRUE(sensor.is_on());
+    EXPECT_TRUE(heater.is_on());
+    EXPECT_EQ(ESP_OK, queue.stop());
+}
@@ -1,10 +1,18 @@
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 #include "driver/gpio.h"
 
+#include "fake_timer_hal.hpp"
 #include "i_gpio_hal.hpp"
+#include "mock_gpio_hal.hpp"
+#include "mock_power_control.hpp"
 #include "power_control.hpp"
+#include "power_profile.hpp"
+#include "recording_gpio_hal.hpp"
+#include "sim_gpio_hal.hpp"
 
 using ::testing::_;
 using ::testing::Field;
@@ -12,15 +20,6 @@ using ::testing::Return;
 
 using namespace power_control;
 
-class MockGpioHAL : public IGpioHAL
-{
-public:
-    MOCK_METHOD(esp_err_t, reset_pin, (gpio_num_t pin), (override));
-    MOCK_METHOD(esp_err_t, config, (const gpio_config_t &config), (override));
-    MOCK_METHOD(esp_err_t, set_level, (gpio_num_t pin, bool level), (override));
-    MOCK_METHOD(esp_err_t, set_drive_capability, (gpio_num_t gpio_num, gpio_drive_cap_t strength), (override));
-};
-
 // Fixture para reutilizar setup
 class PowerControlTest : public ::testing::Test
 {
@@ -534,4 +533,1268 @@ TEST_F(PowerControlTest, HeapAllocation_NoMemoryLeaks)
     delete pc2;
 
     // Run: valgrind --leak-check=full ./build/test_power_control.elf
-}
\ No newline at end of file
+}
+//==============================================================================
+//  ISR-safe API
+//==============================================================================
+#if CONFIG_POWER_CONTROL_ISR_API
+TEST_F(PowerControlTest, FromIsr_SwitchesAndUpdatesState)
+{
+    PowerControl pc(mock_gpio, TEST_PIN, true, false); // inverted
+
+    EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK)); // init OFF
+    EXPECT_EQ(ESP_OK, pc.init());
+
+    // ON from ISR: inverted, physical LOW
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on_from_isr());
+    EXPECT_TRUE(pc.is_on());
+
+    // OFF from ISR: inverted, physical HIGH
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_off_from_isr());
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(PowerControlTest, FromIsr_FailsWhenNotInitialized)
+{
+    PowerControl pc(mock_gpio, TEST_PIN, false, false);
+
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on_from_isr());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_off_from_isr());
+    EXPECT_FALSE(pc.is_on());
+}
+#endif
+
+//==============================================================================
+//  Settle time and asynchronous readiness
+//==============================================================================
+class PowerControlSettleTest : public PowerControlTest
+{
+protected:
+    FakeTimerHAL fake_timer;
+
+    static void on_ready(PowerControl &rail, void *ctx)
+    {
+        EXPECT_TRUE(rail.is_ready());
+        (*static_cast<int *>(ctx))++;
+    }
+
+    void init_rail(PowerControl &pc)
+    {
+        EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+        ASSERT_EQ(ESP_OK, pc.init());
+    }
+};
+
+TEST_F(PowerControlSettleTest, IsReady_TracksSettleTime)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN, false, false, 10000);
+    init_rail(pc);
+    EXPECT_FALSE(pc.is_ready());
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(pc.is_on());
+    EXPECT_FALSE(pc.is_ready());
+
+    fake_timer.advance(9999);
+    EXPECT_FALSE(pc.is_ready());
+    fake_timer.advance(1);
+    EXPECT_TRUE(pc.is_ready());
+
+    // Turning on again does not restart the settle time
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(pc.is_ready());
+}
+
+TEST_F(PowerControlSettleTest, TurnOnAsync_FiresCallbackAfterSettleTime)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN, false, false, 500);
+    init_rail(pc);
+    int ready_count = 0;
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on_async(on_ready, &ready_count));
+    EXPECT_EQ(0, ready_count);
+
+    fake_timer.advance(499);
+    EXPECT_EQ(0, ready_count);
+    fake_timer.advance(1);
+    EXPECT_EQ(1, ready_count);
+
+    // Already settled: callback fires immediately
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on_async(on_ready, &ready_count));
+    EXPECT_EQ(2, ready_count);
+}
+
+TEST_F(PowerControlSettleTest, TurnOnAsync_WaitsOnlyRemainingTime)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN, false, false, 1000);
+    init_rail(pc);
+    int ready_count = 0;
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).Times(2).WillRepeatedly(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    fake_timer.advance(700);
+
+    EXPECT_EQ(ESP_OK, pc.turn_on_async(on_ready, &ready_count));
+    fake_timer.advance(299);
+    EXPECT_EQ(0, ready_count);
+    fake_timer.advance(1);
+    EXPECT_EQ(1, ready_count);
+}
+
+TEST_F(PowerControlSettleTest, TurnOff_CancelsPendingCallback)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN, false, false, 1000);
+    init_rail(pc);
+    int ready_count = 0;
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on_async(on_ready, &ready_count));
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+
+    fake_timer.advance(5000);
+    EXPECT_EQ(0, ready_count);
+    EXPECT_FALSE(pc.is_ready());
+}
+
+TEST_F(PowerControlSettleTest, ZeroSettleTime_ReadyImmediately)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+    int ready_count = 0;
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on_async(on_ready, &ready_count));
+    EXPECT_EQ(1, ready_count);
+    EXPECT_EQ(0, fake_timer.starts);
+}
+
+TEST_F(PowerControlSettleTest, TurnOnAsync_FailsWhenNotInitialized)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN, false, false, 1000);
+    int ready_count = 0;
+
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on_async(on_ready, &ready_count));
+    EXPECT_EQ(0, ready_count);
+}
+
+TEST_F(PowerControlSettleTest, Init_FailsWhenTimerCreationFails)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN, false, false, 1000);
+    fake_timer.fail_create = true;
+
+    EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_ERR_NO_MEM, pc.init());
+    EXPECT_FALSE(pc.is_initialized());
+}
+
+TEST_F(PowerControlTest, SettleTime_RequiresTimerHal)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, pc.set_settle_time_us(1000));
+    EXPECT_EQ(ESP_OK, pc.set_settle_time_us(0));
+    EXPECT_EQ(0u, pc.get_settle_time_us());
+}
+
+//==============================================================================
+//  Idempotent writes, refresh and read-back verification
+//==============================================================================
+
+using ::testing::DoAll;
+using ::testing::SetArgReferee;
+
+class PowerControlWriteModeTest : public PowerControlTest
+{
+protected:
+    void init_rail(PowerControl &pc, bool initial_level)
+    {
+        EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, set_level(TEST_PIN, initial_level)).WillOnce(Return(ESP_OK));
+        ASSERT_EQ(ESP_OK, pc.init());
+    }
+};
+
+TEST_F(PowerControlWriteModeTest, Idempotent_SkipsRedundantWrites)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+    pc.set_idempotent(true);
+    EXPECT_TRUE(pc.is_idempotent());
+
+    // init() writes the initial state even though the cached state already matches
+    init_rail(pc, false);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, _)).Times(0);
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(pc.is_on());
+}
+
+TEST_F(PowerControlWriteModeTest, Default_AlwaysWrites)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+    EXPECT_FALSE(pc.is_idempotent());
+    EXPECT_FALSE(pc.is_readback_verify());
+    init_rail(pc, false);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).Times(2).WillRepeatedly(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, get_level(_, _)).Times(0);
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+}
+
+TEST_F(PowerControlWriteModeTest, Refresh_ForcesWriteInIdempotentMode)
+{
+    PowerControl pc(mock_gpio, TEST_PIN, true, true); // Active LOW, initially ON
+    pc.set_idempotent(true);
+    init_rail(pc, false);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.refresh());
+    EXPECT_TRUE(pc.is_on());
+}
+
+TEST_F(PowerControlWriteModeTest, Refresh_FailsWhenNotInitialized)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.refresh());
+}
+
+TEST_F(PowerControlWriteModeTest, ReadbackVerify_PassesWhenPinMatches)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+    init_rail(pc, false);
+    pc.set_readback_verify(true);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, get_level(TEST_PIN, _)).WillOnce(DoAll(SetArgReferee<1>(true), Return(ESP_OK)));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(pc.is_on());
+}
+
+TEST_F(PowerControlWriteModeTest, ReadbackVerify_RepairsDrift)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+    init_rail(pc, false);
+    pc.set_readback_verify(true);
+
+    // First read-back shows the old level, the rewrite fixes it
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).Times(2).WillRepeatedly(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, get_level(TEST_PIN, _))
+        .WillOnce(DoAll(SetArgReferee<1>(false), Return(ESP_OK)))
+        .WillOnce(DoAll(SetArgReferee<1>(true), Return(ESP_OK)));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(pc.is_on());
+}
+
+TEST_F(PowerControlWriteModeTest, ReadbackVerify_StuckPinFails)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+    init_rail(pc, false);
+    pc.set_readback_verify(true);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).Times(2).WillRepeatedly(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, get_level(TEST_PIN, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgReferee<1>(false), Return(ESP_OK)));
+    EXPECT_EQ(ESP_FAIL, pc.turn_on());
+    EXPECT_FALSE(pc.is_on()); // State unchanged
+}
+
+TEST_F(PowerControlWriteModeTest, IdempotentWithReadback_DetectsDriftWithoutWriting)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+    pc.set_idempotent(true);
+    pc.set_readback_verify(true);
+    EXPECT_CALL(mock_gpio, get_level(TEST_PIN, _)).WillOnce(DoAll(SetArgReferee<1>(false), Return(ESP_OK)));
+    init_rail(pc, false);
+
+    // Pin still correct: read only, no write
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+    EXPECT_CALL(mock_gpio, get_level(TEST_PIN, _)).WillOnce(DoAll(SetArgReferee<1>(false), Return(ESP_OK)));
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+    ::testing::Mock::VerifyAndClearExpectations(&mock_gpio);
+
+    // Pin was pulled high externally: repaired by the redundant call
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, get_level(TEST_PIN, _))
+        .WillOnce(DoAll(SetArgReferee<1>(true), Return(ESP_OK)))
+        .WillOnce(DoAll(SetArgReferee<1>(false), Return(ESP_OK)));
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+}
+
+TEST_F(PowerControlWriteModeTest, ReadbackVerify_UnsupportedHal)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+    init_rail(pc, false);
+    pc.set_readback_verify(true);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, get_level(TEST_PIN, _)).WillOnce(Return(ESP_ERR_NOT_SUPPORTED));
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, pc.turn_on());
+    EXPECT_FALSE(pc.is_on());
+}
+
+//==============================================================================
+//  Statistics
+//==============================================================================
+
+#if CONFIG_POWER_CONTROL_STATS
+class PowerControlStatsTest : public PowerControlSettleTest
+{
+};
+
+TEST_F(PowerControlStatsTest, TracksOnTimeTransitionsAndLongestPeriod)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, _)).WillRepeatedly(Return(ESP_OK));
+
+    fake_timer.advance(1000);
+    pc.turn_on();
+    fake_timer.advance(300);
+    pc.turn_off();
+    fake_timer.advance(5000); // OFF time is not counted
+    pc.turn_on();
+    fake_timer.advance(700);
+    pc.turn_off();
+
+    PowerControl::Stats stats = pc.get_stats();
+    EXPECT_EQ(1000u, stats.on_time_us);
+    EXPECT_EQ(700u, stats.longest_on_us);
+    EXPECT_EQ(2u, stats.on_count);
+    EXPECT_EQ(2u, stats.off_count);
+    EXPECT_FLOAT_EQ(0.0f, stats.charge_mah); // No load current configured
+}
+
+TEST_F(PowerControlStatsTest, IncludesCurrentPeriodAndIgnoresRedundantCalls)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, _)).WillRepeatedly(Return(ESP_OK));
+
+    pc.turn_on();
+    fake_timer.advance(400);
+    pc.turn_on(); // Same state: not a transition
+    fake_timer.advance(600);
+
+    PowerControl::Stats stats = pc.get_stats();
+    EXPECT_EQ(1000u, stats.on_time_us);
+    EXPECT_EQ(1000u, stats.longest_on_us);
+    EXPECT_EQ(1u, stats.on_count);
+    EXPECT_EQ(0u, stats.off_count);
+}
+
+TEST_F(PowerControlStatsTest, EstimatesChargeFromLoadCurrent)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    pc.set_load_current_ua(20000); // 20 mA
+    EXPECT_EQ(20000u, pc.get_load_current_ua());
+    init_rail(pc);
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, _)).WillRepeatedly(Return(ESP_OK));
+
+    pc.turn_on();
+    fake_timer.advance(180000000LL); // 3 minutes = 1/20 h
+    pc.turn_off();
+
+    EXPECT_FLOAT_EQ(1.0f, pc.get_stats().charge_mah);
+}
+
+TEST_F(PowerControlStatsTest, ResetStats_RestartsCurrentPeriod)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, _)).WillRepeatedly(Return(ESP_OK));
+
+    pc.turn_on();
+    fake_timer.advance(500);
+    pc.reset_stats();
+    fake_timer.advance(200);
+
+    PowerControl::Stats stats = pc.get_stats();
+    EXPECT_EQ(200u, stats.on_time_us);
+    EXPECT_EQ(0u, stats.on_count);
+}
+
+#if CONFIG_POWER_CONTROL_ISR_API
+TEST_F(PowerControlStatsTest, IsrTransitionsAreCountedButNotTimed)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, _)).WillRepeatedly(Return(ESP_OK));
+
+    pc.turn_on();
+    fake_timer.advance(300);
+    ASSERT_EQ(ESP_OK, pc.turn_off_from_isr());
+    ASSERT_EQ(ESP_OK, pc.turn_on_from_isr());
+    ASSERT_EQ(ESP_OK, pc.turn_on_from_isr()); // Same state: not a transition
+    fake_timer.advance(500);
+    EXPECT_EQ(0u, pc.get_stats().on_time_us); // The task-timed period was ended by the ISR
+
+    pc.turn_off();
+    pc.turn_on();
+    fake_timer.advance(200);
+    pc.turn_off();
+
+    PowerControl::Stats stats = pc.get_stats();
+    EXPECT_EQ(200u, stats.on_time_us);
+    EXPECT_EQ(3u, stats.on_count);
+    EXPECT_EQ(3u, stats.off_count);
+
+    pc.reset_stats();
+    EXPECT_EQ(0u, pc.get_stats().on_count);
+    EXPECT_EQ(0u, pc.get_stats().off_count);
+}
+#endif
+
+TEST_F(PowerControlStatsTest, Deinit_ClosesOnPeriod)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, _)).WillRepeatedly(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+
+    pc.turn_on();
+    fake_timer.advance(250);
+    pc.deinit();
+    fake_timer.advance(1000);
+
+    PowerControl::Stats stats = pc.get_stats();
+    EXPECT_EQ(250u, stats.on_time_us);
+    EXPECT_EQ(1u, stats.off_count);
+}
+
+TEST_F(PowerControlTest, Stats_WithoutTimerCountsTransitionsOnly)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+    EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, _)).WillRepeatedly(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, pc.init());
+
+    pc.turn_on();
+    pc.turn_off();
+    pc.turn_on();
+
+    PowerControl::Stats stats = pc.get_stats();
+    EXPECT_EQ(2u, stats.on_count);
+    EXPECT_EQ(1u, stats.off_count);
+    EXPECT_EQ(0u, stats.on_time_us);
+}
+#endif
+
+//==============================================================================
+//  Timed pulse / auto-off
+//==============================================================================
+
+TEST_F(PowerControlSettleTest, TurnOnFor_SwitchesOffAfterDuration)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on_for(5000));
+    EXPECT_TRUE(pc.is_on());
+    EXPECT_TRUE(pc.is_auto_off_pending());
+
+    fake_timer.advance(4999);
+    EXPECT_TRUE(pc.is_on());
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1);
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_FALSE(pc.is_auto_off_pending());
+}
+
+TEST_F(PowerControlSettleTest, TurnOnFor_RestartsCountdownWhenOn)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).Times(2).WillRepeatedly(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on_for(1000));
+    fake_timer.advance(800);
+    EXPECT_EQ(ESP_OK, pc.turn_on_for(1000));
+    fake_timer.advance(800);
+    EXPECT_TRUE(pc.is_on());
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    fake_timer.advance(200);
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(PowerControlSettleTest, TurnOnFor_RestartBeatsAnExpiryBeingDispatched)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).Times(2).WillRepeatedly(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on_for(1000));
+    const FakeTimerHAL::Timer expired = fake_timer.timers.back();
+
+    // The countdown expires, but its callback runs only after the restart
+    fake_timer.now_us = 1000;
+    EXPECT_EQ(ESP_OK, pc.turn_on_for(1000));
+    expired.callback(expired.arg);
+    EXPECT_TRUE(pc.is_on());
+    EXPECT_TRUE(pc.is_auto_off_pending());
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1000);
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(PowerControlSettleTest, Pulse_RequiresRailOff)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.pulse(100));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.pulse(100));
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    fake_timer.advance(100);
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(PowerControlSettleTest, AutoOff_CancelledByTurnOffAndCancel)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).Times(2).WillRepeatedly(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+
+    EXPECT_EQ(ESP_OK, pc.turn_on_for(1000));
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+    EXPECT_FALSE(pc.is_auto_off_pending());
+
+    // Cancelled auto-off leaves the rail ON
+    EXPECT_EQ(ESP_OK, pc.turn_on_for(1000));
+    pc.cancel_auto_off();
+    fake_timer.advance(5000);
+    EXPECT_TRUE(pc.is_on());
+}
+
+TEST_F(PowerControlSettleTest, TurnOnFor_Failures)
+{
+    PowerControl no_timer(mock_gpio, TEST_PIN);
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on_for(1000));
+
+    EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, no_timer.init());
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, no_timer.turn_on_for(1000));
+
+    init_rail(pc);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.turn_on_for(0));
+
+    fake_timer.fail_create = true;
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_NO_MEM, pc.turn_on_for(1000));
+    EXPECT_FALSE(pc.is_on());
+}
+
+//==============================================================================
+//  Sleep retention and warm init
+//==============================================================================
+
+class PowerControlSleepTest : public PowerControlSettleTest
+{
+};
+
+TEST_F(PowerControlSleepTest, HoldForSleep_LatchesPinAndBlocksSwitching)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_deep_sleep_hold(true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.hold_for_sleep());
+    EXPECT_TRUE(pc.is_held());
+
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on());
+
+    // Light-sleep wake: release the hold and keep going
+    EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.release_hold());
+    EXPECT_FALSE(pc.is_held());
+    EXPECT_EQ(ESP_OK, pc.release_hold()); // No-op when not held
+}
+
+TEST_F(PowerControlSleepTest, HoldForLightSleep_SkipsDeepSleepHold)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_deep_sleep_hold(_)).Times(0);
+    EXPECT_EQ(ESP_OK, pc.hold_for_sleep(false));
+}
+
+TEST_F(PowerControlSleepTest, HoldForSleep_Failures)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.hold_for_sleep());
+
+    init_rail(pc);
+    EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, true)).WillOnce(Return(ESP_ERR_NOT_SUPPORTED));
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, pc.hold_for_sleep());
+    EXPECT_FALSE(pc.is_held());
+
+    // Deep-sleep hold refused: the pad hold is released again
+    {
+        ::testing::InSequence s;
+        EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, set_deep_sleep_hold(true)).WillOnce(Return(ESP_FAIL));
+        EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    }
+    EXPECT_EQ(ESP_FAIL, pc.hold_for_sleep());
+    EXPECT_FALSE(pc.is_held());
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+}
+
+TEST_F(PowerControlSleepTest, WarmInit_AdoptsPadLevelWithoutReset)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN, true, false, 20000); // Active LOW, 20 ms warm-up
+    fake_timer.now_us = 100000;
+
+    {
+        ::testing::InSequence s;
+        // Input enabled before the read: the pad may not feed GPIO_IN right after a wake
+        EXPECT_CALL(mock_gpio, config(Field(&gpio_config_t::mode, GPIO_MODE_INPUT_OUTPUT))).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, get_level(TEST_PIN, _)).WillOnce(DoAll(SetArgReferee<1>(false), Return(ESP_OK)));
+        EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK)); // Before the hold is released
+        EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    }
+    EXPECT_CALL(mock_gpio, reset_pin(_)).Times(0);
+
+    EXPECT_EQ(ESP_OK, pc.warm_init());
+    EXPECT_TRUE(pc.is_initialized());
+    EXPECT_TRUE(pc.is_on());
+    EXPECT_TRUE(pc.is_ready()); // Stayed powered: no new warm-up
+    EXPECT_EQ(ESP_OK, pc.warm_init()); // Idempotent
+}
+
+TEST_F(PowerControlSleepTest, WarmInit_RetainedStateWhenReadbackUnsupported)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, get_level(TEST_PIN, _)).WillOnce(Return(ESP_ERR_NOT_SUPPORTED));
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, pc.warm_init());
+    EXPECT_FALSE(pc.is_initialized());
+    ::testing::Mock::VerifyAndClearExpectations(&mock_gpio);
+
+    // HAL without hold support: nothing to release
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, false)).WillOnce(Return(ESP_ERR_NOT_SUPPORTED));
+    EXPECT_EQ(ESP_OK, pc.warm_init(true));
+    EXPECT_TRUE(pc.is_on());
+}
+
+TEST_F(PowerControlSleepTest, WarmInit_FailsWhenConfigFails)
+{
+    PowerControl pc(mock_gpio, TEST_PIN);
+
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_CALL(mock_gpio, set_hold(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.warm_init(false));
+    EXPECT_FALSE(pc.is_initialized());
+}
+
+TEST_F(PowerControlSleepTest, Refresh_RejectedWhileHeld)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+    pc.set_readback_verify(true);
+    EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, pc.hold_for_sleep(false));
+
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+    EXPECT_CALL(mock_gpio, get_level(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.refresh());
+    EXPECT_TRUE(pc.is_held());
+}
+
+TEST_F(PowerControlSleepTest, Deinit_ReleasesHold)
+{
+    PowerControl pc(mock_gpio, fake_timer, TEST_PIN);
+    init_rail(pc);
+    EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, pc.hold_for_sleep(false));
+
+    {
+        ::testing::InSequence s;
+        EXPECT_CALL(mock_gpio, set_hold(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+    }
+    EXPECT_EQ(ESP_OK, pc.deinit());
+    EXPECT_FALSE(pc.is_held());
+}
+
+//==============================================================================
+//  Batched boot initialization
+//==============================================================================
+
+class PowerControlInitAllTest : public PowerControlSettleTest
+{
+};
+
+TEST_F(PowerControlInitAllTest, ConfiguresAllPinsAndLevelsInOneCall)
+{
+    PowerControl sensor(mock_gpio, fake_timer, GPIO_NUM_4, false, true, 1000); // ON, 1 ms settle
+    PowerControl radio(mock_gpio, GPIO_NUM_5, true, false);                    // Active LOW, OFF
+    PowerControl led(mock_gpio, GPIO_NUM_6, false, false);
+    PowerControl *const rails[] = {&sensor, &radio, &led};
+    const uint64_t pins = (1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_5) | (1ULL << GPIO_NUM_6);
+
+    EXPECT_CALL(mock_gpio, reset_pin(_)).Times(0);
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+    EXPECT_CALL(mock_gpio, config(Field(&gpio_config_t::pin_bit_mask, pins))).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_levels_mask((1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_5), 1ULL << GPIO_NUM_6))
+        .WillOnce(Return(ESP_OK));
+
+    EXPECT_EQ(ESP_OK, PowerControl::init_all(rails));
+    EXPECT_TRUE(sensor.is_initialized());
+    EXPECT_TRUE(radio.is_initialized());
+    EXPECT_TRUE(led.is_initialized());
+    EXPECT_TRUE(sensor.is_on());
+    EXPECT_FALSE(radio.is_on());
+
+    // Settle time starts with the batched write
+    EXPECT_FALSE(sensor.is_ready());
+    fake_timer.advance(1000);
+    EXPECT_TRUE(sensor.is_ready());
+}
+
+TEST_F(PowerControlInitAllTest, SkipsInitializedRailsAndFallsBackForOtherHal)
+{
+    MockGpioHAL other_gpio;
+    PowerControl done(mock_gpio, fake_timer, GPIO_NUM_4);
+    PowerControl batched(mock_gpio, GPIO_NUM_5);
+    PowerControl other(other_gpio, GPIO_NUM_6);
+    init_rail(done);
+    PowerControl *const rails[] = {&done, nullptr, &batched, &other};
+
+    EXPECT_CALL(mock_gpio, config(Field(&gpio_config_t::pin_bit_mask, 1ULL << GPIO_NUM_5))).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, 1ULL << GPIO_NUM_5)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(other_gpio, reset_pin(GPIO_NUM_6)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(other_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(other_gpio, set_level(GPIO_NUM_6, false)).WillOnce(Return(ESP_OK));
+
+    EXPECT_EQ(ESP_OK, PowerControl::init_all(rails));
+    EXPECT_TRUE(batched.is_initialized());
+    EXPECT_TRUE(other.is_initialized());
+}
+
+TEST_F(PowerControlInitAllTest, RejectsInvalidOrDuplicatePins)
+{
+    PowerControl a(mock_gpio, GPIO_NUM_4);
+    PowerControl b(mock_gpio, GPIO_NUM_4);
+    PowerControl bad(mock_gpio, GPIO_NUM_NC);
+    PowerControl *const duplicate[] = {&a, &b};
+    PowerControl *const invalid[] = {&a, &bad};
+
+    EXPECT_CALL(mock_gpio, config(_)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, PowerControl::init_all(duplicate));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, PowerControl::init_all(invalid));
+    EXPECT_FALSE(a.is_initialized());
+
+    // Duplicates are also caught among the rails initialized one by one
+    MockGpioHAL other_gpio;
+    PowerControl c(other_gpio, GPIO_NUM_6);
+    PowerControl d(other_gpio, GPIO_NUM_6);
+    PowerControl *const other_duplicate[] = {&a, &c, &d};
+    EXPECT_CALL(other_gpio, reset_pin(_)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, PowerControl::init_all(other_duplicate));
+    EXPECT_FALSE(c.is_initialized());
+}
+
+TEST_F(PowerControlInitAllTest, SamePinNumberOnAnotherHalIsAccepted)
+{
+    RecordingGpioHAL expander;
+    PowerControl gpio4(mock_gpio, GPIO_NUM_4);
+    PowerControl expander4(expander, GPIO_NUM_4);
+    PowerControl *const rails[] = {&gpio4, &expander4};
+
+    EXPECT_CALL(mock_gpio, config(Field(&gpio_config_t::pin_bit_mask, 1ULL << GPIO_NUM_4))).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, 1ULL << GPIO_NUM_4)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, PowerControl::init_all(rails));
+    EXPECT_TRUE(gpio4.is_initialized());
+    EXPECT_TRUE(expander4.is_initialized());
+}
+
+TEST_F(PowerControlInitAllTest, NoRailInitializedOnHalFailure)
+{
+    PowerControl a(mock_gpio, GPIO_NUM_4);
+    PowerControl b(mock_gpio, GPIO_NUM_5);
+    PowerControl *const rails[] = {&a, &b};
+
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_ERR_INVALID_ARG)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, PowerControl::init_all(rails));
+    EXPECT_FALSE(a.is_initialized());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(_, _)).WillOnce(Return(ESP_FAIL));
+    EXPECT_EQ(ESP_FAIL, PowerControl::init_all(rails));
+    EXPECT_FALSE(a.is_initialized());
+    EXPECT_FALSE(b.is_initialized());
+}
+
+//==============================================================================
+//  Drive strength from the load profile
+//==============================================================================
+
+using Op = RecordingGpioHAL::Op;
+
+TEST(PowerLoadTest, SelectsTheWeakestAdequateDrive)
+{
+    gpio_drive_cap_t drive = GPIO_DRIVE_CAP_3;
+    EXPECT_TRUE(PowerLoad::drive_for(0, drive));
+    EXPECT_EQ(GPIO_DRIVE_CAP_0, drive);
+    EXPECT_TRUE(PowerLoad::drive_for(5, drive));
+    EXPECT_EQ(GPIO_DRIVE_CAP_0, drive);
+    EXPECT_TRUE(PowerLoad::drive_for(6, drive));
+    EXPECT_EQ(GPIO_DRIVE_CAP_1, drive);
+    EXPECT_TRUE(PowerLoad::drive_for(40, drive));
+    EXPECT_EQ(GPIO_DRIVE_CAP_3, drive);
+    EXPECT_FALSE(PowerLoad::drive_for(41, drive));
+
+    // I = Qg / t, rounded up
+    constexpr PowerLoad gate = PowerLoad::gate(12, 5);
+    static_assert(gate.steady_ma == 0 && gate.edge_ma == 3 && gate.edge_us == 5, "Gate load");
+    EXPECT_TRUE(gate.needs_edge_boost());
+    EXPECT_EQ(1, PowerLoad::gate(8, 0).edge_us);
+    EXPECT_FALSE(PowerLoad::direct(8).needs_edge_boost());
+}
+
+class PowerControlLoadTest : public ::testing::Test
+{
+protected:
+    RecordingGpioHAL hal;
+    FakeTimerHAL fake_timer;
+    PowerControl pc{hal, fake_timer, GPIO_NUM_4};
+
+    /// Drive capabilities written, in order
+    std::vector<int> drives() const
+    {
+        std::vector<int> values;
+        for (const RecordingGpioHAL::Event &e : hal.events) {
+            if (e.op == Op::SET_DRIVE_CAPABILITY) {
+                values.push_back(e.value);
+            }
+        }
+        return values;
+    }
+};
+
+TEST_F(PowerControlLoadTest, InitAppliesTheSteadyDrive)
+{
+    ASSERT_EQ(ESP_OK, pc.set_load(PowerLoad::direct(3)));
+    EXPECT_TRUE(hal.events.empty()); // Applied by init()
+    ASSERT_EQ(ESP_OK, pc.init());
+    EXPECT_EQ(std::vector<int>{GPIO_DRIVE_CAP_0}, drives());
+    EXPECT_EQ(GPIO_DRIVE_CAP_0, pc.get_drive_capability());
+    EXPECT_FALSE(pc.is_edge_boost());
+
+    // No boost: switching writes no drive
+    hal.events.clear();
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(drives().empty());
+
+    // Changed on an initialized rail: applied at once
+    ASSERT_EQ(ESP_OK, pc.set_load(PowerLoad::direct(15)));
+    EXPECT_EQ(std::vector<int>{GPIO_DRIVE_CAP_2}, drives());
+}
+
+TEST_F(PowerControlLoadTest, EdgesAreBoostedOnlyWhileSwitching)
+{
+    ASSERT_EQ(ESP_OK, pc.set_load(PowerLoad::gate(12, 2))); // 6 mA for 2 us
+    ASSERT_EQ(ESP_OK, pc.init());
+    EXPECT_TRUE(pc.is_edge_boost());
+    hal.events.clear();
+
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+    ASSERT_EQ(3u, hal.events.size());
+    EXPECT_EQ(Op::SET_DRIVE_CAPABILITY, hal.events[0].op);
+    EXPECT_EQ(GPIO_DRIVE_CAP_1, hal.events[0].value);
+    EXPECT_EQ(Op::SET_LEVEL, hal.events[1].op);
+    EXPECT_EQ(Op::SET_DRIVE_CAPABILITY, hal.events[2].op);
+    EXPECT_EQ(GPIO_DRIVE_CAP_0, hal.events[2].value);
+    EXPECT_EQ(2, fake_timer.delayed_us); // Held for the edge
+
+    // Same state: no edge, no boost
+    hal.events.clear();
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(drives().empty());
+
+    // Turn-off edge too
+    ASSERT_EQ(ESP_OK, pc.turn_off());
+    EXPECT_EQ((std::vector<int>{GPIO_DRIVE_CAP_1, GPIO_DRIVE_CAP_0}), drives());
+    EXPECT_EQ(4, fake_timer.delayed_us);
+
+    // A failed boost aborts the switch without waiting
+    hal.events.clear();
+    hal.fail_mask = 1ULL << GPIO_NUM_4;
+    EXPECT_EQ(ESP_FAIL, pc.turn_on());
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_EQ(4, fake_timer.delayed_us);
+}
+
+TEST_F(PowerControlLoadTest, ManualDriveOverridesTheLoad)
+{
+    ASSERT_EQ(ESP_OK, pc.set_load(PowerLoad::direct(8, 30, 50)));
+    ASSERT_EQ(ESP_OK, pc.init());
+    EXPECT_EQ(GPIO_DRIVE_CAP_1, pc.get_drive_capability());
+    ASSERT_EQ(ESP_OK, pc.set_drive_capability(GPIO_DRIVE_CAP_3));
+    EXPECT_EQ(GPIO_DRIVE_CAP_3, pc.get_drive_capability());
+    EXPECT_FALSE(pc.is_edge_boost());
+
+    hal.events.clear();
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(drives().empty());
+}
+
+TEST_F(PowerControlLoadTest, Failures)
+{
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.set_load(PowerLoad::direct(50)));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.set_load(PowerLoad::gate(100, 1)));
+    EXPECT_FALSE(pc.is_edge_boost());
+
+    ASSERT_EQ(ESP_OK, pc.set_load(PowerLoad::direct(3)));
+    hal.fail_mask = 1ULL << GPIO_NUM_4;
+    EXPECT_EQ(ESP_FAIL, pc.init());
+    EXPECT_FALSE(pc.is_initialized());
+}
+
+TEST_F(PowerControlLoadTest, BatchedAndWarmInitApplyTheDrive)
+{
+    SimGpioHAL sim(fake_timer);
+    PowerControl a(sim, fake_timer, GPIO_NUM_4);
+    PowerControl b(sim, fake_timer, GPIO_NUM_5);
+    PowerControl *const rails[] = {&a, &b};
+    ASSERT_EQ(ESP_OK, a.set_load(PowerLoad::direct(4)));
+    ASSERT_EQ(ESP_OK, PowerControl::init_all(rails));
+    EXPECT_EQ(GPIO_DRIVE_CAP_0, sim.pins[GPIO_NUM_4].drive);
+    EXPECT_EQ(GPIO_DRIVE_CAP_2, sim.pins[GPIO_NUM_5].drive); // No load declared: reset default
+
+    PowerControl warm(sim, fake_timer, GPIO_NUM_6);
+    ASSERT_EQ(ESP_OK, warm.set_load(PowerLoad::direct(18)));
+    ASSERT_EQ(ESP_OK, sim.set_drive_capability(GPIO_NUM_6, GPIO_DRIVE_CAP_3));
+    ASSERT_EQ(ESP_OK, warm.warm_init(false));
+    EXPECT_EQ(GPIO_DRIVE_CAP_2, sim.pins[GPIO_NUM_6].drive);
+}
+
+//==============================================================================
+//  Fault protection
+//==============================================================================
+
+TEST(PowerFaultInterfaceTest, RailsWithoutProtectionReportNoFault)
+{
+    MockPowerControl rail;
+    const IPowerControl &rail_if = rail;
+    EXPECT_EQ(PowerFault::NONE, rail_if.get_fault());
+}
+
+#if CONFIG_POWER_CONTROL_PROTECTION
+/// Fault source driven by the test: trigger() plays the interrupt
+class FakeFaultSense : public IFaultSenseHAL
+{
+public:
+    esp_err_t start(fault_isr_t isr, void *isr_arg) override
+    {
+        if (fail_start) {
+            return ESP_FAIL;
+        }
+        handler = isr;
+        arg = isr_arg;
+        return ESP_OK;
+    }
+
+    esp_err_t stop() override
+    {
+        handler = nullptr;
+        return ESP_OK;
+    }
+
+    bool is_fault_active() override { return active; }
+
+    PowerFault get_kind() const override { return PowerFault::OVERCURRENT; }
+
+    /// Assert the fault and call the handler, as the sense interrupt would
+    void trigger()
+    {
+        active = true;
+        if (handler != nullptr) {
+            handler(arg);
+        }
+    }
+
+    fault_isr_t handler = nullptr;
+    void *arg = nullptr;
+    bool active = false;
+    bool fail_start = false;
+};
+
+/// RecordingGpioHAL whose next set_level() is preceded by the fault interrupt, as if it fired on the other core
+class TripOnWriteGpioHAL : public RecordingGpioHAL
+{
+public:
+    esp_err_t set_level(gpio_num_t pin, bool level) override
+    {
+        FakeFaultSense *sense = trip;
+        trip = nullptr;
+        if (sense != nullptr) {
+            sense->trigger();
+        }
+        return RecordingGpioHAL::set_level(pin, level);
+    }
+
+    FakeFaultSense *trip = nullptr;
+};
+
+class PowerControlFaultTest : public ::testing::Test
+{
+protected:
+    RecordingGpioHAL hal;
+    FakeTimerHAL fake_timer;
+    FakeFaultSense sense;
+    PowerControl pc{hal, fake_timer, GPIO_NUM_4};
+
+    const uint64_t PIN_4 = 1ULL << GPIO_NUM_4;
+
+    void SetUp() override { ASSERT_EQ(ESP_OK, pc.init()); }
+};
+
+TEST_F(PowerControlFaultTest, FaultCutsAndLatchesTheRail)
+{
+    ASSERT_EQ(ESP_OK, pc.set_fault_protection(sense));
+    ASSERT_EQ(ESP_OK, pc.turn_on_for(100000));
+    EXPECT_EQ(PowerFault::NONE, pc.get_fault());
+
+    sense.trigger();
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_EQ(0u, hal.levels & PIN_4);
+    EXPECT_EQ(PowerFault::OVERCURRENT, pc.get_fault());
+    EXPECT_EQ(1u, pc.get_fault_count());
+    EXPECT_FALSE(pc.is_auto_off_pending());
+    EXPECT_FALSE(pc.is_fault_retry_pending());
+
+    // Repeated reports of the same fault cut only once
+    sense.trigger();
+    EXPECT_EQ(1u, pc.get_fault_count());
+
+    // Latched: no way back ON until cleared
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.toggle());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on_from_isr());
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+    EXPECT_FALSE(pc.is_on());
+
+    // Cleared only once the source no longer reports it
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.clear_fault());
+    sense.active = false;
+    ASSERT_EQ(ESP_OK, pc.clear_fault());
+    EXPECT_EQ(PowerFault::NONE, pc.get_fault());
+    EXPECT_FALSE(pc.is_on()); // Stays OFF
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_EQ(ESP_OK, pc.clear_fault()); // Nothing latched
+}
+
+TEST_F(PowerControlFaultTest, FaultOnOffRailIsIgnored)
+{
+    ASSERT_EQ(ESP_OK, pc.set_fault_protection(sense));
+    sense.trigger();
+    EXPECT_EQ(PowerFault::NONE, pc.get_fault());
+    EXPECT_EQ(0u, pc.get_fault_count());
+}
+
+TEST_F(PowerControlFaultTest, RetriesWithExponentialBackoff)
+{
+    ASSERT_EQ(ESP_OK, pc.set_fault_protection(sense, 1000, 3));
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+
+    // Retry 1 after 1 ms: fault still present, next in 2 ms
+    sense.trigger();
+    EXPECT_TRUE(pc.is_fault_retry_pending());
+    fake_timer.advance(999);
+    EXPECT_FALSE(pc.is_on());
+    fake_timer.advance(1);
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_TRUE(pc.is_fault_retry_pending());
+
+    // Retry 2 after 2 ms more: fault gone, rail back ON
+    sense.active = false;
+    fake_timer.advance(1999);
+    EXPECT_FALSE(pc.is_on());
+    fake_timer.advance(1);
+    EXPECT_TRUE(pc.is_on());
+    EXPECT_EQ(PowerFault::NONE, pc.get_fault());
+    EXPECT_FALSE(pc.is_fault_retry_pending());
+
+    // Trips again before it has been up for those 2 ms: the attempts keep counting, retry 3 after 4 ms
+    fake_timer.advance(1999);
+    sense.trigger();
+    EXPECT_EQ(2u, pc.get_fault_count());
+    sense.active = false;
+    fake_timer.advance(3999);
+    EXPECT_FALSE(pc.is_on());
+    fake_timer.advance(1);
+    EXPECT_TRUE(pc.is_on());
+
+    // Up for 4 ms without a trip: the attempt count is reset, the backoff starts over at 1 ms
+    fake_timer.advance(4000);
+    sense.trigger();
+    EXPECT_EQ(3u, pc.get_fault_count());
+    EXPECT_TRUE(pc.is_fault_retry_pending());
+    fake_timer.advance(1000 + 2000 + 4000); // Retries 1 to 3, fault still present
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_FALSE(pc.is_fault_retry_pending());
+    fake_timer.advance(100000);
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_EQ(PowerFault::OVERCURRENT, pc.get_fault());
+}
+
+TEST_F(PowerControlFaultTest, FaultWhileSwitchingOnIsCut)
+{
+    TripOnWriteGpioHAL trip_hal;
+    PowerControl rail(trip_hal, fake_timer, GPIO_NUM_5);
+    ASSERT_EQ(ESP_OK, rail.init());
+    ASSERT_EQ(ESP_OK, rail.set_fault_protection(sense));
+    ASSERT_FALSE(rail.is_on());
+
+    // The fault edge arrives during the OFF -> ON write, before the state is committed
+    trip_hal.trip = &sense;
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, rail.turn_on());
+    EXPECT_FALSE(rail.is_on());
+    EXPECT_EQ(0u, trip_hal.levels & (1ULL << GPIO_NUM_5));
+    EXPECT_EQ(PowerFault::OVERCURRENT, rail.get_fault());
+    EXPECT_EQ(1u, rail.get_fault_count());
+}
+
+TEST_F(PowerControlFaultTest, FaultActiveAfterSwitchOnIsLatched)
+{
+    ASSERT_EQ(ESP_OK, pc.set_fault_protection(sense));
+
+    // Fault present without an edge reaching the handler
+    sense.active = true;
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on());
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_EQ(0u, hal.levels & PIN_4);
+    EXPECT_EQ(PowerFault::OVERCURRENT, pc.get_fault());
+    EXPECT_EQ(1u, pc.get_fault_count());
+}
+
+TEST_F(PowerControlFaultTest, TurnOffCancelsTheRetry)
+{
+    ASSERT_EQ(ESP_OK, pc.set_fault_protection(sense, 1000, 1));
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+    sense.trigger();
+    sense.active = false;
+    ASSERT_EQ(ESP_OK, pc.turn_off());
+    EXPECT_FALSE(pc.is_fault_retry_pending());
+    fake_timer.advance(10000);
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_EQ(PowerFault::OVERCURRENT, pc.get_fault());
+}
+
+TEST_F(PowerControlFaultTest, FaultPresentWhenEnabledCutsAtOnce)
+{
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+    sense.active = true;
+    ASSERT_EQ(ESP_OK, pc.set_fault_protection(sense));
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_EQ(PowerFault::OVERCURRENT, pc.get_fault());
+
+    // The latch survives disabling the protection
+    pc.disable_fault_protection();
+    EXPECT_EQ(nullptr, sense.handler);
+    EXPECT_EQ(PowerFault::OVERCURRENT, pc.get_fault());
+    EXPECT_EQ(ESP_OK, pc.clear_fault());
+}
+
+TEST_F(PowerControlFaultTest, GroupRefusesLatchedRails)
+{
+    PowerControl other(hal, fake_timer, GPIO_NUM_5);
+    ASSERT_EQ(ESP_OK, other.init());
+    PowerControl *const rails[] = {&pc, &other};
+    PowerProfileGroup group(rails);
+
+    ASSERT_EQ(ESP_OK, pc.set_fault_protection(sense));
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+    sense.trigger();
+
+    const uint64_t both = PIN_4 | (1ULL << GPIO_NUM_5);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, group.apply_profile(PowerProfile(both)));
+    EXPECT_FALSE(other.is_on());
+    EXPECT_EQ(ESP_OK, group.apply_profile(PowerProfile(1ULL << GPIO_NUM_5)));
+    EXPECT_TRUE(other.is_on());
+}
+
+TEST_F(PowerControlFaultTest, SetFaultProtection_Failures)
+{
+    PowerControl no_timer(hal, GPIO_NUM_5);
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, no_timer.set_fault_protection(sense, 1000, 3));
+    EXPECT_EQ(ESP_OK, no_timer.set_fault_protection(sense)); // Latch only
+    no_timer.disable_fault_protection();
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.set_fault_protection(sense, 0, 3));
+    sense.fail_start = true;
+    EXPECT_EQ(ESP_FAIL, pc.set_fault_protection(sense));
+    sense.fail_start = false;
+    ASSERT_EQ(ESP_OK, pc.set_fault_protection(sense));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.set_fault_protection(sense));
+}
+
+#if CONFIG_POWER_CONTROL_TELEMETRY
+TEST_F(PowerControlFaultTest, TelemetryReportsTheLatchedFault)
+{
+    PowerTelemetrySnapshot snap;
+    ASSERT_EQ(ESP_OK, pc.set_fault_protection(sense, 1000, 1));
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+
+    sense.trigger();
+    ASSERT_EQ(1u, PowerTelemetry::snapshot(snap));
+    EXPECT_EQ(GPIO_NUM_4, snap.rails[0].gpio);
+    EXPECT_EQ(0, snap.rails[0].on);
+    EXPECT_EQ(PowerFault::OVERCURRENT, snap.rails[0].fault);
+
+    // Released by the retry
+    sense.active = false;
+    fake_timer.advance(1000);
+    ASSERT_EQ(1u, PowerTelemetry::snapshot(snap));
+    EXPECT_EQ(1, snap.rails[0].on);
+    EXPECT_EQ(2u, snap.rails[0].on_count);
+    EXPECT_EQ(PowerFault::NONE, snap.rails[0].fault);
+}
+#endif
+
+#endif
@@ -0,0 +1,244 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "mock_gpio_hal.hpp"
+#include "power_group.hpp"
+#include "recording_gpio_hal.hpp"
+
+using ::testing::_;
+using ::testing::Field;
+using ::testing::Return;
+
+using namespace power_control;
+
+class PowerGroupTest : public ::testing::Test
+{
+protected:
+    MockGpioHAL mock_gpio;
+
+    // GPIO4 and GPIO6 active HIGH, GPIO5 active LOW
+    const PowerGroup::Rail rails[3] = {
+        {GPIO_NUM_4, false},
+        {GPIO_NUM_5, true},
+        {GPIO_NUM_6, false},
+    };
+    const uint64_t PIN_4 = 1ULL << GPIO_NUM_4;
+    const uint64_t PIN_5 = 1ULL << GPIO_NUM_5;
+    const uint64_t PIN_6 = 1ULL << GPIO_NUM_6;
+    const uint64_t ALL_PINS = PIN_4 | PIN_5 | PIN_6;
+
+    void expect_init(bool initial_on)
+    {
+        EXPECT_CALL(mock_gpio, reset_pin(GPIO_NUM_4)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, reset_pin(GPIO_NUM_5)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, reset_pin(GPIO_NUM_6)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, config(Field(&gpio_config_t::pin_bit_mask, ALL_PINS))).WillOnce(Return(ESP_OK));
+        if (initial_on) {
+            EXPECT_CALL(mock_gpio, set_levels_mask(PIN_4 | PIN_6, PIN_5)).WillOnce(Return(ESP_OK));
+        }
+        else {
+            EXPECT_CALL(mock_gpio, set_levels_mask(PIN_5, PIN_4 | PIN_6)).WillOnce(Return(ESP_OK));
+        }
+    }
+};
+
+TEST_F(PowerGroupTest, Init_ConfiguresAllPinsWithOneConfig)
+{
+    PowerGroup group(mock_gpio, rails, 3, false);
+
+    expect_init(false);
+    EXPECT_CALL(mock_gpio, set_level(_, _)).Times(0);
+
+    EXPECT_EQ(ESP_OK, group.init());
+    EXPECT_TRUE(group.is_initialized());
+    EXPECT_EQ(ALL_PINS, group.get_pin_mask());
+    EXPECT_EQ(0u, group.get_state_mask());
+
+    // Second init is a no-op
+    EXPECT_EQ(ESP_OK, group.init());
+}
+
+TEST_F(PowerGroupTest, Init_WithInitialOnTrue)
+{
+    PowerGroup group(mock_gpio, rails, 3, true);
+
+    expect_init(true);
+
+    EXPECT_EQ(ESP_OK, group.init());
+    EXPECT_EQ(ALL_PINS, group.get_state_mask());
+}
+
+TEST_F(PowerGroupTest, TurnOnAll_TurnOffAll_SingleWrite)
+{
+    PowerGroup group(mock_gpio, rails, 3, false);
+    expect_init(false);
+    ASSERT_EQ(ESP_OK, group.init());
+
+    // ON: active HIGH pins set, active LOW pin cleared, in one call
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_4 | PIN_6, PIN_5)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, group.turn_on_all());
+    EXPECT_EQ(ALL_PINS, group.get_state_mask());
+    EXPECT_TRUE(group.is_on(GPIO_NUM_5));
+
+    // OFF: the opposite levels, in one call
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_5, PIN_4 | PIN_6)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, group.turn_off_all());
+    EXPECT_EQ(0u, group.get_state_mask());
+    EXPECT_FALSE(group.is_on(GPIO_NUM_5));
+}
+
+TEST_F(PowerGroupTest, ApplyMask_MixedState)
+{
+    PowerGroup group(mock_gpio, rails, 3, false);
+    expect_init(false);
+    ASSERT_EQ(ESP_OK, group.init());
+
+    // GPIO4 ON (HIGH), GPIO5 ON (LOW), GPIO6 OFF (LOW)
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_4, PIN_5 | PIN_6)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, group.apply_mask(PIN_4 | PIN_5));
+    EXPECT_EQ(PIN_4 | PIN_5, group.get_state_mask());
+    EXPECT_TRUE(group.is_on(GPIO_NUM_4));
+    EXPECT_FALSE(group.is_on(GPIO_NUM_6));
+}
+
+TEST_F(PowerGroupTest, ApplyMask_RejectsPinsOutsideGroup)
+{
+    PowerGroup group(mock_gpio, rails, 3, false);
+    expect_init(false);
+    ASSERT_EQ(ESP_OK, group.init());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, group.apply_mask(PIN_4 | (1ULL << GPIO_NUM_7)));
+    EXPECT_EQ(0u, group.get_state_mask());
+}
+
+TEST_F(PowerGroupTest, ApplyMask_FailsWhenHalFails)
+{
+    PowerGroup group(mock_gpio, rails, 3, false);
+    expect_init(false);
+    ASSERT_EQ(ESP_OK, group.init());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(_, _)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, group.turn_on_all());
+    EXPECT_EQ(0u, group.get_state_mask()); // State unchanged
+}
+
+TEST_F(PowerGroupTest, Operations_FailWhenNotInitialized)
+{
+    PowerGroup group(mock_gpio, rails, 3, false);
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(_, _)).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, group.turn_on_all());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, group.turn_off_all());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, group.apply_mask(PIN_4));
+}
+
+TEST_F(PowerGroupTest, Init_RejectsInvalidRailLists)
+{
+    const PowerGroup::Rail duplicated[] = {{GPIO_NUM_4, false}, {GPIO_NUM_4, true}};
+    const PowerGroup::Rail invalid[] = {{GPIO_NUM_NC, false}};
+
+    EXPECT_CALL(mock_gpio, reset_pin(_)).Times(0);
+    EXPECT_CALL(mock_gpio, config(_)).Times(0);
+
+    PowerGroup group_dup(mock_gpio, duplicated, 2);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, group_dup.init());
+
+    PowerGroup group_invalid(mock_gpio, invalid, 1);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, group_invalid.init());
+
+    PowerGroup group_empty(mock_gpio, rails, 0);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, group_empty.init());
+    EXPECT_FALSE(group_empty.is_initialized());
+}
+
+TEST_F(PowerGroupTest, Init_FailsWhenConfigFails)
+{
+    PowerGroup group(mock_gpio, rails, 3, false);
+
+    EXPECT_CALL(mock_gpio, reset_pin(_)).Times(3).WillRepeatedly(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_CALL(mock_gpio, set_levels_mask(_, _)).Times(0);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, group.init());
+    EXPECT_FALSE(group.is_initialized());
+}
+
+TEST_F(PowerGroupTest, Deinit_ForcesLowAndResetsPins)
+{
+    PowerGroup group(mock_gpio, rails, 3, true);
+    expect_init(true);
+    ASSERT_EQ(ESP_OK, group.init());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, ALL_PINS)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, reset_pin(_)).Times(3).WillRepeatedly(Return(ESP_OK));
+
+    EXPECT_EQ(ESP_OK, group.deinit());
+    EXPECT_FALSE(group.is_initialized());
+    EXPECT_EQ(0u, group.get_state_mask());
+
+    // Second deinit is a no-op
+    EXPECT_EQ(ESP_OK, group.deinit());
+}
+
+TEST_F(PowerGroupTest, Deinit_PartialFailure)
+{
+    PowerGroup group(mock_gpio, rails, 3, false);
+    expect_init(false);
+    ASSERT_EQ(ESP_OK, group.init());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, ALL_PINS)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_CALL(mock_gpio, reset_pin(_)).Times(3).WillRepeatedly(Return(ESP_ERR_INVALID_STATE));
+
+    // deinit should return the first error
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, group.deinit());
+    EXPECT_FALSE(group.is_initialized());
+}
+
+TEST_F(PowerGroupTest, SetDriveCapability_AppliesToAllPins)
+{
+    PowerGroup group(mock_gpio, rails, 3, false);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, group.set_drive_capability(GPIO_DRIVE_CAP_3));
+
+    expect_init(false);
+    ASSERT_EQ(ESP_OK, group.init());
+
+    EXPECT_CALL(mock_gpio, set_drive_capability(_, GPIO_DRIVE_CAP_3)).Times(3).WillRepeatedly(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, group.set_drive_capability(GPIO_DRIVE_CAP_3));
+}
+
+TEST(PowerGroupBatchTest, EveryOperationIsOneHalEvent)
+{
+    using Op = RecordingGpioHAL::Op;
+    RecordingGpioHAL hal;
+    const PowerGroup::Rail rails[] = {
+        {GPIO_NUM_4, false},
+        {GPIO_NUM_5, true},
+        {GPIO_NUM_6, false},
+    };
+    const uint64_t all_pins = (1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_5) | (1ULL << GPIO_NUM_6);
+    PowerGroup group(hal, rails, 3, false);
+
+    ASSERT_EQ(ESP_OK, group.init());
+    ASSERT_EQ(3u, hal.events.size()); // Reset, config and initial state
+    EXPECT_EQ(Op::RESET_PINS_MASK, hal.events[0].op);
+    EXPECT_EQ(all_pins, hal.events[0].mask);
+    EXPECT_EQ(Op::CONFIG, hal.events[1].op);
+    EXPECT_EQ(Op::SET_LEVELS_MASK, hal.events[2].op);
+    EXPECT_EQ(1ULL << GPIO_NUM_5, hal.levels); // Active-LOW rail held HIGH while OFF
+
+    hal.events.clear();
+    ASSERT_EQ(ESP_OK, group.turn_on_all());
+    ASSERT_EQ(ESP_OK, group.set_drive_capability(GPIO_DRIVE_CAP_0));
+    ASSERT_EQ(ESP_OK, group.deinit());
+
+    ASSERT_EQ(4u, hal.events.size());
+    EXPECT_EQ(Op::SET_LEVELS_MASK, hal.events[0].op);
+    EXPECT_EQ(Op::SET_DRIVE_CAPABILITY_MASK, hal.events[1].op);
+    EXPECT_EQ(Op::SET_LEVELS_MASK, hal.events[2].op);
+    EXPECT_EQ(Op::RESET_PINS_MASK, hal.events[3].op);
+    EXPECT_EQ(0u, hal.count(Op::SET_LEVEL));
+    EXPECT_EQ(0u, hal.count(Op::RESET_PIN));
+}
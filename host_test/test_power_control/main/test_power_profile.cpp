@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "power_control.hpp"
+#include "power_profile.hpp"
+#include "profile_rails_fixture.hpp"
+#include "recording_gpio_hal.hpp"
+
+using namespace power_control;
+
+using Op = RecordingGpioHAL::Op;
+
+using PowerProfileTest = ProfileRailsTest;
+
+TEST_F(PowerProfileTest, SnapshotCapturesRailStates)
+{
+    PowerProfileGroup profiles(rails);
+    EXPECT_EQ(PIN_4 | PIN_5 | PIN_6, profiles.get_pin_mask());
+    EXPECT_EQ(3u, profiles.get_count());
+    EXPECT_EQ(0u, profiles.snapshot().get_on_mask());
+
+    ASSERT_EQ(ESP_OK, modem.turn_on());
+    const PowerProfile transmit = profiles.snapshot();
+    EXPECT_EQ(PIN_5, transmit.get_on_mask());
+    EXPECT_TRUE(transmit.is_on(GPIO_NUM_5));
+    EXPECT_FALSE(transmit.is_on(GPIO_NUM_4));
+}
+
+TEST_F(PowerProfileTest, ApplyWritesOnlyTheDeltaInOneCall)
+{
+    PowerProfileGroup profiles(rails);
+    ASSERT_EQ(ESP_OK, sensor.turn_on());
+    hal.events.clear();
+
+    // GPIO4 stays ON, GPIO5 (active LOW) and GPIO6 turn ON
+    ASSERT_EQ(ESP_OK, profiles.apply_profile(PowerProfile{PIN_4 | PIN_5 | PIN_6}));
+
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(Op::SET_LEVELS_MASK, hal.events[0].op);
+    EXPECT_EQ(PIN_6, hal.events[0].mask);       // Set
+    EXPECT_EQ(PIN_5, hal.events[0].clear_mask); // Cleared (active LOW ON)
+    EXPECT_TRUE(sensor.is_on());
+    EXPECT_TRUE(modem.is_on());
+    EXPECT_TRUE(heater.is_on());
+
+    // Back to idle: everything OFF in one write
+    hal.events.clear();
+    ASSERT_EQ(ESP_OK, profiles.apply_profile(PowerProfile{0}));
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(PIN_5, hal.events[0].mask);
+    EXPECT_EQ(PIN_4 | PIN_6, hal.events[0].clear_mask);
+    EXPECT_EQ(0u, profiles.snapshot().get_on_mask());
+    EXPECT_EQ(PIN_5, hal.levels);
+}
+
+TEST_F(PowerProfileTest, ApplyCurrentProfileSkipsTheHal)
+{
+    PowerProfileGroup profiles(rails);
+    ASSERT_EQ(ESP_OK, profiles.apply_profile(profiles.snapshot()));
+    EXPECT_TRUE(hal.events.empty());
+}
+
+TEST_F(PowerProfileTest, ApplyUpdatesRailBookkeeping)
+{
+    PowerProfileGroup profiles(rails);
+    ASSERT_EQ(ESP_OK, sensor.turn_on_for(10000));
+    ASSERT_TRUE(sensor.is_auto_off_pending());
+
+    ASSERT_EQ(ESP_OK, profiles.apply_profile(PowerProfile{PIN_6}));
+    EXPECT_FALSE(sensor.is_on());
+    EXPECT_FALSE(sensor.is_auto_off_pending()); // Cancelled like turn_off()
+#if CONFIG_POWER_CONTROL_STATS
+    EXPECT_EQ(1u, heater.get_stats().on_count);
+    EXPECT_EQ(1u, sensor.get_stats().off_count);
+#endif
+}
+
+TEST_F(PowerProfileTest, ApplyRejectsInvalidRequests)
+{
+    PowerProfileGroup profiles(rails);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, profiles.apply_profile(PowerProfile{1ULL << GPIO_NUM_7}));
+
+    ASSERT_EQ(ESP_OK, modem.deinit());
+    hal.events.clear();
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, profiles.apply_profile(PowerProfile{PIN_4}));
+    EXPECT_TRUE(hal.events.empty());
+}
+
+TEST_F(PowerProfileTest, InvalidRailListsAreRejected)
+{
+    RecordingGpioHAL other_hal;
+    PowerControl other(other_hal, GPIO_NUM_7);
+    PowerControl duplicate(hal, GPIO_NUM_4);
+
+    PowerControl *const mixed[] = {&sensor, &other};
+    PowerControl *const duplicated[] = {&sensor, &duplicate};
+    PowerControl *const with_null[] = {&sensor, nullptr};
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, PowerProfileGroup(mixed).apply_profile(PowerProfile{0}));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, PowerProfileGroup(duplicated).apply_profile(PowerProfile{0}));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, PowerProfileGroup(with_null).apply_profile(PowerProfile{0}));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, PowerProfileGroup(rails, 0).apply_profile(PowerProfile{0}));
+}
+
+TEST_F(PowerProfileTest, HalFailureLeavesStatesUnchanged)
+{
+    PowerProfileGroup profiles(rails);
+    hal.fail_mask = PIN_6;
+
+    EXPECT_EQ(ESP_FAIL, profiles.apply_profile(PowerProfile{PIN_4 | PIN_6}));
+    EXPECT_FALSE(sensor.is_on());
+    EXPECT_FALSE(heater.is_on());
+}
@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "power_rail_table.hpp"
+#include "recording_gpio_hal.hpp"
+
+using namespace power_control;
+
+using Op = RecordingGpioHAL::Op;
+using Table = PowerRailTable<4>;
+
+class PowerRailTableTest : public ::testing::Test
+{
+protected:
+    RecordingGpioHAL hal;
+    Table table{hal};
+    Table::Handle sensor = 0;
+    Table::Handle modem = 0;
+    Table::Handle heater = 0;
+
+    const uint64_t PIN_4 = 1ULL << GPIO_NUM_4;
+    const uint64_t PIN_5 = 1ULL << GPIO_NUM_5;
+    const uint64_t PIN_6 = 1ULL << GPIO_NUM_6;
+
+    void SetUp() override
+    {
+        // GPIO4 and GPIO6 active HIGH, GPIO5 active LOW
+        ASSERT_EQ(ESP_OK, table.add(GPIO_NUM_4, false, false, sensor));
+        ASSERT_EQ(ESP_OK, table.add(GPIO_NUM_5, true, false, modem));
+        ASSERT_EQ(ESP_OK, table.add(GPIO_NUM_6, false, true, heater));
+    }
+};
+
+TEST_F(PowerRailTableTest, Add_AssignsHandlesAndRejectsBadRails)
+{
+    EXPECT_EQ(0, sensor);
+    EXPECT_EQ(1, modem);
+    EXPECT_EQ(2, heater);
+    EXPECT_EQ(3u, table.size());
+    EXPECT_EQ(GPIO_NUM_5, table.get_pin(modem));
+    EXPECT_EQ(GPIO_NUM_NC, table.get_pin(3));
+
+    Table::Handle handle = 0;
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, table.add(GPIO_NUM_4, false, false, handle)); // Duplicate
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, table.add(GPIO_NUM_MAX, false, false, handle));
+    EXPECT_EQ(ESP_OK, table.add(GPIO_NUM_7, false, false, handle));
+    EXPECT_EQ(ESP_ERR_NO_MEM, table.add(GPIO_NUM_8, false, false, handle));
+}
+
+TEST_F(PowerRailTableTest, Init_BatchesEveryRail)
+{
+    ASSERT_EQ(ESP_OK, table.init());
+
+    ASSERT_EQ(3u, hal.events.size());
+    EXPECT_EQ(Op::RESET_PINS_MASK, hal.events[0].op);
+    EXPECT_EQ(PIN_4 | PIN_5 | PIN_6, hal.events[0].mask);
+    EXPECT_EQ(Op::CONFIG, hal.events[1].op);
+    EXPECT_EQ(Op::SET_LEVELS_MASK, hal.events[2].op);
+    EXPECT_EQ(PIN_5 | PIN_6, hal.levels); // Modem OFF (active LOW), heater ON
+
+    EXPECT_EQ(Table::mask_of(heater), table.get_on_mask());
+    EXPECT_TRUE(table.is_initialized(modem));
+
+    // Second init is a no-op
+    hal.events.clear();
+    EXPECT_EQ(ESP_OK, table.init());
+    EXPECT_TRUE(hal.events.empty());
+}
+
+TEST_F(PowerRailTableTest, Init_FailureLeavesRailsUninitialized)
+{
+    hal.fail_mask = PIN_5;
+    EXPECT_EQ(ESP_FAIL, table.init());
+    EXPECT_EQ(0u, table.get_initialized_mask());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, table.turn_on(sensor));
+}
+
+TEST_F(PowerRailTableTest, SingleRailSwitching)
+{
+    ASSERT_EQ(ESP_OK, table.init());
+    hal.events.clear();
+
+    EXPECT_EQ(ESP_OK, table.turn_on(modem));
+    EXPECT_TRUE(table.is_on(modem));
+    EXPECT_EQ(PIN_6, hal.levels); // Active LOW: pin cleared
+
+    EXPECT_EQ(ESP_OK, table.toggle(sensor));
+    EXPECT_TRUE(table.is_on(sensor));
+    EXPECT_EQ(PIN_4 | PIN_6, hal.levels);
+
+    EXPECT_EQ(ESP_OK, table.turn_off(heater));
+    EXPECT_EQ(PIN_4, hal.levels);
+    EXPECT_EQ(3u, hal.count(Op::SET_LEVELS_MASK));
+
+    // Already OFF: nothing to write
+    EXPECT_EQ(ESP_OK, table.turn_off(heater));
+    EXPECT_EQ(3u, hal.events.size());
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, table.turn_on(3));
+}
+
+TEST_F(PowerRailTableTest, BulkOperationsWriteOnce)
+{
+    ASSERT_EQ(ESP_OK, table.init());
+    hal.events.clear();
+
+    ASSERT_EQ(ESP_OK, table.turn_on_mask(Table::mask_of(sensor) | Table::mask_of(modem)));
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(PIN_4, hal.events[0].mask);
+    EXPECT_EQ(PIN_5, hal.events[0].clear_mask);
+    EXPECT_EQ(0x7u, table.get_on_mask());
+
+    // Only the modem changes
+    hal.events.clear();
+    ASSERT_EQ(ESP_OK, table.apply_mask(Table::mask_of(sensor) | Table::mask_of(heater)));
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(PIN_5, hal.events[0].mask);
+    EXPECT_EQ(0u, hal.events[0].clear_mask);
+
+    hal.events.clear();
+    ASSERT_EQ(ESP_OK, table.turn_off_mask(0x7));
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(PIN_5, hal.levels);
+    EXPECT_EQ(0u, table.get_on_mask());
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, table.turn_on_mask(Table::mask_of(3)));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, table.apply_mask(Table::mask_of(3)));
+}
+
+TEST_F(PowerRailTableTest, HalFailureKeepsState)
+{
+    ASSERT_EQ(ESP_OK, table.init());
+    hal.fail_mask = PIN_4;
+
+    EXPECT_EQ(ESP_FAIL, table.turn_on_mask(Table::mask_of(sensor) | Table::mask_of(modem)));
+    EXPECT_EQ(Table::mask_of(heater), table.get_on_mask());
+}
+
+TEST_F(PowerRailTableTest, RailsAddedLaterAreInitializedSeparately)
+{
+    ASSERT_EQ(ESP_OK, table.init());
+    Table::Handle fan = 0;
+    ASSERT_EQ(ESP_OK, table.add(GPIO_NUM_7, false, true, fan));
+    EXPECT_FALSE(table.is_initialized(fan));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, table.apply_mask(Table::mask_of(fan)));
+
+    hal.events.clear();
+    ASSERT_EQ(ESP_OK, table.init());
+    EXPECT_EQ(1ULL << GPIO_NUM_7, hal.events[0].mask); // Only the new rail
+    EXPECT_TRUE(table.is_on(fan));
+}
+
+TEST_F(PowerRailTableTest, Deinit_ForcesLowAndResets)
+{
+    ASSERT_EQ(ESP_OK, table.init());
+    hal.events.clear();
+
+    EXPECT_EQ(ESP_OK, table.deinit());
+    ASSERT_EQ(2u, hal.events.size());
+    EXPECT_EQ(PIN_4 | PIN_5 | PIN_6, hal.events[0].clear_mask);
+    EXPECT_EQ(Op::RESET_PINS_MASK, hal.events[1].op);
+    EXPECT_EQ(0u, table.get_initialized_mask());
+    EXPECT_EQ(0u, table.get_on_mask());
+    EXPECT_EQ(3u, table.size()); // Still registered
+
+    // Second deinit is a no-op
+    EXPECT_EQ(ESP_OK, table.deinit());
+}
@@ -0,0 +1,335 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "fake_timer_hal.hpp"
+#include "mock_power_control.hpp"
+#include "power_control.hpp"
+#include "power_profile.hpp"
+#include "power_scheduler.hpp"
+#include "recording_gpio_hal.hpp"
+
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::Return;
+
+using namespace power_control;
+
+class PowerSchedulerTest : public ::testing::Test
+{
+protected:
+    FakeTimerHAL fake_timer;
+    MockPowerControl rail_a;
+    MockPowerControl rail_b;
+    MockPowerControl rail_c;
+};
+
+TEST_F(PowerSchedulerTest, DutyCyclesRailsWithOneTimer)
+{
+    const PowerSchedule table[] = {
+        PowerSchedule::every(rail_a, 1000, 100),      // ON 0-100, 1000-1100, ...
+        PowerSchedule::every(rail_b, 3000, 500, 200), // ON 200-700, 3200-3700, ...
+    };
+    PowerScheduler scheduler(fake_timer, table);
+
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_OK)); // No phase: runs in start()
+    EXPECT_EQ(ESP_OK, scheduler.start());
+    EXPECT_TRUE(scheduler.is_running());
+    ::testing::Mock::VerifyAndClearExpectations(&rail_a);
+
+    EXPECT_CALL(rail_a, turn_off()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(100);
+    EXPECT_CALL(rail_b, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(100);
+    EXPECT_CALL(rail_b, turn_off()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(500);
+    ::testing::Mock::VerifyAndClearExpectations(&rail_a);
+    ::testing::Mock::VerifyAndClearExpectations(&rail_b);
+
+    // Second cycle of rail_a, timed from the start, not from the callbacks
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(300);
+    EXPECT_EQ(1u, fake_timer.timers.size()); // Still a single timer
+}
+
+TEST_F(PowerSchedulerTest, CoincidingEventsShareOneWakeUpOffFirst)
+{
+    const PowerSchedule table[] = {
+        PowerSchedule::every(rail_a, 1000, 1000 - 300, 300), // ON from 300, OFF at 1000
+        PowerSchedule::every(rail_b, 1000, 200, 1000),       // ON at 1000
+    };
+    PowerScheduler scheduler(fake_timer, table);
+    ASSERT_EQ(ESP_OK, scheduler.start());
+
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(300);
+
+    const int starts = fake_timer.starts;
+    {
+        InSequence s;
+        EXPECT_CALL(rail_a, turn_off()).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(rail_b, turn_on()).WillOnce(Return(ESP_OK));
+    }
+    fake_timer.advance(700);
+    EXPECT_EQ(starts + 1, fake_timer.starts); // One wake-up, re-armed once
+}
+
+TEST_F(PowerSchedulerTest, GroupRailsSwitchInOneWritePerWakeUp)
+{
+    RecordingGpioHAL hal;
+    PowerControl pc_a(hal, GPIO_NUM_4);
+    PowerControl pc_b(hal, GPIO_NUM_5, true);
+    ASSERT_EQ(ESP_OK, pc_a.init());
+    ASSERT_EQ(ESP_OK, pc_b.init());
+    PowerControl *const rails[] = {&pc_a, &pc_b};
+    PowerProfileGroup group(rails);
+
+    const PowerSchedule table[] = {
+        PowerSchedule::every(pc_a, 1000, 1000 - 300, 300), // ON from 300, OFF at 1000
+        PowerSchedule::every(pc_b, 1000, 200, 1000),       // ON at 1000
+        PowerSchedule::every(rail_c, 1000, 500, 1000),     // Not in the group
+    };
+    PowerScheduler scheduler(fake_timer, table);
+    scheduler.set_group(&group);
+    ASSERT_EQ(ESP_OK, scheduler.start());
+    fake_timer.advance(300);
+    ASSERT_TRUE(pc_a.is_on());
+
+    // pc_a OFF and pc_b (active low) ON in one write, rail_c on its own
+    hal.events.clear();
+    EXPECT_CALL(rail_c, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(700);
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(RecordingGpioHAL::Op::SET_LEVELS_MASK, hal.events[0].op);
+    EXPECT_EQ(0u, hal.events[0].mask);
+    EXPECT_EQ((1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_5), hal.events[0].clear_mask);
+    EXPECT_FALSE(pc_a.is_on());
+    EXPECT_TRUE(pc_b.is_on());
+
+    // stop() switches the group rails left ON in one write as well
+    hal.events.clear();
+    EXPECT_CALL(rail_c, turn_off()).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, scheduler.stop());
+    ASSERT_EQ(1u, hal.events.size());
+    EXPECT_EQ(1ULL << GPIO_NUM_5, hal.events[0].mask);
+    EXPECT_FALSE(pc_b.is_on());
+}
+
+TEST_F(PowerSchedulerTest, RefusedGroupWriteFallsBackToOneCallPerRail)
+{
+    RecordingGpioHAL hal;
+    PowerControl pc_a(hal, GPIO_NUM_4);
+    PowerControl pc_b(hal, GPIO_NUM_5);
+    ASSERT_EQ(ESP_OK, pc_a.init());
+    ASSERT_EQ(ESP_OK, pc_b.init());
+    PowerControl *const rails[] = {&pc_a, &pc_b};
+    PowerProfileGroup group(rails);
+
+    const PowerSchedule table[] = {
+        PowerSchedule::every(pc_a, 1000, 100, 500),
+        PowerSchedule::every(pc_b, 1000, 100, 500),
+    };
+    PowerScheduler scheduler(fake_timer, table);
+    scheduler.set_group(&group);
+    ASSERT_EQ(ESP_OK, scheduler.start());
+
+    // pc_b fails: the batch is refused, pc_a still switches on its own
+    hal.fail_mask = 1ULL << GPIO_NUM_5;
+    fake_timer.advance(500);
+    EXPECT_TRUE(pc_a.is_on());
+    EXPECT_FALSE(pc_b.is_on());
+    EXPECT_EQ(1u, scheduler.get_error_count());
+    EXPECT_EQ(1u, hal.count(RecordingGpioHAL::Op::SET_LEVELS_MASK));
+}
+
+TEST_F(PowerSchedulerTest, CoalesceWindowPullsInCloseEvents)
+{
+    const PowerSchedule table[] = {
+        PowerSchedule::every(rail_a, 10000, 100, 1000),
+        PowerSchedule::every(rail_b, 10000, 100, 1040),
+    };
+    PowerScheduler scheduler(fake_timer, table);
+    scheduler.set_coalesce_window_us(50);
+    ASSERT_EQ(ESP_OK, scheduler.start());
+
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(rail_b, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1000);
+}
+
+TEST_F(PowerSchedulerTest, AutoStaggerSpreadsPhases)
+{
+    const PowerSchedule table[] = {
+        PowerSchedule::every(rail_a, 900, 100),
+        PowerSchedule::every(rail_b, 900, 100),
+        PowerSchedule::every(rail_c, 900, 100),
+    };
+    PowerScheduler scheduler(fake_timer, table);
+    scheduler.set_auto_stagger(true);
+
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, scheduler.start());
+
+    EXPECT_CALL(rail_a, turn_off()).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(rail_b, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(300);
+    EXPECT_CALL(rail_b, turn_off()).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(rail_c, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(300);
+}
+
+TEST_F(PowerSchedulerTest, AlwaysAndNeverOnSchedules)
+{
+    const PowerSchedule table[] = {
+        PowerSchedule::every(rail_a, 1000, 1000),
+        PowerSchedule::every(rail_b, 1000, 0),
+    };
+    PowerScheduler scheduler(fake_timer, table);
+
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(rail_a, turn_off()).Times(0);
+    EXPECT_CALL(rail_b, turn_on()).Times(0);
+    ASSERT_EQ(ESP_OK, scheduler.start());
+    fake_timer.advance(10000);
+    ::testing::Mock::VerifyAndClearExpectations(&rail_a);
+
+    // stop() switches OFF what the schedule left ON
+    EXPECT_CALL(rail_a, turn_off()).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, scheduler.stop());
+    EXPECT_FALSE(scheduler.is_running());
+}
+
+TEST_F(PowerSchedulerTest, MissedCyclesAreSkipped)
+{
+    const PowerSchedule table[] = {
+        PowerSchedule::every(rail_a, 1000, 100, 100),
+    };
+    PowerScheduler scheduler(fake_timer, table);
+    ASSERT_EQ(ESP_OK, scheduler.start());
+
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(100);
+
+    // Timer task blocked until t = 3500: one late OFF, then on schedule again at 4100
+    FakeTimerHAL::Timer &timer = fake_timer.timers[0];
+    fake_timer.now_us = 3500;
+    timer.armed = false;
+    EXPECT_CALL(rail_a, turn_off()).WillOnce(Return(ESP_OK));
+    timer.callback(timer.arg);
+    ::testing::Mock::VerifyAndClearExpectations(&rail_a);
+
+    EXPECT_CALL(rail_a, turn_on()).Times(0);
+    fake_timer.advance(599);
+    ::testing::Mock::VerifyAndClearExpectations(&rail_a);
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1);
+}
+
+TEST_F(PowerSchedulerTest, RailFailureKeepsSchedule)
+{
+    const PowerSchedule table[] = {
+        PowerSchedule::every(rail_a, 1000, 100),
+    };
+    PowerScheduler scheduler(fake_timer, table);
+
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_FAIL)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(rail_a, turn_off()).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, scheduler.start());
+    fake_timer.advance(1000);
+    EXPECT_EQ(1u, scheduler.get_error_count());
+}
+
+TEST_F(PowerSchedulerTest, StopSwitchesOffARailWhoseTurnOffFailed)
+{
+    const PowerSchedule table[] = {
+        PowerSchedule::every(rail_a, 1000, 100),
+    };
+    PowerScheduler scheduler(fake_timer, table);
+
+    EXPECT_CALL(rail_a, turn_on()).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, scheduler.start());
+    EXPECT_CALL(rail_a, turn_off()).WillOnce(Return(ESP_FAIL)).WillOnce(Return(ESP_OK));
+    fake_timer.advance(100);
+    EXPECT_EQ(1u, scheduler.get_error_count());
+
+    // Still ON after the failed event: stop() switches it OFF
+    EXPECT_EQ(ESP_OK, scheduler.stop());
+}
+
+TEST_F(PowerSchedulerTest, StopDuringAWakeUpIsCarriedOutWhenItEnds)
+{
+    const PowerSchedule table[] = {
+        PowerSchedule::every(rail_a, 1000, 100, 500),
+        PowerSchedule::every(rail_b, 1000, 100, 500),
+    };
+    PowerScheduler scheduler(fake_timer, table);
+    ASSERT_EQ(ESP_OK, scheduler.start());
+
+    // rail_a's turn_on() stops the schedule from inside the wake-up
+    EXPECT_CALL(rail_a, turn_on()).WillOnce([&]() {
+        EXPECT_EQ(ESP_OK, scheduler.stop());
+        EXPECT_FALSE(scheduler.is_running());
+        EXPECT_EQ(ESP_ERR_INVALID_STATE, scheduler.start()); // Not until the wake-up has ended
+        return ESP_OK;
+    });
+    EXPECT_CALL(rail_b, turn_on()).Times(0); // No further events once stopped
+    EXPECT_CALL(rail_a, turn_off()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(500);
+    ::testing::Mock::VerifyAndClearExpectations(&rail_a);
+    EXPECT_FALSE(scheduler.is_running());
+    EXPECT_FALSE(fake_timer.is_armed(0)); // Not re-armed by the wake-up
+
+    // Nothing else happens, and the schedule can be started again
+    fake_timer.advance(5000);
+    EXPECT_EQ(ESP_OK, scheduler.stop());
+    EXPECT_EQ(ESP_OK, scheduler.start());
+    EXPECT_TRUE(scheduler.is_running());
+}
+
+TEST_F(PowerSchedulerTest, GroupChangeWaitsForTheNextStart)
+{
+    RecordingGpioHAL hal;
+    PowerControl pc_a(hal, GPIO_NUM_4);
+    ASSERT_EQ(ESP_OK, pc_a.init());
+    PowerControl *const rails[] = {&pc_a};
+    PowerProfileGroup group(rails);
+
+    const PowerSchedule table[] = {
+        PowerSchedule::every(pc_a, 1000, 500),
+    };
+    PowerScheduler scheduler(fake_timer, table);
+    scheduler.set_group(&group);
+    ASSERT_EQ(ESP_OK, scheduler.start());
+    ASSERT_TRUE(pc_a.is_on());
+
+    // Dropping the group while running: stop() still uses the group it started with
+    scheduler.set_group(nullptr);
+    hal.events.clear();
+    EXPECT_EQ(ESP_OK, scheduler.stop());
+    EXPECT_FALSE(pc_a.is_on());
+    EXPECT_EQ(1u, hal.count(RecordingGpioHAL::Op::SET_LEVELS_MASK));
+
+    // The next run switches the rail on its own
+    ASSERT_EQ(ESP_OK, scheduler.start());
+    EXPECT_TRUE(pc_a.is_on());
+    EXPECT_EQ(1u, hal.count(RecordingGpioHAL::Op::SET_LEVELS_MASK));
+}
+
+TEST_F(PowerSchedulerTest, StartValidation)
+{
+    const PowerSchedule bad_period[] = {PowerSchedule::every(rail_a, 0, 0)};
+    const PowerSchedule bad_on[] = {PowerSchedule::every(rail_a, 100, 200)};
+    const PowerSchedule table[] = {PowerSchedule::every(rail_a, 1000, 100, 500)};
+    PowerScheduler s1(fake_timer, bad_period);
+    PowerScheduler s2(fake_timer, bad_on);
+    PowerScheduler s3(fake_timer, table);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, s1.start());
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, s2.start());
+    EXPECT_EQ(ESP_OK, s3.start());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, s3.start());
+    EXPECT_EQ(ESP_OK, s3.stop());
+
+    fake_timer.fail_create = true;
+    PowerScheduler s4(fake_timer, table);
+    EXPECT_EQ(ESP_ERR_NO_MEM, s4.start());
+}
@@ -0,0 +1,193 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "fake_timer_hal.hpp"
+#include "mock_power_control.hpp"
+#include "power_sequencer.hpp"
+
+using ::testing::InSequence;
+using ::testing::Return;
+
+using namespace power_control;
+
+class PowerSequencerTest : public ::testing::Test
+{
+protected:
+    FakeTimerHAL fake_timer;
+    MockPowerControl rail_3v3;
+    MockPowerControl rail_5v;
+    MockPowerControl rail_vref;
+
+    esp_err_t result = ESP_FAIL;
+    int done_count = 0;
+
+    static void on_done(esp_err_t result, void *ctx)
+    {
+        PowerSequencerTest *self = static_cast<PowerSequencerTest *>(ctx);
+        self->result = result;
+        self->done_count++;
+    }
+};
+
+// Sequence tables can be built at compile time
+static MockPowerControl *const null_rail = nullptr;
+constexpr PowerSequenceStep constexpr_table[] = {
+    {null_rail, true, 0},
+    {null_rail, false, 100},
+};
+static_assert(constexpr_table[1].delay_us == 100, "steps are constant expressions");
+
+TEST_F(PowerSequencerTest, PowerUp_RunsStepsInOrderWithDelays)
+{
+    const PowerSequenceStep steps[] = {
+        PowerSequenceStep::on(rail_3v3, 0),
+        PowerSequenceStep::on(rail_5v, 200),
+        PowerSequenceStep::on(rail_vref, 1000),
+    };
+    PowerSequencer seq(fake_timer, steps);
+
+    // First step has no delay: runs in the caller's context
+    EXPECT_CALL(rail_3v3, turn_on()).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, seq.power_up(on_done, this));
+    EXPECT_TRUE(seq.is_running());
+    EXPECT_EQ(1u, seq.get_position());
+
+    fake_timer.advance(199);
+    EXPECT_CALL(rail_5v, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1);
+    EXPECT_EQ(2u, seq.get_position());
+
+    fake_timer.advance(999);
+    EXPECT_EQ(0, done_count);
+    EXPECT_CALL(rail_vref, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1);
+
+    EXPECT_FALSE(seq.is_running());
+    EXPECT_EQ(1, done_count);
+    EXPECT_EQ(ESP_OK, result);
+}
+
+TEST_F(PowerSequencerTest, PowerDown_RunsReverseWithSameSpacing)
+{
+    const PowerSequenceStep steps[] = {
+        PowerSequenceStep::on(rail_3v3, 0),
+        PowerSequenceStep::on(rail_5v, 200),
+        PowerSequenceStep::on(rail_vref, 1000),
+    };
+    PowerSequencer seq(fake_timer, steps);
+
+    // Reference off immediately, 5V 1 ms later, 3V3 200 us after that
+    EXPECT_CALL(rail_vref, turn_off()).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, seq.power_down(on_done, this));
+
+    fake_timer.advance(999);
+    EXPECT_CALL(rail_5v, turn_off()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1);
+
+    fake_timer.advance(199);
+    EXPECT_EQ(0, done_count);
+    EXPECT_CALL(rail_3v3, turn_off()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1);
+
+    EXPECT_EQ(1, done_count);
+    EXPECT_EQ(ESP_OK, result);
+}
+
+TEST_F(PowerSequencerTest, StepFailure_UnwindsSwitchedRails)
+{
+    const PowerSequenceStep steps[] = {
+        PowerSequenceStep::on(rail_3v3, 0),
+        PowerSequenceStep::on(rail_5v, 0),
+        PowerSequenceStep::on(rail_vref, 100),
+    };
+    PowerSequencer seq(fake_timer, steps);
+
+    {
+        InSequence s;
+        EXPECT_CALL(rail_3v3, turn_on()).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(rail_5v, turn_on()).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(rail_vref, turn_on()).WillOnce(Return(ESP_ERR_INVALID_STATE));
+        // Unwind in reverse order
+        EXPECT_CALL(rail_5v, turn_off()).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(rail_3v3, turn_off()).WillOnce(Return(ESP_OK));
+    }
+
+    EXPECT_EQ(ESP_OK, seq.power_up(on_done, this));
+    fake_timer.advance(100);
+
+    EXPECT_FALSE(seq.is_running());
+    EXPECT_EQ(1, done_count);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, result);
+    EXPECT_EQ(2u, seq.get_position());
+}
+
+TEST_F(PowerSequencerTest, Cancel_StopsPendingSteps)
+{
+    const PowerSequenceStep steps[] = {
+        PowerSequenceStep::on(rail_3v3, 0),
+        PowerSequenceStep::on(rail_5v, 500),
+    };
+    PowerSequencer seq(fake_timer, steps);
+
+    EXPECT_CALL(rail_3v3, turn_on()).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(rail_5v, turn_on()).Times(0);
+
+    EXPECT_EQ(ESP_OK, seq.power_up(on_done, this));
+    EXPECT_EQ(ESP_OK, seq.cancel());
+    fake_timer.advance(1000);
+
+    EXPECT_FALSE(seq.is_running());
+    EXPECT_EQ(0, done_count);
+    EXPECT_EQ(ESP_OK, seq.cancel()); // No-op when idle
+}
+
+TEST_F(PowerSequencerTest, Start_RejectedWhileRunning)
+{
+    const PowerSequenceStep steps[] = {
+        PowerSequenceStep::on(rail_3v3, 100),
+    };
+    PowerSequencer seq(fake_timer, steps);
+
+    EXPECT_EQ(ESP_OK, seq.power_up(nullptr, nullptr));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, seq.power_up(nullptr, nullptr));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, seq.power_down(nullptr, nullptr));
+
+    EXPECT_CALL(rail_3v3, turn_on()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(100);
+    EXPECT_FALSE(seq.is_running());
+}
+
+TEST_F(PowerSequencerTest, Start_RejectsInvalidTableAndTimerFailure)
+{
+    const PowerSequenceStep steps[] = {
+        {nullptr, true, 0},
+    };
+    PowerSequencer bad(fake_timer, steps);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, bad.power_up(on_done, this));
+
+    const PowerSequenceStep good_steps[] = {
+        PowerSequenceStep::off(rail_3v3),
+    };
+    PowerSequencer seq(fake_timer, good_steps);
+    fake_timer.fail_create = true;
+    EXPECT_EQ(ESP_ERR_NO_MEM, seq.power_up(on_done, this));
+    EXPECT_FALSE(seq.is_running());
+    EXPECT_EQ(0, done_count);
+}
+
+TEST_F(PowerSequencerTest, ZeroDelayTable_CompletesSynchronously)
+{
+    const PowerSequenceStep steps[] = {
+        PowerSequenceStep::on(rail_3v3),
+        PowerSequenceStep::off(rail_5v),
+    };
+    PowerSequencer seq(fake_timer, steps);
+
+    EXPECT_CALL(rail_3v3, turn_on()).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(rail_5v, turn_off()).WillOnce(Return(ESP_OK));
+
+    EXPECT_EQ(ESP_OK, seq.power_up(on_done, this));
+    EXPECT_EQ(1, done_count);
+    EXPECT_EQ(ESP_OK, result);
+    EXPECT_EQ(0, fake_timer.starts);
+}
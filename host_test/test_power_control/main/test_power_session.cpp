@@ -0,0 +1,158 @@
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "fake_timer_hal.hpp"
+#include "power_control.hpp"
+#include "power_session.hpp"
+#include "recording_gpio_hal.hpp"
+#include "shared_power_control.hpp"
+
+using namespace power_control;
+
+class PowerSessionTest : public ::testing::Test
+{
+protected:
+    RecordingGpioHAL hal;
+    FakeTimerHAL fake_timer;
+
+    PowerControl imu{hal, GPIO_NUM_4};
+    PowerControl baro{hal, GPIO_NUM_5, true};
+
+    void SetUp() override
+    {
+        ASSERT_EQ(ESP_OK, imu.init());
+        ASSERT_EQ(ESP_OK, baro.init());
+    }
+
+    /// Reads a "sensor" with an early error return
+    esp_err_t read_with_early_return(bool fail)
+    {
+        PowerSession session;
+        esp_err_t ret = PowerSession::acquire(imu, fake_timer, 1000, session);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (fail) {
+            return ESP_ERR_TIMEOUT; // Rail must not stay ON
+        }
+        return session.wait_ready();
+    }
+};
+
+TEST_F(PowerSessionTest, SessionScopeSwitchesTheRail)
+{
+    {
+        PowerSession session;
+        ASSERT_EQ(ESP_OK, PowerSession::acquire(imu, fake_timer, 0, session));
+        EXPECT_TRUE(session.is_active());
+        EXPECT_TRUE(session.is_ready());
+        EXPECT_TRUE(imu.is_on());
+    }
+    EXPECT_FALSE(imu.is_on());
+
+    EXPECT_EQ(ESP_ERR_TIMEOUT, read_with_early_return(true));
+    EXPECT_FALSE(imu.is_on());
+    EXPECT_EQ(ESP_OK, read_with_early_return(false));
+    EXPECT_FALSE(imu.is_on());
+}
+
+TEST_F(PowerSessionTest, WaitReadyWaitsOnlyTheRemainingTime)
+{
+    PowerSession session;
+    ASSERT_EQ(ESP_OK, PowerSession::acquire(imu, fake_timer, 1000, session));
+    EXPECT_FALSE(session.is_ready());
+    EXPECT_EQ(1000, session.get_remaining_us());
+
+    fake_timer.advance(400); // Other work meanwhile
+    EXPECT_EQ(600, session.get_remaining_us());
+    ASSERT_EQ(ESP_OK, session.wait_ready());
+    EXPECT_EQ(600, fake_timer.delayed_us);
+    EXPECT_TRUE(session.is_ready());
+
+    ASSERT_EQ(ESP_OK, session.wait_ready()); // Already settled
+    EXPECT_EQ(600, fake_timer.delayed_us);
+}
+
+TEST_F(PowerSessionTest, BackToBackSessionsWarmUpInParallel)
+{
+    PowerSession imu_session;
+    PowerSession baro_session;
+    ASSERT_EQ(ESP_OK, PowerSession::acquire(imu, fake_timer, 20000, imu_session));
+    ASSERT_EQ(ESP_OK, PowerSession::acquire(baro, fake_timer, 5000, baro_session));
+
+    ASSERT_EQ(ESP_OK, baro_session.wait_ready());
+    EXPECT_EQ(5000, fake_timer.delayed_us);
+    ASSERT_EQ(ESP_OK, imu_session.wait_ready());
+    EXPECT_EQ(20000, fake_timer.delayed_us); // The longest warm-up, not the sum
+}
+
+TEST_F(PowerSessionTest, AlreadyOnRailIsSettled)
+{
+    ASSERT_EQ(ESP_OK, imu.turn_on());
+    PowerSession session;
+    ASSERT_EQ(ESP_OK, PowerSession::acquire(imu, fake_timer, 1000, session));
+    EXPECT_TRUE(session.is_ready());
+    ASSERT_EQ(ESP_OK, session.release());
+    EXPECT_FALSE(imu.is_on());
+    EXPECT_FALSE(session.is_active());
+    EXPECT_EQ(ESP_OK, session.release()); // Empty: nothing to do
+}
+
+TEST_F(PowerSessionTest, MoveTransfersTheRail)
+{
+    PowerSession first;
+    ASSERT_EQ(ESP_OK, PowerSession::acquire(imu, fake_timer, 1000, first));
+
+    PowerSession second(std::move(first));
+    EXPECT_FALSE(first.is_active());
+    EXPECT_TRUE(second.is_active());
+    EXPECT_EQ(1000, second.get_remaining_us());
+    EXPECT_TRUE(imu.is_on());
+
+    // Assigning over an active session ends it first
+    PowerSession third;
+    ASSERT_EQ(ESP_OK, PowerSession::acquire(baro, fake_timer, 0, third));
+    second = std::move(third);
+    EXPECT_FALSE(imu.is_on());
+    EXPECT_TRUE(baro.is_on());
+
+    // Re-acquiring into an active session also ends it first
+    ASSERT_EQ(ESP_OK, PowerSession::acquire(imu, fake_timer, 0, second));
+    EXPECT_FALSE(baro.is_on());
+    EXPECT_TRUE(imu.is_on());
+}
+
+TEST_F(PowerSessionTest, FailedAcquireLeavesTheSessionEmpty)
+{
+    PowerControl uninitialized(hal, GPIO_NUM_6);
+    PowerSession session;
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, PowerSession::acquire(uninitialized, fake_timer, 1000, session));
+    EXPECT_FALSE(session.is_active());
+    EXPECT_FALSE(session.is_ready());
+    EXPECT_EQ(0, session.get_remaining_us());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, session.wait_ready());
+}
+
+TEST_F(PowerSessionTest, SharedRailSessionsHoldReferences)
+{
+    SharedPowerControl shared(imu);
+    {
+        PowerSession first;
+        ASSERT_EQ(ESP_OK, PowerSession::acquire(shared, fake_timer, 1000, first));
+        EXPECT_EQ(1000, first.get_remaining_us());
+        {
+            fake_timer.advance(300);
+            PowerSession second;
+            ASSERT_EQ(ESP_OK, PowerSession::acquire(shared, fake_timer, 1000, second));
+            EXPECT_EQ(2u, shared.get_ref_count());
+            EXPECT_TRUE(second.is_ready()); // Powered by the first session already
+        }
+        EXPECT_EQ(1u, shared.get_ref_count());
+        EXPECT_TRUE(imu.is_on());
+    }
+    EXPECT_EQ(0u, shared.get_ref_count());
+    EXPECT_FALSE(imu.is_on());
+}
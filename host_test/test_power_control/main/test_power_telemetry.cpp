@@ -0,0 +1,253 @@
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "sdkconfig.h"
+
+#if CONFIG_POWER_CONTROL_TELEMETRY
+
+#include "fake_timer_hal.hpp"
+#include "power_control.hpp"
+#include "power_telemetry.hpp"
+#include "recording_gpio_hal.hpp"
+
+using namespace power_control;
+
+class PowerTelemetryTest : public ::testing::Test
+{
+protected:
+    RecordingGpioHAL hal;
+    FakeTimerHAL fake_timer;
+    PowerTelemetrySnapshot snap = {};
+
+    void SetUp() override { PowerTelemetry::set_timer(&fake_timer); }
+
+    void TearDown() override { PowerTelemetry::set_timer(nullptr); }
+
+    /// Entry of @p gpio in the last snapshot, or nullptr
+    const PowerTelemetryRail *find(gpio_num_t gpio) const
+    {
+        for (uint32_t i = 0; i < snap.rail_count; i++) {
+            if (snap.rails[i].gpio == gpio) {
+                return &snap.rails[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+TEST_F(PowerTelemetryTest, CountsTransitionsAndOnTime)
+{
+    PowerControl pc(hal, fake_timer, GPIO_NUM_4, true);
+    PowerControl other(hal, fake_timer, GPIO_NUM_5);
+    ASSERT_EQ(ESP_OK, pc.init());
+    ASSERT_EQ(ESP_OK, other.init());
+
+    fake_timer.now_us = 1000;
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+    fake_timer.now_us = 6000;
+    ASSERT_EQ(ESP_OK, pc.turn_off());
+    fake_timer.now_us = 10000;
+    ASSERT_EQ(ESP_OK, pc.turn_on_from_isr());
+    fake_timer.now_us = 12000;
+
+    ASSERT_EQ(2u, PowerTelemetry::snapshot(snap));
+    EXPECT_EQ(12000, snap.time_us);
+    const PowerTelemetryRail *r = find(GPIO_NUM_4);
+    ASSERT_NE(nullptr, r);
+    EXPECT_EQ(1, r->on); // Logical state, not the (inverted) level
+    EXPECT_EQ(2u, r->on_count);
+    EXPECT_EQ(1u, r->off_count);
+    EXPECT_EQ(7000u, r->on_time_us); // Includes the current period
+    EXPECT_EQ(PowerFault::NONE, r->fault);
+
+    r = find(GPIO_NUM_5);
+    ASSERT_NE(nullptr, r);
+    EXPECT_EQ(0, r->on);
+    EXPECT_EQ(0u, r->on_count);
+    EXPECT_EQ(0u, r->on_time_us);
+
+    // deinit() closes the ON period; the slot is kept until destruction
+    fake_timer.now_us = 15000;
+    ASSERT_EQ(ESP_OK, pc.deinit());
+    fake_timer.now_us = 20000;
+    ASSERT_EQ(2u, PowerTelemetry::snapshot(snap));
+    r = find(GPIO_NUM_4);
+    ASSERT_NE(nullptr, r);
+    EXPECT_EQ(0, r->on);
+    EXPECT_EQ(2u, r->off_count);
+    EXPECT_EQ(10000u, r->on_time_us);
+}
+
+TEST_F(PowerTelemetryTest, BulkAndWarmInitAreCovered)
+{
+    PowerControl a(hal, fake_timer, GPIO_NUM_4, false, true);
+    PowerControl b(hal, fake_timer, GPIO_NUM_5);
+    PowerControl *const rails[] = {&a, &b};
+    ASSERT_EQ(ESP_OK, PowerControl::init_all(rails));
+
+    PowerControl kept(hal, fake_timer, GPIO_NUM_6);
+    ASSERT_EQ(ESP_OK, kept.warm_init(true));
+
+    fake_timer.now_us = 3000;
+    ASSERT_EQ(3u, PowerTelemetry::snapshot(snap));
+    ASSERT_NE(nullptr, find(GPIO_NUM_4));
+    EXPECT_EQ(1u, find(GPIO_NUM_4)->on_count);
+    EXPECT_EQ(3000u, find(GPIO_NUM_4)->on_time_us);
+    ASSERT_NE(nullptr, find(GPIO_NUM_5));
+    EXPECT_EQ(0, find(GPIO_NUM_5)->on);
+    ASSERT_NE(nullptr, find(GPIO_NUM_6));
+    EXPECT_EQ(1, find(GPIO_NUM_6)->on);
+}
+
+TEST_F(PowerTelemetryTest, SlotsAreReleasedOnDestruction)
+{
+    std::unique_ptr<PowerControl> rails[PowerTelemetry::MAX_RAILS];
+    for (size_t i = 0; i < PowerTelemetry::MAX_RAILS; i++) {
+        rails[i] = std::make_unique<PowerControl>(hal, static_cast<gpio_num_t>(i));
+        ASSERT_EQ(ESP_OK, rails[i]->init());
+    }
+
+    // Table full: the rail still works, it is only not covered
+    PowerControl extra(hal, GPIO_NUM_20);
+    ASSERT_EQ(ESP_OK, extra.init());
+    ASSERT_EQ(ESP_OK, extra.turn_on());
+    EXPECT_EQ(PowerTelemetry::MAX_RAILS, PowerTelemetry::snapshot(snap));
+    EXPECT_EQ(nullptr, find(GPIO_NUM_20));
+
+    rails[0].reset();
+    EXPECT_EQ(PowerTelemetry::MAX_RAILS - 1, PowerTelemetry::snapshot(snap));
+    EXPECT_EQ(nullptr, find(GPIO_NUM_0));
+
+    PowerControl late(hal, GPIO_NUM_21);
+    ASSERT_EQ(ESP_OK, late.init());
+    EXPECT_EQ(PowerTelemetry::MAX_RAILS, PowerTelemetry::snapshot(snap));
+    ASSERT_NE(nullptr, find(GPIO_NUM_21));
+    EXPECT_EQ(0u, find(GPIO_NUM_21)->on_count); // Counters of the previous owner are gone
+}
+
+TEST_F(PowerTelemetryTest, SerializesToAFixedLittleEndianFrame)
+{
+    snap.time_us = 0x0102030405060708;
+    snap.rail_count = 2;
+    snap.rails[0] = {0x1122334455667788, 0xAABBCCDD, 0xAABBCCDC, 4, 1, PowerFault::OVERCURRENT};
+    snap.rails[1] = {0, 0, 0, 5, 0, PowerFault::NONE};
+
+    uint8_t frame[PowerTelemetry::MAX_FRAME_SIZE];
+    const size_t len = PowerTelemetry::serialize(snap, frame, sizeof(frame));
+    ASSERT_EQ(PowerTelemetry::FRAME_HEADER_SIZE + 2 * PowerTelemetry::FRAME_RAIL_SIZE, len);
+
+    const uint8_t header[] = {PowerTelemetry::FRAME_VERSION, 2, 0, 0, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01};
+    const uint8_t rail[] = {4, 0x21, 0xDD, 0xCC, 0xBB, 0xAA, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11};
+    EXPECT_EQ(0, memcmp(header, frame, sizeof(header)));
+    EXPECT_EQ(0, memcmp(rail, frame + PowerTelemetry::FRAME_HEADER_SIZE, sizeof(rail)));
+
+    PowerTelemetrySnapshot decoded = {};
+    ASSERT_EQ(ESP_OK, PowerTelemetry::deserialize(frame, len, decoded));
+    EXPECT_EQ(snap.time_us, decoded.time_us);
+    ASSERT_EQ(2u, decoded.rail_count);
+    EXPECT_EQ(snap.rails[0].on_time_us, decoded.rails[0].on_time_us);
+    EXPECT_EQ(snap.rails[0].on_count, decoded.rails[0].on_count);
+    EXPECT_EQ(snap.rails[0].off_count, decoded.rails[0].off_count);
+    EXPECT_EQ(1, decoded.rails[0].on);
+    EXPECT_EQ(PowerFault::OVERCURRENT, decoded.rails[0].fault);
+    EXPECT_EQ(5, decoded.rails[1].gpio);
+
+    // Too small, truncated or unknown frames are refused
+    EXPECT_EQ(0u, PowerTelemetry::serialize(snap, frame, len - 1));
+    EXPECT_EQ(ESP_ERR_INVALID_SIZE, PowerTelemetry::deserialize(frame, len - 1, decoded));
+    EXPECT_EQ(ESP_ERR_INVALID_SIZE, PowerTelemetry::deserialize(frame, 3, decoded));
+    frame[0] = PowerTelemetry::FRAME_VERSION + 1;
+    EXPECT_EQ(ESP_ERR_INVALID_VERSION, PowerTelemetry::deserialize(frame, len, decoded));
+}
+
+/// Timer whose next read, taken by record() inside its write section, runs a nested writer
+class NestingTimerHAL : public FakeTimerHAL
+{
+public:
+    int64_t get_time_us() override
+    {
+        if (slot != PowerTelemetry::NO_SLOT) {
+            const uint8_t nested = slot;
+            slot = PowerTelemetry::NO_SLOT;
+            PowerTelemetry::record_fault(nested, PowerFault::OVERCURRENT); // Fault ISR on top of record()
+            PowerTelemetry::record(nested, false);                         // and its cut
+        }
+        return now_us;
+    }
+
+    uint8_t slot = PowerTelemetry::NO_SLOT;
+};
+
+TEST_F(PowerTelemetryTest, NestedWritersAreNotLost)
+{
+    NestingTimerHAL nesting_timer;
+    PowerTelemetry::set_timer(&nesting_timer);
+    const uint8_t slot = PowerTelemetry::attach(GPIO_NUM_4);
+    ASSERT_NE(PowerTelemetry::NO_SLOT, slot);
+
+    nesting_timer.now_us = 1000;
+    nesting_timer.slot = slot;
+    PowerTelemetry::record(slot, true);
+
+    // The cut posted inside the write section is applied once the outer writer is done
+    nesting_timer.now_us = 2000;
+    ASSERT_EQ(1u, PowerTelemetry::snapshot(snap));
+    EXPECT_EQ(0, snap.rails[0].on);
+    EXPECT_EQ(1u, snap.rails[0].on_count);
+    EXPECT_EQ(1u, snap.rails[0].off_count);
+    EXPECT_EQ(0u, snap.rails[0].on_time_us);
+    EXPECT_EQ(PowerFault::OVERCURRENT, snap.rails[0].fault);
+
+    // The slot is free again for the next writer
+    PowerTelemetry::record(slot, true);
+    nesting_timer.now_us = 2500;
+    ASSERT_EQ(1u, PowerTelemetry::snapshot(snap));
+    EXPECT_EQ(1, snap.rails[0].on);
+    EXPECT_EQ(2u, snap.rails[0].on_count);
+    EXPECT_EQ(500u, snap.rails[0].on_time_us);
+    PowerTelemetry::detach(slot);
+}
+
+TEST_F(PowerTelemetryTest, ReaderDoesNotBlockAWriter)
+{
+    PowerTelemetry::set_timer(nullptr); // FakeTimerHAL is not thread-safe
+    const uint8_t slot = PowerTelemetry::attach(GPIO_NUM_4);
+    ASSERT_NE(PowerTelemetry::NO_SLOT, slot);
+
+    constexpr uint32_t CYCLES = 20000;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint32_t i = 0; i < CYCLES; i++) {
+            PowerTelemetry::record(slot, true);
+            PowerTelemetry::record_fault(slot, (i & 1) != 0 ? PowerFault::FAULT_INPUT : PowerFault::NONE);
+            PowerTelemetry::record(slot, false);
+        }
+        done.store(true);
+    });
+
+    // Every copy is a state the writer actually went through
+    uint32_t last_count = 0;
+    while (!done.load()) {
+        if (PowerTelemetry::snapshot(snap) == 0) {
+            continue; // Slot busy on every attempt
+        }
+        const PowerTelemetryRail &r = snap.rails[0];
+        EXPECT_EQ(GPIO_NUM_4, r.gpio);
+        EXPECT_GE(r.on_count, last_count);
+        EXPECT_EQ(r.on_count - r.on, r.off_count);
+        last_count = r.on_count;
+    }
+    writer.join();
+
+    ASSERT_EQ(1u, PowerTelemetry::snapshot(snap));
+    EXPECT_EQ(CYCLES, snap.rails[0].on_count);
+    EXPECT_EQ(CYCLES, snap.rails[0].off_count);
+    EXPECT_EQ(PowerFault::FAULT_INPUT, snap.rails[0].fault);
+    PowerTelemetry::detach(slot);
+}
+
+#endif // CONFIG_POWER_CONTROL_TELEMETRY
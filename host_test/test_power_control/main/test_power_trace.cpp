@@ -0,0 +1,129 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "sdkconfig.h"
+
+#if CONFIG_POWER_CONTROL_TRACE
+
+#include "fake_timer_hal.hpp"
+#include "mock_gpio_hal.hpp"
+#include "power_control.hpp"
+#include "power_trace.hpp"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace power_control;
+
+class PowerTraceTest : public ::testing::Test
+{
+protected:
+    NiceMock<MockGpioHAL> mock_gpio;
+    FakeTimerHAL fake_timer;
+    PowerTraceRecord records[PowerTrace::DEPTH];
+
+    void SetUp() override
+    {
+        ON_CALL(mock_gpio, reset_pin(_)).WillByDefault(Return(ESP_OK));
+        ON_CALL(mock_gpio, config(_)).WillByDefault(Return(ESP_OK));
+        ON_CALL(mock_gpio, set_level(_, _)).WillByDefault(Return(ESP_OK));
+        PowerTrace::set_timer(&fake_timer);
+        PowerTrace::clear();
+    }
+
+    void TearDown() override { PowerTrace::set_timer(nullptr); }
+};
+
+TEST_F(PowerTraceTest, RecordsEachWriteWithTimestamp)
+{
+    PowerControl pc(mock_gpio, GPIO_NUM_4, true, false);
+    ASSERT_EQ(ESP_OK, pc.init());
+
+    fake_timer.now_us = 1000;
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+    fake_timer.now_us = 2500;
+    ASSERT_EQ(ESP_OK, pc.turn_off());
+
+    ASSERT_EQ(3u, PowerTrace::snapshot(records, PowerTrace::DEPTH));
+    EXPECT_EQ(0u, records[0].index); // Initial state from init()
+    EXPECT_EQ(0, records[0].on);
+
+    EXPECT_EQ(1u, records[1].index);
+    EXPECT_EQ(1000, records[1].time_us);
+    EXPECT_EQ(GPIO_NUM_4, records[1].gpio);
+    EXPECT_EQ(1, records[1].on); // Logical state, not the (inverted) level
+    EXPECT_EQ(ESP_OK, records[1].result);
+    EXPECT_EQ(0, records[1].core);
+
+    EXPECT_EQ(2500, records[2].time_us);
+    EXPECT_EQ(0, records[2].on);
+}
+
+TEST_F(PowerTraceTest, RecordsFailedWrites)
+{
+    PowerControl pc(mock_gpio, GPIO_NUM_5);
+    ASSERT_EQ(ESP_OK, pc.init());
+    PowerTrace::clear();
+
+    EXPECT_CALL(mock_gpio, set_level(GPIO_NUM_5, true)).WillOnce(Return(ESP_FAIL));
+    EXPECT_EQ(ESP_FAIL, pc.turn_on());
+
+    ASSERT_EQ(1u, PowerTrace::snapshot(records, PowerTrace::DEPTH));
+    EXPECT_EQ(1, records[0].on);
+    EXPECT_EQ(ESP_FAIL, records[0].result);
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(PowerTraceTest, SkippedIdempotentWritesAreNotRecorded)
+{
+    PowerControl pc(mock_gpio, GPIO_NUM_4);
+    pc.set_idempotent(true);
+    ASSERT_EQ(ESP_OK, pc.init());
+    PowerTrace::clear();
+
+    ASSERT_EQ(ESP_OK, pc.turn_off()); // Already OFF
+    EXPECT_EQ(0u, PowerTrace::get_total());
+}
+
+#if CONFIG_POWER_CONTROL_ISR_API
+TEST_F(PowerTraceTest, RecordsIsrWrites)
+{
+    PowerControl pc(mock_gpio, GPIO_NUM_4);
+    ASSERT_EQ(ESP_OK, pc.init());
+    PowerTrace::clear();
+
+    ASSERT_EQ(ESP_OK, pc.turn_on_from_isr());
+
+    ASSERT_EQ(1u, PowerTrace::snapshot(records, PowerTrace::DEPTH));
+    EXPECT_EQ(1, records[0].on);
+}
+#endif
+
+TEST_F(PowerTraceTest, WrapAroundKeepsNewestRecords)
+{
+    const uint32_t total = PowerTrace::DEPTH + 5;
+    for (uint32_t i = 0; i < total; i++) {
+        fake_timer.now_us = i;
+        PowerTrace::record(GPIO_NUM_4, (i & 1) != 0, ESP_OK);
+    }
+
+    EXPECT_EQ(total, PowerTrace::get_total());
+    ASSERT_EQ(PowerTrace::DEPTH, PowerTrace::snapshot(records, PowerTrace::DEPTH));
+    for (size_t i = 0; i < PowerTrace::DEPTH; i++) {
+        EXPECT_EQ(5 + i, records[i].index); // Oldest first
+        EXPECT_EQ(static_cast<int64_t>(5 + i), records[i].time_us);
+    }
+}
+
+TEST_F(PowerTraceTest, SnapshotIsLimitedByCapacity)
+{
+    for (int i = 0; i < 4; i++) {
+        PowerTrace::record(GPIO_NUM_4, true, ESP_OK);
+    }
+    ASSERT_EQ(2u, PowerTrace::snapshot(records, 2));
+    EXPECT_EQ(0u, records[0].index);
+    EXPECT_EQ(1u, records[1].index);
+}
+
+#endif // CONFIG_POWER_CONTROL_TRACE
@@ -0,0 +1,174 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "fake_timer_hal.hpp"
+#include "mock_gpio_hal.hpp"
+#include "mock_ledc_hal.hpp"
+#include "ramped_power_control.hpp"
+
+using ::testing::_;
+using ::testing::Field;
+using ::testing::InSequence;
+using ::testing::Invoke;
+using ::testing::Return;
+
+using namespace power_control;
+
+class RampedPowerControlTest : public ::testing::Test
+{
+protected:
+    MockGpioHAL mock_gpio;
+    MockLedcHAL mock_ledc;
+    FakeTimerHAL fake_timer;
+    const gpio_num_t TEST_PIN = GPIO_NUM_4;
+
+    void init_rail(RampedPowerControl &pc, bool off_level = false)
+    {
+        EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, set_level(TEST_PIN, off_level)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+        ASSERT_EQ(ESP_OK, pc.init());
+        ::testing::Mock::VerifyAndClearExpectations(&mock_gpio);
+    }
+};
+
+TEST_F(RampedPowerControlTest, TurnOn_RampsThenHandsBackToGpio)
+{
+    RampedPowerControl pc(mock_gpio, mock_ledc, fake_timer, TEST_PIN, false, false, 20);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_ledc, start_ramp(TEST_PIN, false, 20u)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(pc.is_on());
+    EXPECT_TRUE(pc.is_ramping());
+    EXPECT_EQ(ESP_OK, pc.turn_on()); // Already ramping: no second ramp
+
+    fake_timer.advance(19999);
+    EXPECT_TRUE(pc.is_ramping());
+
+    {
+        // Output register loaded before the pin leaves the PWM channel
+        InSequence s;
+        EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, config(Field(&gpio_config_t::pin_bit_mask, 1ULL << TEST_PIN)))
+            .WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_ledc, stop(TEST_PIN)).WillOnce(Return(ESP_OK));
+    }
+    fake_timer.advance(1);
+    EXPECT_FALSE(pc.is_ramping());
+    EXPECT_TRUE(pc.is_on());
+
+    // Once handed back, OFF is a plain GPIO write
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(RampedPowerControlTest, TurnOff_AbortsRamp)
+{
+    RampedPowerControl pc(mock_gpio, mock_ledc, fake_timer, TEST_PIN, true, false, 10); // Active LOW
+    init_rail(pc, true);
+
+    EXPECT_CALL(mock_ledc, start_ramp(TEST_PIN, true, 10u)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK)); // OFF level
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_ledc, stop(TEST_PIN)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_FALSE(pc.is_ramping());
+
+    // The aborted hand-off never fires
+    fake_timer.advance(10000);
+}
+
+TEST_F(RampedPowerControlTest, TurnOff_DuringHandOffLeavesRailOff)
+{
+    RampedPowerControl pc(mock_gpio, mock_ledc, fake_timer, TEST_PIN, false, false, 10);
+    init_rail(pc);
+    EXPECT_CALL(mock_ledc, start_ramp(_, _, _)).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+
+    {
+        // A task turns the rail OFF while the timer callback writes the ON level
+        InSequence s;
+        EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Invoke([&](gpio_num_t, bool) {
+            EXPECT_EQ(ESP_OK, pc.turn_off()); // Hand-off already claimed: plain write
+            return ESP_OK;
+        }));
+        EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_ledc, stop(TEST_PIN)).WillOnce(Return(ESP_OK));
+        // The callback sees the OFF request and drives the OFF level last
+        EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+        EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    }
+    fake_timer.advance(10000);
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_FALSE(pc.is_ramping());
+}
+
+TEST_F(RampedPowerControlTest, InitialOn_StartsRampFromInit)
+{
+    RampedPowerControl pc(mock_gpio, mock_ledc, fake_timer, TEST_PIN, false, true, 5);
+
+    EXPECT_CALL(mock_ledc, start_ramp(TEST_PIN, false, 5u)).WillOnce(Return(ESP_OK));
+    init_rail(pc);
+    EXPECT_TRUE(pc.is_on());
+    EXPECT_TRUE(pc.is_ramping());
+}
+
+TEST_F(RampedPowerControlTest, ZeroRampTime_SwitchesInstantly)
+{
+    RampedPowerControl pc(mock_gpio, mock_ledc, fake_timer, TEST_PIN, false, false, 0);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_ledc, start_ramp(_, _, _)).Times(0);
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, true)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.toggle());
+    EXPECT_TRUE(pc.is_on());
+    EXPECT_FALSE(pc.is_ramping());
+}
+
+TEST_F(RampedPowerControlTest, RampFailure_LeavesRailOff)
+{
+    RampedPowerControl pc(mock_gpio, mock_ledc, fake_timer, TEST_PIN);
+    init_rail(pc);
+
+    EXPECT_CALL(mock_ledc, start_ramp(_, _, _)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_ledc, stop(TEST_PIN)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.turn_on());
+    EXPECT_FALSE(pc.is_on());
+    EXPECT_FALSE(pc.is_ramping());
+}
+
+TEST_F(RampedPowerControlTest, NotInitialized_Fails)
+{
+    RampedPowerControl pc(mock_gpio, mock_ledc, fake_timer, TEST_PIN);
+
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_off());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.set_drive_capability(GPIO_DRIVE_CAP_3));
+    EXPECT_EQ(ESP_OK, pc.deinit());
+}
+
+TEST_F(RampedPowerControlTest, Deinit_DuringRampForcesPinLow)
+{
+    RampedPowerControl pc(mock_gpio, mock_ledc, fake_timer, TEST_PIN);
+    init_rail(pc);
+    EXPECT_CALL(mock_ledc, start_ramp(_, _, _)).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, pc.turn_on());
+
+    EXPECT_CALL(mock_gpio, set_level(TEST_PIN, false)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_ledc, stop(TEST_PIN)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, reset_pin(TEST_PIN)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.deinit());
+    EXPECT_FALSE(pc.is_initialized());
+    EXPECT_FALSE(pc.is_ramping());
+}
@@ -0,0 +1,145 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "fake_timer_hal.hpp"
+#include "mock_power_control.hpp"
+#include "shared_power_control.hpp"
+
+using ::testing::Return;
+
+using namespace power_control;
+
+class SharedPowerControlTest : public ::testing::Test
+{
+protected:
+    MockPowerControl mock_rail;
+    FakeTimerHAL fake_timer;
+};
+
+TEST_F(SharedPowerControlTest, FirstAcquireTurnsOn_LastReleaseTurnsOff)
+{
+    SharedPowerControl shared(mock_rail);
+
+    EXPECT_CALL(mock_rail, turn_on()).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, shared.acquire());
+    EXPECT_EQ(ESP_OK, shared.acquire());
+    EXPECT_EQ(ESP_OK, shared.acquire());
+    EXPECT_EQ(3u, shared.get_ref_count());
+    EXPECT_TRUE(shared.is_on());
+
+    // Only the last release switches the rail
+    EXPECT_EQ(ESP_OK, shared.release());
+    EXPECT_EQ(ESP_OK, shared.release());
+    EXPECT_CALL(mock_rail, turn_off()).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, shared.release());
+
+    EXPECT_EQ(0u, shared.get_ref_count());
+    EXPECT_FALSE(shared.is_on());
+}
+
+TEST_F(SharedPowerControlTest, Release_WithoutAcquireFails)
+{
+    SharedPowerControl shared(mock_rail);
+
+    EXPECT_CALL(mock_rail, turn_off()).Times(0);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, shared.release());
+}
+
+TEST_F(SharedPowerControlTest, Acquire_FailsWhenRailFails)
+{
+    SharedPowerControl shared(mock_rail);
+
+    EXPECT_CALL(mock_rail, turn_on()).WillOnce(Return(ESP_ERR_INVALID_STATE)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, shared.acquire());
+    EXPECT_EQ(0u, shared.get_ref_count()); // No reference taken
+    EXPECT_FALSE(shared.is_on());
+
+    // Next acquire retries the switch
+    EXPECT_EQ(ESP_OK, shared.acquire());
+    EXPECT_TRUE(shared.is_on());
+
+    EXPECT_CALL(mock_rail, turn_off()).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, shared.release());
+}
+
+TEST_F(SharedPowerControlTest, Release_TurnOffFailureRetriedByNextLastRelease)
+{
+    SharedPowerControl shared(mock_rail);
+
+    EXPECT_CALL(mock_rail, turn_on()).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, shared.acquire());
+
+    EXPECT_CALL(mock_rail, turn_off()).WillOnce(Return(ESP_FAIL)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_FAIL, shared.release());
+    EXPECT_EQ(0u, shared.get_ref_count());
+    EXPECT_TRUE(shared.is_on()); // Rail still ON
+
+    // Rail is still ON: acquire does not switch it again
+    EXPECT_EQ(ESP_OK, shared.acquire());
+    EXPECT_EQ(ESP_OK, shared.release());
+    EXPECT_FALSE(shared.is_on());
+}
+
+TEST_F(SharedPowerControlTest, Linger_KeepsRailOnUntilTimerExpires)
+{
+    SharedPowerControl shared(mock_rail, fake_timer, 1000);
+    EXPECT_EQ(1000u, shared.get_linger_us());
+
+    EXPECT_CALL(mock_rail, turn_on()).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, shared.acquire());
+
+    EXPECT_CALL(mock_rail, turn_off()).Times(0);
+    EXPECT_EQ(ESP_OK, shared.release());
+    EXPECT_TRUE(shared.is_on());
+    fake_timer.advance(999);
+    EXPECT_TRUE(shared.is_on());
+
+    EXPECT_CALL(mock_rail, turn_off()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1);
+    EXPECT_FALSE(shared.is_on());
+}
+
+TEST_F(SharedPowerControlTest, Linger_ReacquireSkipsPowerCycle)
+{
+    SharedPowerControl shared(mock_rail, fake_timer, 1000);
+
+    // One power cycle for two back-to-back readers
+    EXPECT_CALL(mock_rail, turn_on()).Times(1).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, shared.acquire());
+    ASSERT_EQ(ESP_OK, shared.release());
+
+    fake_timer.advance(600);
+    ASSERT_EQ(ESP_OK, shared.acquire());
+    fake_timer.advance(600); // First linger window has passed while held
+    EXPECT_TRUE(shared.is_on());
+    ASSERT_EQ(ESP_OK, shared.release());
+
+    // Release restarted the window
+    fake_timer.advance(999);
+    EXPECT_TRUE(shared.is_on());
+    EXPECT_CALL(mock_rail, turn_off()).WillOnce(Return(ESP_OK));
+    fake_timer.advance(1);
+    EXPECT_FALSE(shared.is_on());
+}
+
+TEST_F(SharedPowerControlTest, Linger_TimerCreateFailure)
+{
+    SharedPowerControl shared(mock_rail, fake_timer, 1000);
+    fake_timer.fail_create = true;
+
+    EXPECT_CALL(mock_rail, turn_on()).Times(0);
+    EXPECT_EQ(ESP_ERR_NO_MEM, shared.acquire());
+    EXPECT_EQ(0u, shared.get_ref_count());
+}
+
+TEST_F(SharedPowerControlTest, Destructor_TurnsOffLingeringRail)
+{
+    EXPECT_CALL(mock_rail, turn_on()).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_rail, turn_off()).WillOnce(Return(ESP_OK));
+    {
+        SharedPowerControl shared(mock_rail, fake_timer, 1000);
+        ASSERT_EQ(ESP_OK, shared.acquire());
+        ASSERT_EQ(ESP_OK, shared.release());
+    }
+    EXPECT_TRUE(fake_timer.timers[0].deleted);
+}
@@ -0,0 +1,170 @@
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "fake_timer_hal.hpp"
+#include "power_control.hpp"
+#include "power_scheduler.hpp"
+#include "sim_gpio_hal.hpp"
+
+using namespace power_control;
+
+class SimGpioHALTest : public ::testing::Test
+{
+protected:
+    FakeTimerHAL clock;
+    SimGpioHAL sim{clock};
+
+    static constexpr int64_t MS = 1000;
+    static constexpr int64_t HOUR = 3600LL * 1000 * MS;
+};
+
+TEST_F(SimGpioHALTest, ModelsPadsLikeTheChip)
+{
+    const gpio_num_t pin = GPIO_NUM_4;
+
+    // Not an output yet: the register is written, the pad stays LOW
+    ASSERT_EQ(ESP_OK, sim.set_level(pin, true));
+    EXPECT_FALSE(sim.level(pin));
+
+    gpio_config_t io_conf = {};
+    io_conf.mode = GPIO_MODE_INPUT_OUTPUT;
+    io_conf.pin_bit_mask = 1ULL << pin;
+    ASSERT_EQ(ESP_OK, sim.config(io_conf));
+    EXPECT_TRUE(sim.level(pin));
+    bool level = false;
+    ASSERT_EQ(ESP_OK, sim.get_level(pin, level));
+    EXPECT_TRUE(level);
+
+    // A held pad ignores writes until the hold is released
+    ASSERT_EQ(ESP_OK, sim.set_hold(pin, true));
+    ASSERT_EQ(ESP_OK, sim.set_level(pin, false));
+    EXPECT_TRUE(sim.level(pin));
+    ASSERT_EQ(ESP_OK, sim.set_hold(pin, false));
+    EXPECT_FALSE(sim.level(pin));
+
+    ASSERT_EQ(ESP_OK, sim.set_drive_capability(pin, GPIO_DRIVE_CAP_0));
+    EXPECT_EQ(GPIO_DRIVE_CAP_0, sim.pins[pin].drive);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, sim.set_drive_capability(pin, GPIO_DRIVE_CAP_MAX));
+
+    // Reset state
+    ASSERT_EQ(ESP_OK, sim.set_level(pin, true));
+    ASSERT_EQ(ESP_OK, sim.set_hold(pin, true));
+    ASSERT_EQ(ESP_OK, sim.reset_pin(pin));
+    EXPECT_FALSE(sim.level(pin));
+    EXPECT_FALSE(sim.pins[pin].held);
+    EXPECT_FALSE(sim.pins[pin].output);
+    EXPECT_EQ(GPIO_DRIVE_CAP_2, sim.pins[pin].drive);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, sim.set_level(GPIO_NUM_NC, true));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, sim.set_levels_mask(1ULL << pin, 1ULL << pin));
+}
+
+TEST_F(SimGpioHALTest, EdgesAndHighTimeFollowTheVirtualClock)
+{
+    PowerControl rail(sim, clock, GPIO_NUM_4);
+    PowerControl inverted(sim, clock, GPIO_NUM_5, true);
+    ASSERT_EQ(ESP_OK, rail.init());
+    ASSERT_EQ(ESP_OK, inverted.init());
+    EXPECT_TRUE(sim.level(GPIO_NUM_5)); // Active LOW rail OFF: pad HIGH
+
+    ASSERT_EQ(ESP_OK, rail.pulse(5 * MS));
+    clock.advance(2 * MS);
+    EXPECT_TRUE(sim.level(GPIO_NUM_4));
+    EXPECT_EQ(2 * MS, sim.high_time_us(GPIO_NUM_4)); // Includes the current period
+    clock.advance(10 * MS);
+    EXPECT_FALSE(rail.is_on());
+    EXPECT_EQ(5 * MS, sim.high_time_us(GPIO_NUM_4));
+    EXPECT_EQ(2u, sim.edges(GPIO_NUM_4));
+
+    // Settle time elapses on the same clock
+    ASSERT_EQ(ESP_OK, inverted.set_settle_time_us(20 * MS));
+    ASSERT_EQ(ESP_OK, inverted.turn_on());
+    EXPECT_FALSE(sim.level(GPIO_NUM_5));
+    EXPECT_FALSE(inverted.is_ready());
+    clock.advance(20 * MS);
+    EXPECT_TRUE(inverted.is_ready());
+}
+
+TEST_F(SimGpioHALTest, ThousandHoursOfDutyCycling)
+{
+    PowerControl probe(sim, clock, GPIO_NUM_4);
+    PowerControl air(sim, clock, GPIO_NUM_5);
+    PowerControl modem(sim, clock, GPIO_NUM_6);
+    PowerControl *const rails[] = {&probe, &air, &modem};
+    ASSERT_EQ(ESP_OK, PowerControl::init_all(rails));
+
+    const PowerSchedule table[] = {
+        PowerSchedule::every(probe, 60000 * MS, 200 * MS),         // 200 ms every minute
+        PowerSchedule::every(air, 10000 * MS, 50 * MS, 5000 * MS), // 50 ms every 10 s, 5 s late
+        PowerSchedule::every(modem, 900000 * MS, 30000 * MS),      // 30 s every 15 min
+    };
+    PowerScheduler scheduler(clock, table);
+    ASSERT_EQ(ESP_OK, scheduler.start());
+
+    // Just short of the cycles that would start at 1000 h
+    clock.advance(1000 * HOUR - MS);
+    EXPECT_EQ(0u, scheduler.get_error_count());
+
+    // 60000 probe, 360000 air and 4000 modem cycles, all completed
+    EXPECT_EQ(60000 * 200 * MS, sim.high_time_us(GPIO_NUM_4));
+    EXPECT_EQ(360000 * 50 * MS, sim.high_time_us(GPIO_NUM_5));
+    EXPECT_EQ(4000 * 30000 * MS, sim.high_time_us(GPIO_NUM_6));
+    EXPECT_EQ(2u * 60000, sim.edges(GPIO_NUM_4));
+    EXPECT_EQ(2u * 360000, sim.edges(GPIO_NUM_5));
+    EXPECT_EQ(2u * 4000, sim.edges(GPIO_NUM_6));
+
+#if CONFIG_POWER_CONTROL_STATS
+    // The rail's own accounting agrees with the pads
+    EXPECT_EQ(static_cast<uint64_t>(sim.high_time_us(GPIO_NUM_5)), air.get_stats().on_time_us);
+    EXPECT_EQ(360000u, air.get_stats().on_count);
+#endif
+    EXPECT_EQ(ESP_OK, scheduler.stop());
+}
+
+TEST_F(SimGpioHALTest, HeldRailSurvivesDeepSleep)
+{
+    {
+        PowerControl kept(sim, clock, GPIO_NUM_4);
+        PowerControl dropped(sim, clock, GPIO_NUM_5);
+        ASSERT_EQ(ESP_OK, kept.init());
+        ASSERT_EQ(ESP_OK, dropped.init());
+        ASSERT_EQ(ESP_OK, kept.turn_on());
+        ASSERT_EQ(ESP_OK, dropped.turn_on());
+        ASSERT_EQ(ESP_OK, kept.hold_for_sleep(true));
+        sim.deep_sleep(60000 * MS);
+    }
+    EXPECT_TRUE(sim.level(GPIO_NUM_4));
+    EXPECT_FALSE(sim.level(GPIO_NUM_5));
+    EXPECT_EQ(60000 * MS, sim.high_time_us(GPIO_NUM_4));
+
+    // After the wake-up: adopted from the pad without a glitch
+    PowerControl kept(sim, clock, GPIO_NUM_4);
+    ASSERT_EQ(ESP_OK, kept.warm_init());
+    EXPECT_TRUE(kept.is_on());
+    EXPECT_TRUE(kept.is_ready());
+    EXPECT_FALSE(sim.pins[GPIO_NUM_4].held);
+    EXPECT_TRUE(sim.level(GPIO_NUM_4));
+    EXPECT_EQ(1u, sim.edges(GPIO_NUM_4)); // Only the original turn-on
+
+    // Without the deep-sleep hold, the pad is lost too
+    ASSERT_EQ(ESP_OK, sim.set_hold(GPIO_NUM_4, true));
+    sim.deep_sleep_hold = false;
+    sim.deep_sleep(1000 * MS);
+    EXPECT_FALSE(sim.level(GPIO_NUM_4));
+}
+
+TEST_F(SimGpioHALTest, InjectedFailuresLeaveTheRailUnchanged)
+{
+    PowerControl rail(sim, clock, GPIO_NUM_4);
+    ASSERT_EQ(ESP_OK, rail.init());
+
+    sim.fail_mask = 1ULL << GPIO_NUM_4;
+    sim.fail_error = ESP_ERR_TIMEOUT;
+    EXPECT_EQ(ESP_ERR_TIMEOUT, rail.turn_on());
+    EXPECT_FALSE(rail.is_on());
+    EXPECT_FALSE(sim.level(GPIO_NUM_4));
+    EXPECT_EQ(0u, sim.edges(GPIO_NUM_4));
+}
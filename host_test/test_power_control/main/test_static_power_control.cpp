@@ -0,0 +1,127 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "driver/gpio.h"
+
+#include "mock_gpio_hal.hpp"
+#include "static_power_control.hpp"
+
+using ::testing::_;
+using ::testing::Field;
+using ::testing::Return;
+
+using namespace power_control;
+
+class StaticPowerControlTest : public ::testing::Test
+{
+protected:
+    MockGpioHAL mock_gpio;
+    static constexpr uint64_t PIN_4 = 1ULL << GPIO_NUM_4;
+};
+
+using NormalRail = StaticPowerControl<GPIO_NUM_4, false, MockGpioHAL>;
+using InvertedRail = StaticPowerControl<GPIO_NUM_4, true, MockGpioHAL>;
+
+// Masks and pin are available as compile-time constants
+static_assert(NormalRail::ON_SET_MASK == (1ULL << GPIO_NUM_4), "normal logic sets the pin for ON");
+static_assert(NormalRail::ON_CLEAR_MASK == 0, "normal logic clears nothing for ON");
+static_assert(InvertedRail::ON_SET_MASK == 0, "inverted logic sets nothing for ON");
+static_assert(InvertedRail::ON_CLEAR_MASK == (1ULL << GPIO_NUM_4), "inverted logic clears the pin for ON");
+static_assert(NormalRail::get_pin() == GPIO_NUM_4, "pin is a constant expression");
+
+TEST_F(StaticPowerControlTest, NormalLogic_InitTurnOnTurnOff)
+{
+    NormalRail pc(mock_gpio);
+
+    EXPECT_CALL(mock_gpio, reset_pin(GPIO_NUM_4)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(Field(&gpio_config_t::pin_bit_mask, PIN_4))).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, PIN_4)).WillOnce(Return(ESP_OK)); // initial_on = false
+
+    EXPECT_EQ(ESP_OK, pc.init());
+    EXPECT_TRUE(pc.is_initialized());
+    EXPECT_FALSE(pc.is_on());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_4, 0)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_on());
+    EXPECT_TRUE(pc.is_on());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, PIN_4)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.turn_off());
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(StaticPowerControlTest, InvertedLogic_Toggle)
+{
+    InvertedRail pc(mock_gpio, true);
+
+    EXPECT_CALL(mock_gpio, reset_pin(GPIO_NUM_4)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, PIN_4)).WillOnce(Return(ESP_OK)); // initial ON = LOW
+
+    EXPECT_EQ(ESP_OK, pc.init());
+    EXPECT_TRUE(pc.is_on());
+
+    // Toggle: ON -> OFF (physical HIGH)
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_4, 0)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.toggle());
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(StaticPowerControlTest, Operations_FailWhenNotInitialized)
+{
+    NormalRail pc(mock_gpio);
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(_, _)).Times(0);
+    EXPECT_CALL(mock_gpio, set_drive_capability(_, _)).Times(0);
+
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_on());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.turn_off());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.toggle());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, pc.set_drive_capability(GPIO_DRIVE_CAP_1));
+    EXPECT_EQ(ESP_OK, pc.deinit());
+}
+
+TEST_F(StaticPowerControlTest, Init_FailsWhenResetPinFails)
+{
+    NormalRail pc(mock_gpio);
+
+    EXPECT_CALL(mock_gpio, reset_pin(GPIO_NUM_4)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_CALL(mock_gpio, config(_)).Times(0);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.init());
+    EXPECT_FALSE(pc.is_initialized());
+}
+
+TEST_F(StaticPowerControlTest, TurnOn_FailsWhenHalFails)
+{
+    NormalRail pc(mock_gpio);
+
+    EXPECT_CALL(mock_gpio, reset_pin(GPIO_NUM_4)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, PIN_4)).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, pc.init());
+
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_4, 0)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.turn_on());
+    EXPECT_FALSE(pc.is_on());
+}
+
+TEST_F(StaticPowerControlTest, SetDriveCapability_And_Deinit)
+{
+    NormalRail pc(mock_gpio, true);
+
+    EXPECT_CALL(mock_gpio, reset_pin(GPIO_NUM_4)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, config(_)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_gpio, set_levels_mask(PIN_4, 0)).WillOnce(Return(ESP_OK));
+    ASSERT_EQ(ESP_OK, pc.init());
+
+    EXPECT_CALL(mock_gpio, set_drive_capability(GPIO_NUM_4, GPIO_DRIVE_CAP_0)).WillOnce(Return(ESP_OK));
+    EXPECT_EQ(ESP_OK, pc.set_drive_capability(GPIO_DRIVE_CAP_0));
+
+    // Deinit forces LOW, then resets; first error is reported
+    EXPECT_CALL(mock_gpio, set_levels_mask(0, PIN_4)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_CALL(mock_gpio, reset_pin(GPIO_NUM_4)).WillOnce(Return(ESP_ERR_INVALID_STATE));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pc.deinit());
+    EXPECT_FALSE(pc.is_initialized());
+    EXPECT_FALSE(pc.is_on());
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "sdkconfig.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "soc/soc_caps.h"
+#endif
+
+#if CONFIG_POWER_CONTROL_PROTECTION && !CONFIG_IDF_TARGET_LINUX && SOC_ADC_DMA_SUPPORTED
+
+#include "esp_adc/adc_continuous.h"
+
+#include "i_fault_sense_hal.hpp"
+
+namespace power_control {
+/**
+ * @class AdcFaultSense
+ * @brief IFaultSenseHAL comparing a current-sense voltage with a threshold
+ *
+ * Samples one ADC channel in continuous mode: the ADC writes conversions to
+ * memory by DMA, and the conversion-done interrupt checks each frame of
+ * FRAME_SAMPLES samples against the threshold. No task polls the ADC; the
+ * detection latency is one frame, e.g. 100 µs at 80 kHz.
+ *
+ * The threshold is in raw ADC counts of the sense signal (the IS/sense output
+ * of a smart high-side switch, or a shunt amplifier): raw = V_trip / V_fullscale
+ * x (2^bit_width - 1) for the chosen attenuation.
+ *
+ * @note The ADC unit is used exclusively in continuous mode while started.
+ *       ESP32 supports ADC_UNIT_1 only.
+ * @note Available when CONFIG_POWER_CONTROL_PROTECTION is enabled, on chips with ADC DMA
+ * @internal
+ */
+class AdcFaultSense final : public IFaultSenseHAL
+{
+public:
+    /// Samples per conversion frame, i.e. per check of the threshold
+    static constexpr uint32_t FRAME_SAMPLES = 8;
+
+    /**
+     * @param unit ADC unit of the sense channel
+     * @param channel Sense channel
+     * @param threshold_raw Sample value above which the overcurrent is reported
+     * @param sample_freq_hz Conversion rate
+     * @param atten Input attenuation
+     */
+    AdcFaultSense(
+        adc_unit_t unit,
+        adc_channel_t channel,
+        uint32_t threshold_raw,
+        uint32_t sample_freq_hz = SOC_ADC_SAMPLE_FREQ_THRES_HIGH,
+        adc_atten_t atten = ADC_ATTEN_DB_12)
+        : unit_(unit)
+        , channel_(channel)
+        , threshold_raw_(threshold_raw)
+        , sample_freq_hz_(sample_freq_hz)
+        , atten_(atten)
+    {
+    }
+
+    ~AdcFaultSense() override { stop(); }
+
+    /**
+     * @copydoc IFaultSenseHAL::start()
+     *
+     * @return ESP_ERR_INVALID_STATE: already started
+     * @return Other: error codes propagated from the ADC continuous driver
+     */
+    esp_err_t start(fault_isr_t handler, void *arg) override;
+
+    /** @copydoc IFaultSenseHAL::stop() */
+    esp_err_t stop() override;
+
+    /** @copydoc IFaultSenseHAL::is_fault_active() */
+    bool is_fault_active() override { return get_last_raw() > threshold_raw_; }
+
+    /** @copydoc IFaultSenseHAL::get_kind() */
+    PowerFault get_kind() const override { return PowerFault::OVERCURRENT; }
+
+    /**
+     * @brief Highest sample of the last conversion frame
+     */
+    uint32_t get_last_raw() const { return last_raw_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief Conversion-done interrupt: check the frame against the threshold
+     */
+    static bool conv_done(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *user_data);
+
+    adc_unit_t unit_;         ///< ADC unit
+    adc_channel_t channel_;   ///< Sense channel
+    uint32_t threshold_raw_;  ///< Overcurrent threshold, raw counts
+    uint32_t sample_freq_hz_; ///< Conversion rate
+    adc_atten_t atten_;       ///< Input attenuation
+
+    adc_continuous_handle_t handle_ = nullptr; ///< Continuous-mode driver while started
+    fault_isr_t handler_ = nullptr;            ///< Fault handler while started
+    void *arg_ = nullptr;                      ///< Argument of the handler
+    std::atomic<uint32_t> last_raw_{0};        ///< Peak of the last frame
+};
+} // namespace power_control
+
+#endif
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "i_gpio_hal.hpp"
+#include "i_power_control.hpp"
+
+// ========================================
+// Concurrent Power Control Implementation
+// ========================================
+
+namespace power_control {
+/**
+ * @class ConcurrentPowerControl
+ * @brief Thread-safe IPowerControl implementation without a mutex on the hot path
+ *
+ * Same behavior as PowerControl, but turn_on(), turn_off() and toggle() may be
+ * called concurrently from any task on either core. The logical state is a
+ * `std::atomic<bool>` updated with exchange/compare-and-swap, and the pin is driven
+ * through IGpioHAL::set_levels_mask(), which GpioHAL and FastGpioHAL implement as
+ * a single store to the W1TS or W1TC register. That store cannot corrupt other pins
+ * of the bank, so no read-modify-write of the output register is involved.
+ *
+ * When two calls race, the state update and the register write of one call may be
+ * interleaved with the other's. Each call therefore re-reads the state after its
+ * write and writes again until the pin matches the latest state, so the output
+ * always converges to the state of the last call.
+ *
+ * init() and deinit() are serialized through an atomic lifecycle flag: a call made
+ * while another one is in progress returns ESP_ERR_INVALID_STATE.
+ *
+ * @note Timed features (settle time, turn_on_async) are only available in PowerControl.
+ * @warning Switching calls still in flight while deinit() runs may drive the pin
+ *          after it was forced low; stop the users of the rail before deinit().
+ * @see PowerControl for the single-task implementation
+ */
+class ConcurrentPowerControl : public IPowerControl
+{
+public:
+    /**
+     * @brief Construct a new Concurrent Power Control instance
+     *
+     * @param hal Reference to the HAL implementation for hardware access
+     * @param gpio GPIO pin number to control
+     * @param inverted_logic true = active LOW, false = active HIGH
+     * @param initial_on Initial logical state after init()
+     *
+     * @note The component is not initialized until init() is called
+     * @warning The GPIO pin must support output mode on the target hardware
+     */
+    ConcurrentPowerControl(
+        IGpioHAL &hal,
+        const gpio_num_t gpio,
+        const bool inverted_logic = false,
+        const bool initial_on = false);
+
+    /**
+     * @copydoc IPowerControl::init()
+     *
+     * @return ESP_ERR_INVALID_STATE: init() or deinit() already in progress
+     */
+    esp_err_t init() override;
+
+    /**
+     * @copydoc IPowerControl::deinit()
+     *
+     * @return ESP_ERR_INVALID_STATE: init() or deinit() already in progress
+     */
+    esp_err_t deinit() override;
+
+    /// @copydoc IPowerControl::set_drive_capability()
+    esp_err_t set_drive_capability(gpio_drive_cap_t strength) override;
+
+    /// @copydoc IPowerControl::turn_on()
+    esp_err_t turn_on() override;
+
+    /// @copydoc IPowerControl::turn_off()
+    esp_err_t turn_off() override;
+
+    /// @copydoc IPowerControl::toggle()
+    esp_err_t toggle() override;
+
+    /// @copydoc IPowerControl::is_on()
+    bool is_on() const override { return is_on_.load(std::memory_order_acquire); }
+
+    /// @copydoc IPowerControl::is_initialized()
+    bool is_initialized() const override { return lifecycle_.load(std::memory_order_acquire) == READY; }
+
+    /// @copydoc IPowerControl::get_pin()
+    gpio_num_t get_pin() const override { return gpio_; }
+
+private:
+    /// Lifecycle states
+    enum Lifecycle : uint8_t
+    {
+        UNINITIALIZED, ///< Not initialized
+        BUSY,          ///< init() or deinit() in progress
+        READY,         ///< Initialized
+    };
+
+    /**
+     * @brief Publish a new logical state and drive the pin until it matches the latest one
+     *
+     * @param previous State replaced by @p enable, restored if the HAL fails
+     * @param enable State just stored in is_on_
+     */
+    esp_err_t converge(bool previous, bool enable);
+
+    /**
+     * @brief Write one logical state to the pin with a single set/clear store
+     */
+    esp_err_t write_level(bool enable)
+    {
+        return enable ? hal_.set_levels_mask(on_set_mask_, on_clear_mask_)
+                      : hal_.set_levels_mask(on_clear_mask_, on_set_mask_);
+    }
+
+    IGpioHAL &hal_;       ///< HAL instance for hardware access
+    gpio_num_t gpio_;     ///< GPIO pin number
+    bool inverted_logic_; ///< true = active LOW, false = active HIGH
+    bool initial_on_;     ///< Initial state to apply after init
+
+    uint64_t on_set_mask_;   ///< W1TS mask for ON
+    uint64_t on_clear_mask_; ///< W1TC mask for ON
+
+    std::atomic<uint8_t> lifecycle_{UNINITIALIZED}; ///< Lifecycle state
+    std::atomic<bool> is_on_{false};                ///< Current logical state
+};
+} // namespace power_control
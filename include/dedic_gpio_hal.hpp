@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sdkconfig.h"
+
+#include "gpio_hal.hpp"
+#include "i_gpio_hal.hpp"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "soc/soc_caps.h"
+#endif
+
+#if !CONFIG_IDF_TARGET_LINUX && SOC_DEDICATED_GPIO_SUPPORTED
+#define POWER_CONTROL_DEDIC_GPIO 1
+#include "driver/dedic_gpio.h"
+#include "esp_cpu.h"
+#include "hal/dedic_gpio_cpu_ll.h"
+#else
+#define POWER_CONTROL_DEDIC_GPIO 0
+#endif
+
+namespace power_control {
+/**
+ * @class DedicGpioHAL
+ * @brief IGpioHAL that drives a bundle of up to 8 pins through the Dedicated GPIO peripheral
+ *
+ * On chips with Dedicated GPIO (ESP32-S2, S3, C3, C6, H2, ...), the bundle pins are
+ * routed to CPU output channels once config() has set them as outputs, and
+ * writes to them become a single CPU instruction instead of a store to the GPIO
+ * matrix registers. Pins outside the bundle, configuration calls and chips
+ * without the peripheral (ESP32, linux) go through GpioHAL.
+ *
+ * Combined with PowerGroup(DedicGpioHAL &, ...), whose channel masks are computed
+ * at construction, turn_on_all() and turn_off_all() reach the pads in a handful
+ * of cycles.
+ *
+ * @code
+ * const gpio_num_t bundle[] = {GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_6};
+ * DedicGpioHAL hal(bundle);
+ * PowerGroup sensors(hal, rails, 3);
+ * sensors.init();          // Creates the bundle on the calling core
+ * sensors.turn_on_all();   // One dedicated-GPIO write
+ * @endcode
+ *
+ * @note The bundle belongs to the CPU core that configured it. Writes to bundle
+ *       pins from the other core return ESP_ERR_INVALID_STATE; pin the switching
+ *       task to the core that called init().
+ * @note Bundle pins no longer follow the GPIO output registers. The writes that
+ *       PowerControl makes straight to those registers, i.e. the ISR API
+ *       (turn_on_from_isr()/turn_off_from_isr()) and the fault protection cut,
+ *       do not reach them: do not use either on a bundle pin.
+ * @note Creating the bundle allocates a small driver object (once per config()).
+ * @internal
+ */
+class DedicGpioHAL final : public IGpioHAL
+{
+public:
+    static constexpr size_t MAX_PINS = 8; ///< Largest bundle
+
+    /**
+     * @param pins Bundle pins; channel i of the bundle drives pins[i]
+     * @param count Number of pins (at most MAX_PINS); invalid lists leave the bundle empty
+     */
+    DedicGpioHAL(const gpio_num_t *pins, size_t count);
+
+    /**
+     * @brief Construct a bundle from an array of pins
+     */
+    template <size_t N>
+    explicit DedicGpioHAL(const gpio_num_t (&pins)[N])
+        : DedicGpioHAL(pins, N)
+    {
+        static_assert(N <= MAX_PINS, "A dedicated GPIO bundle has at most 8 pins");
+    }
+
+    ~DedicGpioHAL() override;
+
+    DedicGpioHAL(const DedicGpioHAL &) = delete;
+    DedicGpioHAL &operator=(const DedicGpioHAL &) = delete;
+
+    /**
+     * @copydoc IGpioHAL::reset_pin()
+     *
+     * Resetting a bundle pin releases the bundle; the next config() creates it again.
+     */
+    esp_err_t reset_pin(const gpio_num_t pin) override;
+
+    /** @copydoc reset_pin() */
+    esp_err_t reset_pins_mask(const uint64_t mask) override;
+
+    /**
+     * @copydoc IGpioHAL::config()
+     *
+     * When every bundle pin is configured as output, the bundle is created on the
+     * calling core and its channels are loaded with the levels the pads were
+     * driving, so a rail keeps its state across the switch to the bundle. Only the
+     * few cycles between the rerouting and that load see the previous channel
+     * levels; warm_init() holds the pads across config() and is not exposed.
+     */
+    esp_err_t config(const gpio_config_t &config) override;
+
+    /** @copydoc IGpioHAL::set_level() */
+    esp_err_t set_level(const gpio_num_t pin, const bool level) override;
+
+    /**
+     * @copydoc IGpioHAL::set_levels_mask()
+     *
+     * Bundle pins take one dedicated-GPIO write, the other pins one GpioHAL write.
+     *
+     * @return ESP_ERR_INVALID_STATE: bundle pins written from the wrong core
+     */
+    esp_err_t set_levels_mask(const uint64_t set_mask, const uint64_t clear_mask) override;
+
+    /** @copydoc IGpioHAL::set_drive_capability() */
+    esp_err_t set_drive_capability(gpio_num_t gpio_num, gpio_drive_cap_t strength) override
+    {
+        return gpio_hal_.set_drive_capability(gpio_num, strength);
+    }
+
+    /** @copydoc IGpioHAL::get_level() */
+    esp_err_t get_level(const gpio_num_t pin, bool &level) override { return gpio_hal_.get_level(pin, level); }
+
+    /** @copydoc GpioHAL::set_hold() */
+    esp_err_t set_hold(const gpio_num_t pin, bool enable) override { return gpio_hal_.set_hold(pin, enable); }
+
+    /** @copydoc GpioHAL::set_deep_sleep_hold() */
+    esp_err_t set_deep_sleep_hold(bool enable) override { return gpio_hal_.set_deep_sleep_hold(enable); }
+
+    /**
+     * @brief Convert a GPIO mask to bundle channels (bit i = pins[i])
+     *
+     * Pins outside the bundle are ignored.
+     */
+    uint32_t to_channels(uint64_t gpio_mask) const;
+
+    /**
+     * @brief Pins of the bundle (bit N = GPIO N)
+     */
+    uint64_t get_pin_mask() const { return pin_mask_; }
+
+    /**
+     * @brief Check whether the bundle pins are currently routed to the CPU channels
+     */
+    bool is_active() const
+    {
+#if POWER_CONTROL_DEDIC_GPIO
+        return bundle_ != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Write bundle channels directly (always inlined, usable from IRAM)
+     *
+     * @param mask Channels to write (bit i = pins[i])
+     * @param value New level of each channel in @p mask
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: bundle not active, or called from another core
+     */
+    inline __attribute__((always_inline)) esp_err_t write_channels(uint32_t mask, uint32_t value) const
+    {
+#if POWER_CONTROL_DEDIC_GPIO
+        if (bundle_ == nullptr || esp_cpu_get_core_id() != core_) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        dedic_gpio_cpu_ll_write_mask(mask << offset_, value << offset_);
+        return ESP_OK;
+#else
+        (void)mask;
+        (void)value;
+        return ESP_ERR_INVALID_STATE;
+#endif
+    }
+
+private:
+    /**
+     * @brief Release the bundle; its pins return to plain GPIO writes
+     */
+    void release_bundle();
+
+    GpioHAL gpio_hal_;           ///< Configuration and non-bundle pins
+    int pins_[MAX_PINS] = {};    ///< Bundle pins, by channel
+    size_t count_ = 0;           ///< Number of bundle pins
+    uint64_t pin_mask_ = 0;      ///< Bundle pins as a GPIO mask
+
+#if POWER_CONTROL_DEDIC_GPIO
+    dedic_gpio_bundle_handle_t bundle_ = nullptr; ///< Active bundle, or nullptr
+    uint32_t offset_ = 0;                         ///< First CPU output channel of the bundle
+    int core_ = 0;                                ///< Core that owns the bundle
+#endif
+};
+} // namespace power_control
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+
+#include "i_gpio_hal.hpp"
+#include "i_register_bus.hpp"
+
+// ========================================
+// IO Expander GPIO HAL
+// ========================================
+
+namespace power_control {
+/**
+ * @brief Register layout of a supported 16-bit IO expander
+ */
+enum class ExpanderChip : uint8_t
+{
+    TCA9555,  ///< TI TCA9555 / NXP PCA9555 (also PCA9535, TCA9535)
+    MCP23017, ///< Microchip MCP23017 / MCP23S17 with IOCON.BANK = 0 (power-on default)
+};
+
+/**
+ * @class ExpanderGpioHAL
+ * @brief IGpioHAL on the 16 pins of an I2C/SPI IO expander, with write coalescing
+ *
+ * Pin numbers are the expander pins: GPIO_NUM_0..GPIO_NUM_15 are P00..P17 on a
+ * TCA9555, GPA0..GPB7 on an MCP23017. The HAL keeps a shadow of the output and
+ * direction registers, so a level change never needs a read-modify-write on the
+ * bus, and writes both 8-bit ports with a single transaction.
+ *
+ * By default every call that changes the shadow is written out at once, which
+ * makes set_levels_mask() (used by PowerGroup, PowerProfileGroup and
+ * PowerRailTable) cost one bus write for any number of rails. Rails switched one
+ * by one, e.g. a burst of PowerControl::turn_on() calls, can be coalesced the same
+ * way between begin_batch() and end_batch(): the calls only update the shadow and
+ * end_batch() writes every pending change in one transaction.
+ *
+ * @code
+ * ExpanderGpioHAL expander(bus, ExpanderChip::TCA9555);
+ * expander.init();         // Reads the chip registers into the shadow
+ * PowerControl gps(expander, GPIO_NUM_3);
+ *
+ * expander.begin_batch();
+ * gps.turn_on();
+ * lna.turn_on();
+ * modem.turn_off();
+ * expander.end_batch();    // One I2C write for the three rails
+ * @endcode
+ *
+ * Outputs are always written before the direction register, so a pin switched to
+ * output starts at the level set for it.
+ *
+ * @note The expander has no drive-strength, pull or hold control:
+ *       set_drive_capability() and set_hold() return ESP_ERR_NOT_SUPPORTED and the
+ *       pull settings of config() are ignored.
+ * @note Expander rails cannot use the PowerControl ISR API.
+ * @note This implementation is not thread-safe. External synchronization is
+ *       required if used from multiple tasks.
+ */
+class ExpanderGpioHAL final : public IGpioHAL
+{
+public:
+    static constexpr int PIN_COUNT = 16; ///< Pins of the expander
+
+    /**
+     * @param bus Register access to the expander (I2cRegisterBus or a custom SPI bus)
+     * @param chip Register layout of the expander
+     */
+    ExpanderGpioHAL(IRegisterBus &bus, ExpanderChip chip);
+
+    /**
+     * @brief Load the shadow registers from the chip
+     *
+     * Must be called once before any other call.
+     *
+     * @return ESP_OK on success
+     * @return Other: error codes propagated from IRegisterBus::read_registers()
+     */
+    esp_err_t init();
+
+    /**
+     * @brief Defer bus writes until the matching end_batch()
+     *
+     * Batches nest; only the outermost end_batch() flushes.
+     */
+    void begin_batch() { batch_depth_++; }
+
+    /**
+     * @brief Close a batch opened by begin_batch(), flushing on the outermost one
+     *
+     * @return ESP_OK on success, or if an enclosing batch is still open
+     * @return ESP_ERR_INVALID_STATE: no batch open
+     * @return Other: error codes propagated from flush()
+     */
+    esp_err_t end_batch();
+
+    /**
+     * @brief Write every pending change to the chip now
+     *
+     * @return ESP_OK on success or if nothing is pending
+     * @return ESP_ERR_INVALID_STATE: init() not called
+     * @return Other: error codes propagated from IRegisterBus::write_registers();
+     *         the changes stay pending and are retried by the next flush
+     */
+    esp_err_t flush();
+
+    /**
+     * @brief Check whether changes are waiting for a flush
+     */
+    bool has_pending() const { return output_ != written_output_ || input_mask_ != written_input_mask_; }
+
+    /**
+     * @brief Output register shadow (bit N = pin N driven HIGH)
+     */
+    uint16_t get_output_shadow() const { return output_; }
+
+    /**
+     * @brief Direction register shadow (bit N = pin N is an input)
+     */
+    uint16_t get_input_mask() const { return input_mask_; }
+
+    /**
+     * @copydoc IGpioHAL::reset_pin()
+     *
+     * Switches the pin back to input (high impedance).
+     */
+    esp_err_t reset_pin(const gpio_num_t pin) override;
+
+    /**
+     * @copydoc IGpioHAL::reset_pins_mask()
+     *
+     * One shadow update and at most one flush for every pin.
+     */
+    esp_err_t reset_pins_mask(const uint64_t mask) override;
+
+    /**
+     * @copydoc IGpioHAL::config()
+     *
+     * Only the direction is applied: pins whose mode includes GPIO_MODE_OUTPUT
+     * become outputs, the others inputs.
+     */
+    esp_err_t config(const gpio_config_t &config) override;
+
+    /** @copydoc IGpioHAL::set_level() */
+    esp_err_t set_level(const gpio_num_t pin, bool level) override;
+
+    /**
+     * @copydoc IGpioHAL::set_levels_mask()
+     *
+     * One shadow update and at most one bus write for every pin in the masks.
+     */
+    esp_err_t set_levels_mask(const uint64_t set_mask, const uint64_t clear_mask) override;
+
+    /** @return ESP_ERR_NOT_SUPPORTED: the expander has fixed drive strength */
+    esp_err_t set_drive_capability(const gpio_num_t gpio_num, gpio_drive_cap_t strength) override;
+
+    /**
+     * @copydoc IGpioHAL::get_level()
+     *
+     * Reads the input port register, i.e. the pad level. An output pin with a
+     * level still pending in a batch reports the pending level.
+     */
+    esp_err_t get_level(const gpio_num_t pin, bool &level) override;
+
+private:
+    /// Register addresses of one chip; 16-bit registers are two consecutive 8-bit ports
+    struct Registers
+    {
+        uint8_t input;     ///< Input port (pad levels)
+        uint8_t output;    ///< Output latch
+        uint8_t direction; ///< Direction, 1 = input
+    };
+
+    static Registers registers_of(ExpanderChip chip);
+
+    /**
+     * @brief Validate a HAL mask and convert it to expander pins
+     *
+     * @return false if the mask has pins outside the expander
+     */
+    static bool to_pins(uint64_t mask, uint16_t &pins);
+
+    /**
+     * @brief Flush after a shadow change, unless a batch is open
+     *
+     * On failure outside a batch the shadow is restored to @p output / @p input_mask,
+     * so the failed call leaves no pending change behind.
+     */
+    esp_err_t commit(uint16_t output, uint16_t input_mask);
+
+    /**
+     * @brief Write a 16-bit register as two consecutive ports in one transaction
+     */
+    esp_err_t write16(uint8_t reg, uint16_t value);
+
+    IRegisterBus &bus_;   ///< Register access to the chip
+    Registers registers_; ///< Register map of the chip
+
+    bool initialized_ = false;             ///< init() succeeded
+    uint8_t batch_depth_ = 0;              ///< Nesting depth of begin_batch()
+    uint16_t output_ = 0;                  ///< Output register shadow
+    uint16_t input_mask_ = 0xFFFF;         ///< Direction register shadow (1 = input)
+    uint16_t written_output_ = 0;          ///< Output register as last written to the chip
+    uint16_t written_input_mask_ = 0xFFFF; ///< Direction register as last written to the chip
+};
+} // namespace power_control
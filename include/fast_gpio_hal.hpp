@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gpio_hal.hpp"
+#include "i_gpio_hal.hpp"
+
+namespace power_control {
+/**
+ * @class FastGpioHAL
+ * @brief IGpioHAL implementation that writes the GPIO output registers directly
+ *
+ * Configuration calls (reset_pin, config, set_drive_capability) go through the
+ * ESP-IDF driver as in GpioHAL. Once a pin has been configured as output through
+ * config(), set_level() and set_levels_mask() bypass gpio_set_level() and its
+ * argument checks and write `GPIO.out_w1ts`/`out_w1tc` through the `gpio_ll` layer.
+ * Both run from IRAM, but only direct calls on a FastGpioHAL (which the compiler
+ * devirtualizes, the class being final) stay usable while the flash cache is
+ * disabled; calls through an IGpioHAL reference, as PowerControl makes them, load
+ * the vtable from flash.
+ *
+ * The only check left on the fast path is a bit test against the set of pins this
+ * HAL configured, which rejects writes to pins that were never set up as outputs.
+ *
+ * @note Drop-in replacement for GpioHAL wherever an IGpioHAL is expected.
+ * @internal
+ */
+class FastGpioHAL final : public IGpioHAL
+{
+public:
+    FastGpioHAL() = default;
+    ~FastGpioHAL() override = default;
+
+    /** @copydoc IGpioHAL::reset_pin() */
+    esp_err_t reset_pin(const gpio_num_t pin) override;
+
+    /** @copydoc GpioHAL::reset_pins_mask() */
+    esp_err_t reset_pins_mask(const uint64_t mask) override;
+
+    /** @copydoc IGpioHAL::config() */
+    esp_err_t config(const gpio_config_t &config) override;
+
+    /**
+     * @copydoc IGpioHAL::set_level()
+     *
+     * @return ESP_ERR_INVALID_STATE: pin was not configured as output through this HAL
+     */
+    esp_err_t set_level(const gpio_num_t pin, const bool level) override;
+
+    /** @copydoc IGpioHAL::set_drive_capability() */
+    esp_err_t set_drive_capability(gpio_num_t gpio_num, gpio_drive_cap_t strength) override
+    {
+        return gpio_set_drive_capability(gpio_num, strength);
+    }
+
+    /**
+     * @copydoc IGpioHAL::set_levels_mask()
+     *
+     * @return ESP_ERR_INVALID_STATE: a pin in the masks was not configured as output
+     *         through this HAL
+     */
+    esp_err_t set_levels_mask(const uint64_t set_mask, const uint64_t clear_mask) override;
+
+    /** @copydoc IGpioHAL::get_level() */
+    esp_err_t get_level(const gpio_num_t pin, bool &level) override;
+
+    /** @copydoc GpioHAL::set_hold() */
+    esp_err_t set_hold(const gpio_num_t pin, bool enable) override
+    {
+        return enable ? gpio_hold_en(pin) : gpio_hold_dis(pin);
+    }
+
+    /** @copydoc GpioHAL::set_deep_sleep_hold() */
+    esp_err_t set_deep_sleep_hold(bool enable) override { return GpioHAL().set_deep_sleep_hold(enable); }
+
+    /**
+     * @brief Pins configured as output through this HAL
+     *
+     * @return uint64_t Bit N set = GPIO N can be driven through the fast path
+     */
+    uint64_t get_output_mask() const { return output_mask_; }
+
+private:
+    uint64_t output_mask_ = 0; ///< Pins configured as output by config()
+};
+} // namespace power_control
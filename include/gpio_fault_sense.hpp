@@ -0,0 +1,68 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+#if CONFIG_POWER_CONTROL_PROTECTION
+
+#include "driver/gpio.h"
+
+#include "i_fault_sense_hal.hpp"
+
+namespace power_control {
+/**
+ * @class GpioFaultSense
+ * @brief IFaultSenseHAL on the fault/sense output of a load switch
+ *
+ * Configures the pin as an input (with a pull-up for open-drain active-LOW
+ * outputs) and calls the fault handler from the GPIO interrupt on the edge
+ * that asserts the fault. The GPIO ISR service is installed with
+ * ESP_INTR_FLAG_IRAM if the application has not installed it already.
+ *
+ * @note Available when CONFIG_POWER_CONTROL_PROTECTION is enabled
+ * @internal
+ */
+class GpioFaultSense final : public IFaultSenseHAL
+{
+public:
+    /**
+     * @param gpio Fault input pin
+     * @param active_low true = the fault asserts the pin LOW (open-drain FAULT/nFLT outputs)
+     */
+    explicit GpioFaultSense(gpio_num_t gpio, bool active_low = true)
+        : gpio_(gpio)
+        , active_low_(active_low)
+    {
+    }
+
+    ~GpioFaultSense() override { stop(); }
+
+    /**
+     * @copydoc IFaultSenseHAL::start()
+     *
+     * @return ESP_ERR_INVALID_STATE: already started
+     */
+    esp_err_t start(fault_isr_t handler, void *arg) override;
+
+    /** @copydoc IFaultSenseHAL::stop() */
+    esp_err_t stop() override;
+
+    /** @copydoc IFaultSenseHAL::is_fault_active() */
+    bool is_fault_active() override { return (gpio_get_level(gpio_) == 0) == active_low_; }
+
+    /** @copydoc IFaultSenseHAL::get_kind() */
+    PowerFault get_kind() const override { return PowerFault::FAULT_INPUT; }
+
+private:
+    /**
+     * @brief GPIO interrupt handler, forwards to the fault handler
+     */
+    static void isr(void *arg);
+
+    gpio_num_t gpio_;               ///< Fault input pin
+    bool active_low_;               ///< Fault asserts the pin LOW
+    fault_isr_t handler_ = nullptr; ///< Fault handler while started
+    void *arg_ = nullptr;           ///< Argument of the handler
+};
+} // namespace power_control
+
+#endif
@@ -1,14 +1,28 @@
 #pragma once
 
+#include "sdkconfig.h"
+
 #include "i_gpio_hal.hpp"
 
+#if !CONFIG_IDF_TARGET_LINUX
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
+#include "soc/soc_caps.h"
+#endif
+
 namespace power_control {
 /**
  * @class GpioHAL
  * @brief Concrete implementation of IGpioHAL using ESP-IDF driver
+ *
+ * Declared `final` so that calls made through a GpioHAL reference (e.g. from
+ * StaticPowerControl) are devirtualized and inlined by the compiler.
+ *
+ * set_drive_capability_mask() keeps the per-pin default: the drive strength is a
+ * field of each pin's IO MUX register, with no bank-wide register to write.
  * @internal
  */
-class GpioHAL : public IGpioHAL
+class GpioHAL final : public IGpioHAL
 {
 public:
     GpioHAL() = default;
@@ -28,5 +42,115 @@ public:
     {
         return gpio_set_drive_capability(gpio_num, strength);
     }
+
+    /** @copydoc IGpioHAL::get_level() */
+    esp_err_t get_level(const gpio_num_t pin, bool &level) override
+    {
+        if (pin < 0 || pin >= GPIO_NUM_MAX) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        level = gpio_get_level(pin) != 0;
+        return ESP_OK;
+    }
+
+    /** @copydoc IGpioHAL::set_hold() */
+    esp_err_t set_hold(const gpio_num_t pin, bool enable) override
+    {
+        return enable ? gpio_hold_en(pin) : gpio_hold_dis(pin);
+    }
+
+    /**
+     * @copydoc IGpioHAL::set_deep_sleep_hold()
+     *
+     * On chips that hold single pins through deep sleep by themselves
+     * (SOC_GPIO_SUPPORT_HOLD_SINGLE_IO_IN_DSLP) this is a no-op.
+     */
+    esp_err_t set_deep_sleep_hold(bool enable) override
+    {
+#if !CONFIG_IDF_TARGET_LINUX && !SOC_GPIO_SUPPORT_HOLD_SINGLE_IO_IN_DSLP
+        enable ? gpio_deep_sleep_hold_en() : gpio_deep_sleep_hold_dis();
+#else
+        (void)enable;
+#endif
+        return ESP_OK;
+    }
+
+    /**
+     * @copydoc IGpioHAL::set_levels_mask()
+     *
+     * On hardware targets this is one store per register: W1TC, then W1TS, for each
+     * 32-pin bank. Pins sharing a register change together; cleared pins drop one
+     * store before set pins rise. The pins must already be configured as outputs.
+     */
+    esp_err_t set_levels_mask(const uint64_t set_mask, const uint64_t clear_mask) override
+    {
+        return write_levels_mask(set_mask, clear_mask);
+    }
+
+    /**
+     * @copydoc IGpioHAL::reset_pins_mask()
+     *
+     * One gpio_config() call with the state gpio_reset_pin() leaves a pin in (GPIO
+     * function, input and output disabled, pull-up enabled, no interrupt), so the
+     * configuration registers of all pins are walked once instead of once per pin.
+     */
+    esp_err_t reset_pins_mask(const uint64_t mask) override
+    {
+        if (mask == 0) {
+            return ESP_OK;
+        }
+        gpio_config_t io_conf = {};
+        io_conf.mode = GPIO_MODE_DISABLE;
+        io_conf.pin_bit_mask = mask;
+        io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+        io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+        io_conf.intr_type = GPIO_INTR_DISABLE;
+        return gpio_config(&io_conf);
+    }
+
+    /**
+     * @brief Register-level implementation of set_levels_mask()
+     *
+     * Always inlined, so it can be used from IRAM code (see FastGpioHAL) without
+     * calling into flash.
+     */
+    static inline __attribute__((always_inline)) esp_err_t write_levels_mask(
+        const uint64_t set_mask,
+        const uint64_t clear_mask)
+    {
+        if ((set_mask & clear_mask) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+#if CONFIG_IDF_TARGET_LINUX
+        for (int pin = 0; pin < GPIO_NUM_MAX; pin++) {
+            const uint64_t bit = 1ULL << pin;
+            if ((set_mask | clear_mask) & bit) {
+                esp_err_t ret = gpio_set_level(static_cast<gpio_num_t>(pin), (set_mask & bit) != 0);
+                if (ret != ESP_OK) {
+                    return ret;
+                }
+            }
+        }
+#else
+        if (((set_mask | clear_mask) & ~static_cast<uint64_t>(SOC_GPIO_VALID_OUTPUT_GPIO_MASK)) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (static_cast<uint32_t>(clear_mask) != 0) {
+            REG_WRITE(GPIO_OUT_W1TC_REG, static_cast<uint32_t>(clear_mask));
+        }
+        if (static_cast<uint32_t>(set_mask) != 0) {
+            REG_WRITE(GPIO_OUT_W1TS_REG, static_cast<uint32_t>(set_mask));
+        }
+#if SOC_GPIO_PIN_COUNT > 32
+        if ((clear_mask >> 32) != 0) {
+            REG_WRITE(GPIO_OUT1_W1TC_REG, static_cast<uint32_t>(clear_mask >> 32));
+        }
+        if ((set_mask >> 32) != 0) {
+            REG_WRITE(GPIO_OUT1_W1TS_REG, static_cast<uint32_t>(set_mask >> 32));
+        }
+#endif
+#endif
+        return ESP_OK;
+    }
 };
-} // namespace power_control
\ No newline at end of file
+} // namespace power_control
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+
+#include "driver/i2c_master.h"
+
+#include "i_register_bus.hpp"
+
+namespace power_control {
+/**
+ * @class I2cRegisterBus
+ * @brief Concrete implementation of IRegisterBus on an I2C master device
+ *
+ * The device (bus, address and SCL speed) is added by the application with
+ * i2c_master_bus_add_device(); this class only performs register transactions.
+ * @internal
+ */
+class I2cRegisterBus final : public IRegisterBus
+{
+public:
+    /// Largest write, in data bytes, done in one transaction
+    static constexpr size_t MAX_WRITE_LEN = 4;
+
+    /**
+     * @param device I2C device of the chip
+     * @param timeout_ms Transaction timeout (-1 = wait forever)
+     */
+    explicit I2cRegisterBus(i2c_master_dev_handle_t device, int timeout_ms = 50)
+        : device_(device)
+        , timeout_ms_(timeout_ms)
+    {
+    }
+
+    /**
+     * @copydoc IRegisterBus::write_registers()
+     *
+     * @return ESP_ERR_INVALID_SIZE: more than MAX_WRITE_LEN bytes
+     */
+    esp_err_t write_registers(uint8_t reg, const uint8_t *data, size_t len) override;
+
+    /** @copydoc IRegisterBus::read_registers() */
+    esp_err_t read_registers(uint8_t reg, uint8_t *data, size_t len) override;
+
+private:
+    i2c_master_dev_handle_t device_; ///< I2C device of the chip
+    int timeout_ms_;                 ///< Transaction timeout
+};
+} // namespace power_control
+
+#endif // !CONFIG_IDF_TARGET_LINUX
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstdint>
+
+#include "i_power_control.hpp"
+
+namespace power_control {
+
+/** @brief Fault handler, called from interrupt context by IFaultSenseHAL */
+using fault_isr_t = void (*)(void *arg);
+
+/**
+ * @interface IFaultSenseHAL
+ * @brief Hardware Abstraction Layer for a fault source that interrupts the CPU
+ *
+ * Used by PowerControl fault protection: the HAL calls the handler from its
+ * interrupt as soon as the fault is seen, and the handler cuts the rail there.
+ * @internal
+ */
+class IFaultSenseHAL
+{
+public:
+    virtual ~IFaultSenseHAL() = default;
+
+    /**
+     * @internal
+     * @brief Start monitoring; @p handler is called from ISR on every fault detection
+     *
+     * @note @p handler and @p arg must be in internal RAM (IRAM/DRAM)
+     */
+    virtual esp_err_t start(fault_isr_t handler, void *arg) = 0;
+
+    /**
+     * @internal
+     * @brief Stop monitoring; the handler is not called anymore once this returns
+     */
+    virtual esp_err_t stop() = 0;
+
+    /**
+     * @internal
+     * @brief Check whether the fault condition is present right now (task context)
+     */
+    virtual bool is_fault_active() = 0;
+
+    /**
+     * @internal
+     * @brief Kind of fault reported by this source
+     */
+    virtual PowerFault get_kind() const = 0;
+};
+} // namespace power_control
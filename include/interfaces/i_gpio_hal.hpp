@@ -1,6 +1,7 @@
 #pragma once
 
 #include "esp_err.h"
+#include <cstdint>
 #include "driver/gpio.h"
 
 namespace power_control {
@@ -25,5 +26,121 @@ public:
 
     /** @internal */
     virtual esp_err_t set_drive_capability(const gpio_num_t gpio_num, gpio_drive_cap_t strength) = 0;
+
+    /**
+     * @internal
+     * @brief Drive several output pins in one batched operation
+     *
+     * Bit N of each mask refers to GPIO N. Pins in @p set_mask are driven HIGH and
+     * pins in @p clear_mask are driven LOW; pins in neither mask are left untouched.
+     * A pin must not appear in both masks.
+     *
+     * The default implementation calls set_level() once per pin, so the pins change
+     * one after the other. HALs able to write a whole bank at once should override it.
+     *
+     * @return ESP_ERR_INVALID_ARG if a pin appears in both masks
+     */
+    virtual esp_err_t set_levels_mask(const uint64_t set_mask, const uint64_t clear_mask)
+    {
+        if ((set_mask & clear_mask) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        for (int pin = 0; pin < GPIO_NUM_MAX; pin++) {
+            const uint64_t bit = 1ULL << pin;
+            if (((set_mask | clear_mask) & bit) != 0) {
+                esp_err_t ret = set_level(static_cast<gpio_num_t>(pin), (set_mask & bit) != 0);
+                if (ret != ESP_OK) {
+                    return ret;
+                }
+            }
+        }
+        return ESP_OK;
+    }
+
+    /**
+     * @internal
+     * @brief Reset several pins to their default state in one batched operation
+     *
+     * Bit N of @p mask refers to GPIO N. The default implementation calls
+     * reset_pin() once per pin. As this is also used on teardown, every pin is
+     * reset even if an earlier one fails, and the first error is returned.
+     */
+    virtual esp_err_t reset_pins_mask(const uint64_t mask)
+    {
+        esp_err_t final_ret = ESP_OK;
+        for (int pin = 0; pin < GPIO_NUM_MAX; pin++) {
+            if ((mask & (1ULL << pin)) != 0) {
+                esp_err_t ret = reset_pin(static_cast<gpio_num_t>(pin));
+                if (ret != ESP_OK && final_ret == ESP_OK) {
+                    final_ret = ret; // Keep the first error but reset the other pins
+                }
+            }
+        }
+        return final_ret;
+    }
+
+    /**
+     * @internal
+     * @brief Set the drive capability of several pins in one batched operation
+     *
+     * Bit N of @p mask refers to GPIO N. The default implementation calls
+     * set_drive_capability() once per pin and stops at the first error.
+     */
+    virtual esp_err_t set_drive_capability_mask(const uint64_t mask, gpio_drive_cap_t strength)
+    {
+        for (int pin = 0; pin < GPIO_NUM_MAX; pin++) {
+            if ((mask & (1ULL << pin)) != 0) {
+                esp_err_t ret = set_drive_capability(static_cast<gpio_num_t>(pin), strength);
+                if (ret != ESP_OK) {
+                    return ret;
+                }
+            }
+        }
+        return ESP_OK;
+    }
+
+    /**
+     * @internal
+     * @brief Read the level present on a pin
+     *
+     * For an output pin this reads the pad back, which requires the input buffer
+     * to be enabled (GPIO_MODE_INPUT_OUTPUT, as configured by PowerControl::init()).
+     *
+     * @return ESP_ERR_NOT_SUPPORTED if the HAL cannot read pins back
+     */
+    virtual esp_err_t get_level(const gpio_num_t pin, bool &level)
+    {
+        (void)pin;
+        (void)level;
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /**
+     * @internal
+     * @brief Latch (or release) the current output level and configuration of a pin
+     *
+     * While held, writes to the pin do not reach the pad. The hold survives light
+     * sleep, and deep sleep together with set_deep_sleep_hold().
+     *
+     * @return ESP_ERR_NOT_SUPPORTED if the HAL cannot hold pins
+     */
+    virtual esp_err_t set_hold(const gpio_num_t pin, bool enable)
+    {
+        (void)pin;
+        (void)enable;
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /**
+     * @internal
+     * @brief Keep held digital pins latched during deep sleep (chip-wide)
+     *
+     * @return ESP_ERR_NOT_SUPPORTED if the HAL cannot hold pins
+     */
+    virtual esp_err_t set_deep_sleep_hold(bool enable)
+    {
+        (void)enable;
+        return ESP_ERR_NOT_SUPPORTED;
+    }
 };
 } // namespace power_control
\ No newline at end of file
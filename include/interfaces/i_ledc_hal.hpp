@@ -0,0 +1,41 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstdint>
+#include "driver/gpio.h"
+
+namespace power_control {
+/**
+ * @interface ILedcHAL
+ * @brief Hardware Abstraction Layer for a hardware PWM duty ramp
+ *
+ * Used by RampedPowerControl to soft-start a load. The ramp runs in the PWM
+ * peripheral; once started, no CPU work is needed until the pin is handed back
+ * to the GPIO matrix.
+ * @internal
+ */
+class ILedcHAL
+{
+public:
+    virtual ~ILedcHAL() = default;
+
+    /**
+     * @internal
+     * @brief Route @p gpio to the PWM channel at 0 % duty and fade to 100 % in hardware
+     *
+     * @param gpio Pin to drive
+     * @param inverted true = the ON level is LOW, so the PWM output is inverted
+     * @param ramp_time_ms Duration of the 0 to 100 % duty fade
+     */
+    virtual esp_err_t start_ramp(gpio_num_t gpio, bool inverted, uint32_t ramp_time_ms) = 0;
+
+    /**
+     * @internal
+     * @brief Stop the fade and the PWM channel driving @p gpio
+     *
+     * Called after the pin was routed back to GPIO, so the channel idle level no
+     * longer reaches the pin.
+     */
+    virtual esp_err_t stop(gpio_num_t gpio) = 0;
+};
+} // namespace power_control
@@ -9,6 +9,17 @@
 // ========================================
 
 namespace power_control {
+
+/**
+ * @brief Protection fault latched by a rail
+ */
+enum class PowerFault : uint8_t
+{
+    NONE,        ///< No fault latched
+    FAULT_INPUT, ///< Fault/sense output of the load switch asserted
+    OVERCURRENT, ///< Measured load current above the threshold
+};
+
 /**
  * @interface IPowerControl
  * @brief Interface for GPIO-based power/output control
@@ -185,5 +196,15 @@ public:
      * @note Returns the pin configured at construction, valid even before init()
      */
     virtual gpio_num_t get_pin() const = 0;
+
+    /**
+     * @brief Get the protection fault latched by the rail
+     *
+     * A latched fault means the rail was cut by its protection and cannot be
+     * turned ON until the fault is cleared (or retried automatically).
+     *
+     * @return PowerFault::NONE if no fault is latched, always for rails without protection
+     */
+    virtual PowerFault get_fault() const { return PowerFault::NONE; }
 };
 } // namespace power_control
\ No newline at end of file
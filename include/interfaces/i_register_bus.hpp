@@ -0,0 +1,34 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace power_control {
+/**
+ * @interface IRegisterBus
+ * @brief Register access to a peripheral chip over a serial bus (I2C, SPI)
+ *
+ * Used by ExpanderGpioHAL to read and write the registers of an IO expander.
+ * Each call is one bus transaction; multi-byte accesses rely on the chip's
+ * register address auto-increment.
+ * @internal
+ */
+class IRegisterBus
+{
+public:
+    virtual ~IRegisterBus() = default;
+
+    /**
+     * @internal
+     * @brief Write @p len bytes starting at register @p reg in one transaction
+     */
+    virtual esp_err_t write_registers(uint8_t reg, const uint8_t *data, size_t len) = 0;
+
+    /**
+     * @internal
+     * @brief Read @p len bytes starting at register @p reg in one transaction
+     */
+    virtual esp_err_t read_registers(uint8_t reg, uint8_t *data, size_t len) = 0;
+};
+} // namespace power_control
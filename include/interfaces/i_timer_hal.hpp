@@ -0,0 +1,71 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstdint>
+
+namespace power_control {
+
+/** @brief Opaque handle of a one-shot timer created through ITimerHAL */
+using timer_handle_t = void *;
+
+/** @brief Timer expiry callback */
+using timer_callback_t = void (*)(void *arg);
+
+/**
+ * @interface ITimerHAL
+ * @brief Hardware Abstraction Layer for time keeping and one-shot timers
+ *
+ * Used by the timed features (settle time, auto-off, sequencing, scheduling) so
+ * that they can run against esp_timer on target and against a virtual clock in
+ * host tests.
+ * @internal
+ */
+class ITimerHAL
+{
+public:
+    virtual ~ITimerHAL() = default;
+
+    /**
+     * @internal
+     * @brief Monotonic time in microseconds
+     */
+    virtual int64_t get_time_us() = 0;
+
+    /**
+     * @internal
+     * @brief Create a one-shot timer (not started)
+     */
+    virtual esp_err_t create(timer_callback_t callback, void *arg, timer_handle_t *out_handle) = 0;
+
+    /**
+     * @internal
+     * @brief Start a created timer; it fires once after @p timeout_us
+     * @note The timer must not be running
+     */
+    virtual esp_err_t start_once(timer_handle_t handle, uint64_t timeout_us) = 0;
+
+    /**
+     * @internal
+     * @brief Stop a timer; stopping a timer that is not running returns ESP_OK
+     */
+    virtual esp_err_t stop(timer_handle_t handle) = 0;
+
+    /**
+     * @internal
+     * @brief Delete a stopped timer
+     */
+    virtual esp_err_t remove(timer_handle_t handle) = 0;
+
+    /**
+     * @internal
+     * @brief Block the caller for at least @p us microseconds
+     * @note The default busy-waits on get_time_us()
+     */
+    virtual void delay_us(uint32_t us)
+    {
+        const int64_t deadline_us = get_time_us() + us;
+        while (get_time_us() < deadline_us) {
+        }
+    }
+};
+} // namespace power_control
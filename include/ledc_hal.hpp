@@ -0,0 +1,60 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+
+#include "driver/ledc.h"
+
+#include "i_ledc_hal.hpp"
+
+namespace power_control {
+/**
+ * @class LedcHAL
+ * @brief Concrete implementation of ILedcHAL using the LEDC peripheral
+ *
+ * Owns one LEDC channel and one LEDC timer, given at construction. The ramp uses
+ * the LEDC hardware fade; the fade service is installed on the first ramp.
+ *
+ * @note Several LedcHAL instances may share a timer if they use the same frequency.
+ * @internal
+ */
+class LedcHAL final : public ILedcHAL
+{
+public:
+    /**
+     * @param channel LEDC channel reserved for the ramp
+     * @param timer LEDC timer clocking the channel
+     * @param freq_hz PWM frequency; keep it within the gate driver's switching range
+     * @param speed_mode LEDC speed mode (only low speed exists on most targets)
+     */
+    explicit LedcHAL(
+        ledc_channel_t channel = LEDC_CHANNEL_0,
+        ledc_timer_t timer = LEDC_TIMER_0,
+        uint32_t freq_hz = 20000,
+        ledc_mode_t speed_mode = LEDC_LOW_SPEED_MODE)
+        : channel_(channel)
+        , timer_(timer)
+        , freq_hz_(freq_hz)
+        , speed_mode_(speed_mode)
+    {
+    }
+
+    /** @copydoc ILedcHAL::start_ramp() */
+    esp_err_t start_ramp(gpio_num_t gpio, bool inverted, uint32_t ramp_time_ms) override;
+
+    /** @copydoc ILedcHAL::stop() */
+    esp_err_t stop(gpio_num_t gpio) override;
+
+private:
+    static constexpr ledc_timer_bit_t DUTY_RESOLUTION = LEDC_TIMER_10_BIT;
+    static constexpr uint32_t FULL_DUTY = 1u << DUTY_RESOLUTION; ///< 100 % duty, output constantly active
+
+    ledc_channel_t channel_;
+    ledc_timer_t timer_;
+    uint32_t freq_hz_;
+    ledc_mode_t speed_mode_;
+};
+} // namespace power_control
+
+#endif // !CONFIG_IDF_TARGET_LINUX
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "i_power_control.hpp"
+#include "i_timer_hal.hpp"
+
+// ========================================
+// Current Budget Implementation
+// ========================================
+
+namespace power_control {
+
+class BudgetedRail;
+
+/**
+ * @class PowerBudget
+ * @brief Shared peak-current budget for a set of BudgetedRail
+ *
+ * Every BudgetedRail reserves its expected current before switching ON and gives
+ * it back when switching OFF. A turn-on that would exceed the budget is not
+ * rejected: the rail waits in a FIFO queue and is switched ON as soon as enough
+ * current is given back, in request order.
+ *
+ * The current in use is one atomic counter: when no rail is waiting, admission is
+ * a single compare-and-swap, lock-free and O(1), from any task on either core.
+ * The wait queue is an intrusive list guarded by a short spinlock, only taken
+ * when a request has to wait or when current is given back while rails wait.
+ *
+ * @code
+ * PowerBudget budget(timer, 500);                              // 500 mA supply
+ * BudgetedRail modem(budget, modem_rail, 400, 120, 2000);    // 400 mA for 2 ms, then 120 mA
+ * BudgetedRail heater(budget, heater_rail, 300, 300);
+ *
+ * modem.turn_on();   // Admitted
+ * heater.turn_on();  // Queued: admitted 2 ms later, when the modem inrush is over
+ * @endcode
+ *
+ * @note Queued rails are switched ON from the context that gives the current
+ *       back: a turn_off() caller or the timer context (esp_timer task with TimerHAL).
+ * @see BudgetedRail
+ */
+class PowerBudget
+{
+public:
+    /**
+     * @brief Construct a new Power Budget instance
+     *
+     * @param timer Timer HAL used to end the inrush period of the rails
+     * @param budget_ma Current the supply can deliver, in mA
+     */
+    PowerBudget(ITimerHAL &timer, uint32_t budget_ma);
+
+    PowerBudget(const PowerBudget &) = delete;
+    PowerBudget &operator=(const PowerBudget &) = delete;
+
+    /**
+     * @brief Total budget in mA
+     */
+    uint32_t get_budget_ma() const { return budget_ma_; }
+
+    /**
+     * @brief Current reserved by the rails that are ON, in mA
+     */
+    uint32_t get_used_ma() const { return used_ma_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Number of rails waiting for budget
+     */
+    uint32_t get_waiting_count() const { return waiting_.load(std::memory_order_acquire); }
+
+private:
+    friend class BudgetedRail;
+
+    /**
+     * @brief Reserve @p ma if it fits in the budget (single CAS loop)
+     */
+    bool try_reserve(uint32_t ma);
+
+    /**
+     * @brief Admit @p rail at once, or append it to the wait queue
+     *
+     * @return true if the rail was admitted and the caller must switch it ON
+     */
+    bool admit_or_enqueue(BudgetedRail &rail);
+
+    /**
+     * @brief Remove a waiting rail from the queue
+     *
+     * @return true if @p rail was still waiting
+     */
+    bool cancel(BudgetedRail &rail);
+
+    /**
+     * @brief Give @p ma back and admit the waiting rails that now fit
+     */
+    void release(uint32_t ma);
+
+    /**
+     * @brief Admit waiting rails in order while the head of the queue fits
+     */
+    void drain();
+
+    void lock();
+    void unlock() { queue_lock_.clear(std::memory_order_release); }
+
+    ITimerHAL &timer_;         ///< Timer HAL for the inrush periods
+    const uint32_t budget_ma_; ///< Total budget
+
+    std::atomic<uint32_t> used_ma_{0}; ///< Reserved current
+    std::atomic<uint32_t> waiting_{0}; ///< Queued rails
+
+    std::atomic_flag queue_lock_ = ATOMIC_FLAG_INIT; ///< Guards head_/tail_ and BudgetedRail::next_
+    BudgetedRail *head_ = nullptr;                   ///< First waiting rail
+    BudgetedRail *tail_ = nullptr;                   ///< Last waiting rail
+};
+
+/**
+ * @class BudgetedRail
+ * @brief IPowerControl wrapper that switches a rail ON only within a PowerBudget
+ *
+ * When switched ON the rail reserves its inrush current for @p inrush_us, then
+ * only its steady current. turn_on() returns ESP_OK both when the rail is
+ * switched at once and when it is queued; is_pending() tells the two apart, and
+ * is_on() reports the state of the wrapped rail.
+ *
+ * @note The wrapped rail must be initialized through this wrapper or before it
+ *       is used, and must not be switched directly.
+ * @note A BudgetedRail instance is not thread-safe; different rails of the same
+ *       budget may be switched from different tasks.
+ */
+class BudgetedRail : public IPowerControl
+{
+public:
+    /**
+     * @brief Construct a new Budgeted Rail instance
+     *
+     * @param budget Budget shared with the other rails of the supply
+     * @param rail Rail to switch; it must outlive this object
+     * @param inrush_ma Current drawn right after turn-on, in mA
+     * @param steady_ma Current drawn once the inrush is over, in mA
+     * @param inrush_us Duration of the inrush (0 = the inrush only has to fit at turn-on)
+     */
+    BudgetedRail(
+        PowerBudget &budget,
+        IPowerControl &rail,
+        uint32_t inrush_ma,
+        uint32_t steady_ma,
+        uint32_t inrush_us = 0);
+
+    ~BudgetedRail() override;
+
+    BudgetedRail(const BudgetedRail &) = delete;
+    BudgetedRail &operator=(const BudgetedRail &) = delete;
+
+    /// @copydoc IPowerControl::init()
+    esp_err_t init() override { return rail_.init(); }
+
+    /**
+     * @copydoc IPowerControl::deinit()
+     *
+     * A waiting request is dropped and the reserved current given back.
+     */
+    esp_err_t deinit() override;
+
+    /// @copydoc IPowerControl::set_drive_capability()
+    esp_err_t set_drive_capability(gpio_drive_cap_t strength) override { return rail_.set_drive_capability(strength); }
+
+    /**
+     * @brief Switch the rail ON, or queue it until the budget allows it
+     *
+     * @return ESP_OK if the rail was switched ON or queued (see is_pending())
+     * @return ESP_ERR_INVALID_STATE: the wrapped rail is not initialized
+     * @return ESP_ERR_INVALID_ARG: the rail alone exceeds the budget
+     * @return Other: error codes propagated from IPowerControl::turn_on()
+     */
+    esp_err_t turn_on() override;
+
+    /**
+     * @brief Switch the rail OFF (or drop a waiting request) and give its current back
+     *
+     * A request that another task is admitting at that moment is handed over:
+     * that task switches the rail back OFF and gives the current back.
+     *
+     * @return ESP_OK on success
+     * @return Other: error codes propagated from IPowerControl::turn_off(); the
+     *         current stays reserved
+     */
+    esp_err_t turn_off() override;
+
+    /// @copydoc IPowerControl::toggle()
+    esp_err_t toggle() override { return state_.load() == OFF ? turn_on() : turn_off(); }
+
+    /// @copydoc IPowerControl::is_on()
+    bool is_on() const override { return rail_.is_on(); }
+
+    /// @copydoc IPowerControl::is_initialized()
+    bool is_initialized() const override { return rail_.is_initialized(); }
+
+    /// @copydoc IPowerControl::get_pin()
+    gpio_num_t get_pin() const override { return rail_.get_pin(); }
+
+    /**
+     * @brief Check whether a turn_on() request waits for budget
+     */
+    bool is_pending() const { return state_.load(std::memory_order_acquire) == PENDING; }
+
+    /**
+     * @brief Current reserved by this rail, in mA
+     */
+    uint32_t get_reserved_ma() const { return reserved_ma_.load(std::memory_order_acquire); }
+
+private:
+    friend class PowerBudget;
+
+    /// Request states
+    enum State : uint8_t
+    {
+        OFF,       ///< No current reserved
+        PENDING,   ///< Queued for budget
+        ADMITTING, ///< Current reserved, rail being switched ON by admit()
+        ON,        ///< Current reserved, rail switched ON
+    };
+
+    /**
+     * @brief Peak current reserved at turn-on
+     */
+    uint32_t peak_ma() const { return inrush_ma_ > steady_ma_ ? inrush_ma_ : steady_ma_; }
+
+    /**
+     * @brief Take back a PENDING or ADMITTING request, leaving the state OFF
+     *
+     * PowerBudget::drain() claims a request with a PENDING -> ADMITTING CAS, and
+     * this with PENDING/ADMITTING -> OFF, so exactly one side owns it. A request
+     * taken back while ADMITTING is switched back OFF by admit().
+     *
+     * @return true if a request was taken back
+     */
+    bool withdraw();
+
+    /**
+     * @brief Switch the wrapped rail ON once its peak current is reserved (state ADMITTING)
+     */
+    esp_err_t admit();
+
+    /**
+     * @brief Inrush timer expiry handler
+     */
+    static void inrush_timer_cb(void *arg);
+
+    PowerBudget &budget_; ///< Shared budget
+    IPowerControl &rail_; ///< Wrapped rail
+    uint32_t inrush_ma_;  ///< Current right after turn-on
+    uint32_t steady_ma_;  ///< Current after the inrush
+    uint32_t inrush_us_;  ///< Duration of the inrush
+
+    timer_handle_t inrush_timer_ = nullptr; ///< One-shot timer ending the inrush, created on first use
+    std::atomic<uint32_t> reserved_ma_{0};  ///< Current reserved in the budget
+    std::atomic<State> state_{OFF};         ///< Request state
+    BudgetedRail *next_ = nullptr;          ///< Next waiting rail (guarded by the budget queue lock)
+};
+} // namespace power_control
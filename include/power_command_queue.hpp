@@ -0,0 +1,250 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "power_profile.hpp"
+
+// ========================================
+// Asynchronous Command Queue
+// ========================================
+
+namespace power_control {
+
+/**
+ * @brief Switching action carried by a queued command
+ */
+enum class PowerAction : uint8_t
+{
+    ON,     ///< Turn the rail ON
+    OFF,    ///< Turn the rail OFF
+    TOGGLE, ///< Invert the state the rail has at that point of the batch
+};
+
+/**
+ * @brief Completion callback of a queued command, called from the draining task
+ *
+ * @param result Result of the masked write that applied the command, or the
+ *        reason the command was dropped from the batch
+ * @param arg User argument given to post()
+ */
+using PowerCommandCallback = void (*)(esp_err_t result, void *arg);
+
+/**
+ * @class PowerCommandQueue
+ * @brief Offloads rail switching from time-critical tasks to one power task
+ *
+ * post() only stores the command in a bounded lock-free multi-producer ring and
+ * wakes the power task, so the caller pays neither for the HAL nor for logging.
+ * post_from_isr() does the same from an interrupt handler.
+ *
+ * The power task (start()) or any single task calling drain() takes every command
+ * queued so far, applies them in order to the current state of the rails and
+ * switches the result with one PowerProfileGroup::apply_profile(), i.e. one
+ * IGpioHAL::set_levels_mask() call for the whole batch. A rail switched ON and
+ * back OFF within one batch is not written at all.
+ *
+ * @code
+ * PowerControl *const rails[] = {&sensor, &modem, &heater};
+ * PowerProfileGroup group(rails);
+ * PowerCommandQueue queue(group);
+ * queue.start(5);
+ *
+ * // From any task or ISR
+ * queue.post(sensor.get_pin(), PowerAction::ON);
+ * queue.post(modem.get_pin(), PowerAction::OFF, xTaskGetCurrentTaskHandle());
+ * @endcode
+ *
+ * @note Commands name a rail by its GPIO, which must belong to the group.
+ * @note While the queue is in use, the rails of the group must only be switched
+ *       through it (or from the task that drains it).
+ * @note Completion callbacks and notifications run in the draining task. A command
+ *       for a rail that cannot be switched (not initialized, held for sleep, ON
+ *       for a rail latched OFF by a fault) is dropped from the batch with
+ *       ESP_ERR_INVALID_STATE; every other command completes with the result of
+ *       the batch write.
+ * @note At most CONFIG_POWER_CONTROL_COMMAND_QUEUE_DEPTH commands can be pending.
+ * @see PowerProfileGroup
+ */
+class PowerCommandQueue
+{
+public:
+    /// Maximum number of pending commands
+    static constexpr size_t DEPTH = CONFIG_POWER_CONTROL_COMMAND_QUEUE_DEPTH;
+    static_assert((DEPTH & (DEPTH - 1)) == 0, "CONFIG_POWER_CONTROL_COMMAND_QUEUE_DEPTH must be a power of two");
+
+    /**
+     * @brief Construct a command queue in front of @p group
+     *
+     * @param group Rails switched by the queue; it must outlive the queue
+     */
+    explicit PowerCommandQueue(PowerProfileGroup &group);
+
+    /**
+     * @brief Stop the power task, if running
+     */
+    ~PowerCommandQueue();
+
+    PowerCommandQueue(const PowerCommandQueue &) = delete;
+    PowerCommandQueue &operator=(const PowerCommandQueue &) = delete;
+
+    /**
+     * @brief Create the power task that drains the queue
+     *
+     * @param priority FreeRTOS priority of the power task
+     * @param stack_size Stack of the power task, in bytes; completion callbacks run on it
+     * @param core Core of the power task, or tskNO_AFFINITY
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: already running
+     * @return ESP_ERR_NO_MEM: the task could not be created
+     */
+    esp_err_t start(UBaseType_t priority, uint32_t stack_size = 3072, BaseType_t core = tskNO_AFFINITY);
+
+    /**
+     * @brief Apply the pending commands and delete the power task
+     *
+     * Blocks until the power task has exited. Commands posted from the moment
+     * stop() is called may stay queued until the next drain() or start().
+     *
+     * @return ESP_OK on success or if not running
+     *
+     * @note Do not call it from the power task (e.g. a completion callback).
+     */
+    esp_err_t stop();
+
+    /**
+     * @brief Check whether the power task is running
+     */
+    bool is_running() const { return task_.load(std::memory_order_acquire) != nullptr; }
+
+    /**
+     * @brief Queue a command, with an optional completion callback
+     *
+     * @param rail GPIO of a rail of the group
+     * @param action Switching action
+     * @param done Called from the draining task with the result, or nullptr
+     * @param arg Argument passed to @p done
+     * @return ESP_OK: command queued
+     * @return ESP_ERR_INVALID_ARG: @p rail is not a rail of the group, or invalid @p action
+     * @return ESP_ERR_NO_MEM: queue full; the command is dropped
+     */
+    esp_err_t post(gpio_num_t rail, PowerAction action, PowerCommandCallback done = nullptr, void *arg = nullptr);
+
+    /**
+     * @brief Queue a command and notify @p notify_task when it has been applied
+     *
+     * The result is delivered as the task notification value
+     * (`xTaskNotify(notify_task, result, eSetValueWithOverwrite)`), e.g. read with
+     * `xTaskNotifyWait()`.
+     *
+     * @param rail GPIO of a rail of the group
+     * @param action Switching action
+     * @param notify_task Task to notify with the result
+     * @return ESP_OK: command queued
+     * @return ESP_ERR_INVALID_ARG: @p rail is not a rail of the group, or invalid @p action
+     * @return ESP_ERR_NO_MEM: queue full; the command is dropped
+     */
+    esp_err_t post(gpio_num_t rail, PowerAction action, TaskHandle_t notify_task);
+
+    /**
+     * @brief Queue a command from an interrupt handler (IRAM, no logging)
+     *
+     * @param rail GPIO of a rail of the group
+     * @param action Switching action
+     * @param higher_priority_task_woken Set to pdTRUE if the power task must run
+     *        before the ISR returns (pass to portYIELD_FROM_ISR()); may be nullptr
+     * @param done Called from the draining task with the result, or nullptr
+     * @param arg Argument passed to @p done
+     * @return ESP_OK: command queued
+     * @return ESP_ERR_INVALID_ARG: @p rail is not a rail of the group, or invalid @p action
+     * @return ESP_ERR_NO_MEM: queue full; the command is dropped
+     *
+     * @note The queue object must live in internal RAM.
+     */
+    esp_err_t post_from_isr(
+        gpio_num_t rail,
+        PowerAction action,
+        BaseType_t *higher_priority_task_woken,
+        PowerCommandCallback done = nullptr,
+        void *arg = nullptr);
+
+    /**
+     * @brief Apply every pending command in the caller's context
+     *
+     * Used by the power task; without start(), one task may call it directly.
+     *
+     * @return Number of commands applied
+     *
+     * @note Never call it concurrently with itself or while the power task runs.
+     */
+    size_t drain();
+
+    /**
+     * @brief Number of commands queued and not applied yet
+     */
+    size_t get_pending() const;
+
+private:
+    /// One queued command
+    struct Command
+    {
+        PowerCommandCallback done; ///< Completion callback, or nullptr
+        void *arg;                 ///< Argument of done
+        TaskHandle_t notify_task;  ///< Task notified with the result, or nullptr
+        uint8_t gpio;              ///< Rail GPIO
+        PowerAction action;        ///< Switching action
+    };
+
+    /// Ring slot; seq == position when free, position + 1 once the command is stored
+    struct Slot
+    {
+        std::atomic<uint32_t> seq;
+        Command command;
+    };
+
+    /**
+     * @brief Store one command in the ring (IRAM, lock-free)
+     */
+    esp_err_t push(const Command &command);
+
+    /**
+     * @brief Check, queue and announce a command posted from a task
+     */
+    esp_err_t post_command(const Command &command);
+
+    /**
+     * @brief Take the oldest stored command, if any (consumer side only)
+     */
+    bool pop(Command &command);
+
+    /**
+     * @brief Check that @p rail and @p action can be queued (IRAM)
+     */
+    bool accepts(gpio_num_t rail, PowerAction action) const;
+
+    /**
+     * @brief Power task body
+     */
+    static void task_entry(void *arg);
+
+    PowerProfileGroup &group_; ///< Rails switched by the queue
+    const uint64_t pin_mask_;  ///< Pins of the group
+
+    Slot slots_[DEPTH];                   ///< Command ring
+    std::atomic<uint32_t> tail_{0};       ///< Next position claimed by a producer
+    std::atomic<uint32_t> head_{0};       ///< Next position read by the consumer
+    Command batch_[DEPTH] = {};           ///< Commands of the current drain
+    esp_err_t results_[DEPTH] = {};       ///< Pre-write result of each command of batch_
+    std::atomic<TaskHandle_t> task_{};    ///< Power task, or nullptr
+    std::atomic<uint32_t> notifying_{0};  ///< Posts between reading task_ and notifying it
+    std::atomic<bool> stopping_{false};   ///< stop() asked the power task to exit
+    std::atomic<bool> task_exited_{true}; ///< Power task has left its loop
+};
+} // namespace power_control
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+
+#include "sdkconfig.h"
+
 #include "gpio_hal.hpp"
+#include "i_fault_sense_hal.hpp"
 #include "i_gpio_hal.hpp"
 #include "i_power_control.hpp"
+#include "i_timer_hal.hpp"
+#include "power_load.hpp"
+#include "power_telemetry.hpp"
 
 // ========================================
 // Power Control Implementation
@@ -29,6 +38,17 @@ namespace power_control {
 class PowerControl : public IPowerControl
 {
 public:
+    /**
+     * @brief Callback fired when the rail has settled after turn_on_async()
+     *
+     * @param rail The rail that became ready
+     * @param ctx User context passed to turn_on_async()
+     *
+     * @note Called from the timer context (esp_timer task with TimerHAL), or from
+     *       the caller's context when the rail is already ready
+     */
+    using ready_callback_t = void (*)(PowerControl &rail, void *ctx);
+
     /**
      * @brief Construct a new Power Control instance
      *
@@ -38,6 +58,8 @@ public:
      * @param initial_on Initial logical state after init()
      *
      * @note The component is not initialized until init() is called
+     * @note Timed features (settle time, turn_on_async) need the constructor
+     *       taking an ITimerHAL
      * @warning The GPIO pin must support output mode on the target hardware
      */
     PowerControl(
@@ -46,13 +68,73 @@ public:
         const bool inverted_logic = false,
         const bool initial_on = false);
 
+    /**
+     * @brief Construct a new Power Control instance with timed features
+     *
+     * @param hal Reference to the HAL implementation for hardware access
+     * @param timer Reference to the timer HAL used for settle time tracking
+     * @param gpio GPIO pin number to control
+     * @param inverted_logic true = active LOW, false = active HIGH
+     * @param initial_on Initial logical state after init()
+     * @param settle_time_us Time the powered device needs after turn-on before
+     *        it can be used (0 = ready immediately)
+     *
+     * @note The component is not initialized until init() is called
+     * @warning The GPIO pin must support output mode on the target hardware
+     */
+    PowerControl(
+        IGpioHAL &hal,
+        ITimerHAL &timer,
+        const gpio_num_t gpio,
+        const bool inverted_logic = false,
+        const bool initial_on = false,
+        const uint32_t settle_time_us = 0);
+
+    ~PowerControl() override;
+
     /// @copydoc IPowerControl::init()
     esp_err_t init() override;
 
+    /**
+     * @brief Initialize several rails with batched GPIO operations
+     *
+     * Fast-boot alternative to calling init() on every rail. All rails that are
+     * not yet initialized and share the HAL of the first one are configured with a
+     * single gpio_config_t covering every pin, and their initial levels are applied
+     * with a single IGpioHAL::set_levels_mask() write. One summary line is logged
+     * instead of two per rail. Unlike init(), pins are not reset first.
+     *
+     * Rails using another HAL are initialized one by one with init(). Already
+     * initialized rails and nullptr entries are skipped.
+     *
+     * @param rails Array of rails to initialize
+     * @param count Number of entries in @p rails
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_ARG: invalid GPIO, or two rails on the same GPIO
+     * @return Other: error codes propagated from the HAL implementations; no rail
+     *         of the batch is marked initialized
+     */
+    static esp_err_t init_all(PowerControl *const *rails, size_t count);
+
+    /**
+     * @brief Initialize an array of rails with batched GPIO operations
+     *
+     * @copydetails init_all(PowerControl *const *, size_t)
+     */
+    template <size_t N>
+    static esp_err_t init_all(PowerControl *const (&rails)[N])
+    {
+        return init_all(rails, N);
+    }
+
     /// @copydoc IPowerControl::deinit()
     esp_err_t deinit() override;
 
-    /// @copydoc IPowerControl::set_drive_capability()
+    /**
+     * @copydoc IPowerControl::set_drive_capability()
+     *
+     * Overrides the drive strength selected by set_load() and disables its edge boost.
+     */
     esp_err_t set_drive_capability(gpio_drive_cap_t strength) override;
 
     /// @copydoc IPowerControl::turn_on()
@@ -64,8 +146,408 @@ public:
     /// @copydoc IPowerControl::toggle()
     esp_err_t toggle() override;
 
+#if CONFIG_POWER_CONTROL_ISR_API
+    /**
+     * @brief Turn the output ON from an interrupt or cache-disabled context
+     *
+     * ISR-safe counterpart of turn_on(): runs from IRAM, does no logging and no
+     * allocation, and writes the GPIO output register directly instead of going
+     * through the injected IGpioHAL (a virtual call would read the vtable from
+     * flash). It can therefore be used from ISRs, esp_timer callbacks and while
+     * the flash cache is disabled.
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: component not initialized, pin held for sleep or fault latched
+     *
+     * @note Only valid for rails on native GPIOs. The PowerControl object itself
+     *       must live in internal RAM.
+     * @note Settle time tracking is not restarted; use turn_on() when is_ready()
+     *       or turn_on_async() matter
+     * @note Available when CONFIG_POWER_CONTROL_ISR_API is enabled
+     */
+    esp_err_t turn_on_from_isr();
+
+    /**
+     * @brief Turn the output OFF from an interrupt or cache-disabled context
+     *
+     * ISR-safe counterpart of turn_off(). See turn_on_from_isr() for constraints.
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: component not initialized
+     *
+     * @note Available when CONFIG_POWER_CONTROL_ISR_API is enabled
+     */
+    esp_err_t turn_off_from_isr();
+#endif
+
     /// @copydoc IPowerControl::is_on()
-    bool is_on() const override { return is_on_; }
+    bool is_on() const override { return is_on_.load(std::memory_order_acquire); }
+
+    // ========================================
+    // Write Modes
+    // ========================================
+
+    /**
+     * @brief Skip the HAL when a switching call matches the cached state
+     *
+     * When enabled, a turn_on() or turn_off() that matches the cached state returns
+     * ESP_OK without calling IGpioHAL::set_level() or logging. init() always writes
+     * the initial state. Use refresh() to force the cached state back onto the pin.
+     *
+     * @param enable true to skip redundant writes (default: false)
+     */
+    void set_idempotent(bool enable) { idempotent_ = enable; }
+
+    /**
+     * @brief Check whether redundant writes are skipped
+     */
+    bool is_idempotent() const { return idempotent_; }
+
+    /**
+     * @brief Read the pin back after every write to detect and repair drift
+     *
+     * Relies on the GPIO_MODE_INPUT_OUTPUT configuration applied by init(). After a
+     * write, or instead of a skipped write in idempotent mode, the pad level is read
+     * with IGpioHAL::get_level(). A mismatch is logged and rewritten once; if the
+     * pin still reads wrong, the call fails with ESP_FAIL and the cached state is
+     * left unchanged.
+     *
+     * @param enable true to verify every write (default: false)
+     */
+    void set_readback_verify(bool enable) { readback_verify_ = enable; }
+
+    /**
+     * @brief Check whether writes are verified by read-back
+     */
+    bool is_readback_verify() const { return readback_verify_; }
+
+    /**
+     * @brief Write the cached logical state to the pin again
+     *
+     * Always reaches the HAL, also in idempotent mode, and is verified when
+     * read-back verification is enabled.
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: component not initialized or pin held for sleep
+     * @return ESP_FAIL: read-back verification failed
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     */
+    esp_err_t refresh();
+
+    // ========================================
+    // Drive Strength
+    // ========================================
+
+    /**
+     * @brief Declare what the pin drives, so the drive strength is selected automatically
+     *
+     * The weakest drive capability that sources PowerLoad::steady_ma is applied by
+     * init(), init_all() and warm_init(), or at once if the rail is already
+     * initialized. If the edge needs more current (PowerLoad::edge_ma), every
+     * turn_on(), turn_off() and toggle() that changes the state raises the drive
+     * for PowerLoad::edge_us around the write, then drops it back.
+     *
+     * @param load Load profile, e.g. PowerLoad::direct(3) or PowerLoad::gate(12, 1)
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_ARG: the load needs more current than the strongest drive capability
+     * @return Other: error codes propagated from IGpioHAL::set_drive_capability()
+     *
+     * @note The edge wait uses ITimerHAL::delay_us(), or esp_rom_delay_us() without a
+     *       timer HAL. Batched writes (init_all(), PowerProfileGroup) and the ISR API
+     *       switch at the steady drive strength.
+     */
+    esp_err_t set_load(const PowerLoad &load);
+
+    /**
+     * @brief Drive strength applied while the rail is not switching
+     */
+    gpio_drive_cap_t get_drive_capability() const { return steady_drive_; }
+
+    /**
+     * @brief Check whether switching edges are driven stronger than the steady state
+     */
+    bool is_edge_boost() const { return edge_drive_ > steady_drive_; }
+
+    // ========================================
+    // Settle Time
+    // ========================================
+
+    /**
+     * @brief Set the warm-up period of the powered device
+     *
+     * @param settle_time_us Time needed after turn-on before the device can be
+     *        used (0 = ready immediately)
+     * @return ESP_OK on success
+     * @return ESP_ERR_NOT_SUPPORTED: non-zero settle time without an ITimerHAL
+     */
+    esp_err_t set_settle_time_us(uint32_t settle_time_us);
+
+    /**
+     * @brief Get the warm-up period of the powered device
+     *
+     * @return uint32_t Settle time in microseconds
+     */
+    uint32_t get_settle_time_us() const { return settle_time_us_; }
+
+    /**
+     * @brief Turn the output ON and get notified once it has settled
+     *
+     * Does not block: readiness is scheduled with a one-shot timer that fires the
+     * callback when the settle time has elapsed. A single task can this way power
+     * up several rails back-to-back and read each sensor as it becomes ready. If
+     * the rail is already ON, only the remaining part of the settle time is waited.
+     *
+     * @param callback Function called once the rail is ready (may be nullptr)
+     * @param ctx User context passed to @p callback
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: component not initialized
+     * @return ESP_ERR_NOT_SUPPORTED: non-zero settle time without an ITimerHAL
+     * @return Other: error codes propagated from the HAL implementations
+     *
+     * @note A pending callback is cancelled by turn_off(), toggle() to OFF and deinit()
+     */
+    esp_err_t turn_on_async(ready_callback_t callback, void *ctx);
+
+    /**
+     * @brief Check whether the rail is ON and its settle time has elapsed
+     *
+     * @return true Rail is ON and the powered device can be used
+     * @return false Rail is OFF or still settling
+     */
+    bool is_ready() const;
+
+    /**
+     * @brief Turn the output ON and switch it OFF automatically after @p duration_us
+     *
+     * Does not block: the auto-off runs from a one-shot timer (esp_timer task with
+     * TimerHAL), so no task is tied up and the on-time is not quantized to RTOS
+     * ticks. Calling it while the rail is ON restarts the countdown from now.
+     *
+     * @param duration_us Time until the automatic turn-off
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: component not initialized
+     * @return ESP_ERR_INVALID_ARG: @p duration_us is 0
+     * @return ESP_ERR_NOT_SUPPORTED: constructed without an ITimerHAL
+     * @return Other: error codes propagated from the HAL implementations; a rail
+     *         that was OFF is switched back OFF if the timer cannot be armed
+     *
+     * @note The auto-off is cancelled by turn_off(), toggle() to OFF, deinit() and
+     *       cancel_auto_off(). With esp_timer the resolution is a few tens of µs.
+     */
+    esp_err_t turn_on_for(uint64_t duration_us);
+
+    /**
+     * @brief Generate one ON pulse of @p duration_us
+     *
+     * Same as turn_on_for(), but the rail must be OFF, so the pulse has exactly the
+     * requested width.
+     *
+     * @return ESP_ERR_INVALID_STATE: component not initialized or rail already ON
+     * @return Other: see turn_on_for()
+     */
+    esp_err_t pulse(uint64_t duration_us);
+
+    /**
+     * @brief Cancel a pending auto-off; the rail stays in its current state
+     */
+    void cancel_auto_off();
+
+    /**
+     * @brief Check whether an automatic turn-off is scheduled
+     */
+    bool is_auto_off_pending() const { return auto_off_deadline_us_.load(std::memory_order_acquire) >= 0; }
+
+    // ========================================
+    // Sleep Retention
+    // ========================================
+
+    /**
+     * @brief Latch the current output state before entering sleep
+     *
+     * Holds the pin with gpio_hold_en() so the rail neither glitches nor floats
+     * while the chip sleeps. For deep sleep, gpio_deep_sleep_hold_en() is also
+     * enabled on chips that need it. While held, switching calls return
+     * ESP_ERR_INVALID_STATE.
+     *
+     * @param deep_sleep true if the chip is about to enter deep sleep
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: component not initialized
+     * @return ESP_ERR_NOT_SUPPORTED: the HAL cannot hold pins
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation;
+     *         the pin is left unheld
+     *
+     * @note The deep-sleep hold is chip-wide and is left enabled by release_hold()
+     */
+    esp_err_t hold_for_sleep(bool deep_sleep = true);
+
+    /**
+     * @brief Release the hold taken by hold_for_sleep() after a light-sleep wake
+     *
+     * @return ESP_OK on success or if the pin is not held
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     */
+    esp_err_t release_hold();
+
+    /**
+     * @brief Check whether the pin is latched by hold_for_sleep()
+     */
+    bool is_held() const { return held_; }
+
+    /**
+     * @brief Initialize after a deep-sleep wake without resetting the pin
+     *
+     * Unlike init(), the pin is not reset, so a rail held ON through sleep stays
+     * powered. The pin is configured as input/output first, so the pad can be
+     * read, then the current pad level is read back and adopted as the logical
+     * state, the output register is set to the same level while the pin is still
+     * held, and only then the hold is released. A rail adopted as ON is treated as
+     * already settled.
+     *
+     * @return ESP_OK on success or if already initialized
+     * @return ESP_ERR_NOT_SUPPORTED: the HAL cannot read the pin back; use
+     *         warm_init(bool) with a state retained in RTC memory
+     * @return Other: error codes propagated from the HAL implementations
+     */
+    esp_err_t warm_init();
+
+    /**
+     * @brief Initialize after a deep-sleep wake, adopting a retained logical state
+     *
+     * Same as warm_init(), but the state is taken from @p retained_on (e.g. an
+     * `RTC_DATA_ATTR` copy of is_on() saved before sleep) instead of the pad.
+     *
+     * @param retained_on Logical state the rail had when it entered sleep
+     * @return ESP_OK on success or if already initialized
+     * @return Other: error codes propagated from the HAL implementations
+     */
+    esp_err_t warm_init(bool retained_on);
+
+#if CONFIG_POWER_CONTROL_STATS
+    // ========================================
+    // Statistics
+    // ========================================
+
+    /**
+     * @brief Usage statistics of the rail
+     */
+    struct Stats
+    {
+        uint64_t on_time_us;    ///< Cumulative ON time, including the current ON period
+        uint64_t longest_on_us; ///< Longest single ON period, including the current one
+        uint32_t on_count;      ///< Number of OFF -> ON transitions
+        uint32_t off_count;     ///< Number of ON -> OFF transitions
+        float charge_mah;       ///< Estimated charge drawn (on_time_us x load current), in mAh
+    };
+
+    /**
+     * @brief Get the usage statistics accumulated since construction or reset_stats()
+     *
+     * @return Stats Snapshot of the counters
+     *
+     * @note On-time is only measured with an ITimerHAL; without it the time fields stay 0
+     * @note Periods started or ended by the ISR API are counted as transitions, but
+     *       their duration is not accounted. The ISR API only bumps its own atomic
+     *       counters, so it does not race the task-side bookkeeping.
+     * @note Available when CONFIG_POWER_CONTROL_STATS is enabled
+     */
+    Stats get_stats() const;
+
+    /**
+     * @brief Zero the statistics counters
+     *
+     * If the rail is ON, its current period is accounted from now on.
+     */
+    void reset_stats();
+
+    /**
+     * @brief Set the current drawn by the load while the rail is ON
+     *
+     * @param load_current_ua Load current in microamps, used for Stats::charge_mah
+     */
+    void set_load_current_ua(uint32_t load_current_ua) { load_current_ua_ = load_current_ua; }
+
+    /**
+     * @brief Get the configured load current
+     *
+     * @return uint32_t Load current in microamps (0 = not configured)
+     */
+    uint32_t get_load_current_ua() const { return load_current_ua_; }
+#endif
+
+#if CONFIG_POWER_CONTROL_PROTECTION
+    // ========================================
+    // Fault Protection
+    // ========================================
+
+    /**
+     * @brief Cut the rail from the interrupt of a fault source
+     *
+     * @p sense calls the protection handler from its ISR as soon as the fault is
+     * seen: the handler drives the pin OFF with the ISR write path (no task, no
+     * polling), latches the fault, and defers the logging and timer bookkeeping to
+     * the FreeRTOS timer service task. While latched, turn_on() and the other
+     * switching calls that would power the rail return ESP_ERR_INVALID_STATE.
+     * A rail being switched ON counts as ON for the handler, and a switch-ON that
+     * finds a fault latched or reported after its write cuts the rail again.
+     *
+     * With @p max_retries > 0 the rail is retried automatically: after
+     * @p retry_delay_us, doubled on every further attempt, the fault is released
+     * and the rail turned back ON if the source no longer reports it. A retry that
+     * trips again counts as an attempt; after @p max_retries the fault stays
+     * latched until clear_fault(). A retried rail that stays up for as long as the
+     * backoff it waited has its attempt count reset, so the next fault starts
+     * over at @p retry_delay_us with the full number of retries.
+     *
+     * @param sense Fault source (GpioFaultSense, AdcFaultSense); must outlive the rail
+     *        or disable_fault_protection()
+     * @param retry_delay_us Delay before the first retry
+     * @param max_retries Number of automatic retries (0 = latch until clear_fault())
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: protection already enabled
+     * @return ESP_ERR_INVALID_ARG: retries requested with @p retry_delay_us 0
+     * @return ESP_ERR_NOT_SUPPORTED: retries requested without an ITimerHAL
+     * @return Other: error codes propagated from IFaultSenseHAL::start() and ITimerHAL
+     *
+     * @note The cut has the constraints of turn_off_from_isr(): native GPIO, object
+     *       in internal RAM. A fault on a rail that is OFF is ignored.
+     * @note turn_off() cancels a pending retry and resets the attempt count
+     * @note Available when CONFIG_POWER_CONTROL_PROTECTION is enabled
+     */
+    esp_err_t set_fault_protection(IFaultSenseHAL &sense, uint32_t retry_delay_us = 0, uint8_t max_retries = 0);
+
+    /**
+     * @brief Stop monitoring the fault source and cancel a pending retry
+     *
+     * A latched fault stays latched; clear it with clear_fault().
+     */
+    void disable_fault_protection();
+
+    /// @copydoc IPowerControl::get_fault()
+    PowerFault get_fault() const override { return fault_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Release a latched fault; the rail stays OFF
+     *
+     * Also cancels a pending retry and resets the attempt count.
+     *
+     * @return ESP_OK on success or if no fault is latched
+     * @return ESP_ERR_INVALID_STATE: the fault source still reports the fault
+     */
+    esp_err_t clear_fault();
+
+    /**
+     * @brief Number of times the protection has cut the rail since construction
+     */
+    uint32_t get_fault_count() const { return fault_count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether an automatic retry is scheduled
+     */
+    bool is_fault_retry_pending() const
+    {
+        return retry_state_.load(std::memory_order_acquire) == RetryState::PENDING;
+    }
+#endif
 
     /// @copydoc IPowerControl::is_initialized()
     bool is_initialized() const override { return initialized_; }
@@ -74,6 +556,8 @@ public:
     gpio_num_t get_pin() const override { return gpio_; }
 
 private:
+    friend class PowerProfileGroup; // Writes profile deltas and commits the new states
+
     /**
      * @brief Apply a logical state to the GPIO
      *
@@ -81,18 +565,211 @@ private:
      * based on inverted_logic_ setting.
      *
      * @param enable Desired logical state (true = ON, false = OFF)
+     * @param force Write even in idempotent mode when the state is unchanged
      * @return esp_err_t Result of the operation
      *
      * @note Updates is_on_ only on successful HAL operation
      */
-    esp_err_t apply_gpio(bool enable);
+    esp_err_t apply_gpio(bool enable, bool force = false);
+
+    /**
+     * @brief Update the cached state and the timed/statistics bookkeeping after a write
+     */
+    void commit_state(bool enable);
+
+    /**
+     * @brief Apply the drive strength selected by set_load(), if any
+     */
+    esp_err_t apply_load_drive();
+
+    /**
+     * @brief Drop the drive back to the steady strength after a boosted edge
+     *
+     * @param wait Wait for the edge to complete first
+     */
+    void end_edge_boost(bool wait);
+
+    /**
+     * @brief Create the settle timer if a timer HAL is set and it does not exist yet
+     */
+    esp_err_t create_settle_timer();
+
+    /**
+     * @brief Drive the pin to a physical level, verified by read-back if enabled
+     */
+    esp_err_t write_pin(bool level);
+
+    /**
+     * @brief Read the pin back and rewrite it once if it does not match @p level
+     *
+     * @return ESP_FAIL if the pin still reads wrong after the rewrite
+     */
+    esp_err_t verify_pin(bool level);
+
+#if CONFIG_POWER_CONTROL_STATS
+    /**
+     * @brief Account a logical state change in the statistics
+     *
+     * Called after on_since_us_ has been updated for an OFF -> ON transition.
+     */
+    void record_transition(bool enable);
+
+    /// Start timing an ON period at @p start_us (-1 = not measured)
+    void start_period(int64_t start_us);
+
+    /// True while the period started by start_period() is timed (no ISR transition since)
+    bool period_timed() const;
+#endif
+
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    /**
+     * @brief Claim a telemetry slot on first init; kept until destruction
+     */
+    void attach_telemetry();
+#endif
+
+    /**
+     * @brief Configure the pin as input/output without resetting it (warm init)
+     */
+    esp_err_t configure_warm_pin();
+
+    /**
+     * @brief Adopt @p enable on a pin set up by configure_warm_pin() and release its hold
+     */
+    esp_err_t adopt_state(bool enable);
+
+    /**
+     * @brief Time left until the rail is ready, 0 if already ready or OFF
+     */
+    int64_t settle_remaining_us() const;
+
+    /**
+     * @brief Settle timer expiry handler
+     */
+    static void settle_timer_cb(void *arg);
+
+    /**
+     * @brief Auto-off timer expiry handler
+     */
+    static void auto_off_timer_cb(void *arg);
+
+#if CONFIG_POWER_CONTROL_ISR_API
+    /**
+     * @brief ISR-safe variant of apply_gpio()
+     *
+     * @param enable Desired logical state (true = ON, false = OFF)
+     * @return esp_err_t Result of the operation
+     */
+    esp_err_t apply_gpio_from_isr(bool enable);
+#endif
+
+#if CONFIG_POWER_CONTROL_PROTECTION
+    /**
+     * @brief Fault handler called by IFaultSenseHAL: cut the rail and latch the fault
+     */
+    static void fault_isr(void *arg);
+
+    /**
+     * @brief Latch the fault kind of the source, unless a fault is latched already
+     *
+     * @return true if this call latched it
+     */
+    bool latch_fault();
+
+    /**
+     * @brief Check, after a switch-ON write, for a fault that arrived while switching
+     *
+     * Cuts the rail again if the fault ISR latched a fault during the switch, or
+     * latches and cuts it if the source reports a fault whose edge was lost.
+     *
+     * @return true if the rail was cut
+     */
+    bool cut_if_faulted_on_switch(bool level);
+
+    /**
+     * @brief Task-context part of a fault: bookkeeping, logging and retry scheduling
+     */
+    static void fault_deferred_cb(void *arg, uint32_t unused);
+
+    /**
+     * @brief Retry timer expiry handler
+     */
+    static void fault_retry_timer_cb(void *arg);
+
+    /// Use of the retry timer
+    enum class RetryState : uint8_t
+    {
+        IDLE,    ///< Not armed
+        PENDING, ///< Armed for the next retry
+        STABLE,  ///< Armed to reset the attempts if the retried rail stays up
+    };
+
+    /**
+     * @brief Backoff before retry @p attempt + 1
+     */
+    uint64_t fault_backoff_us(uint8_t attempt) const;
+
+    /**
+     * @brief Arm the retry timer with the backoff of the current attempt
+     */
+    void schedule_fault_retry();
+
+    /**
+     * @brief Cancel a pending retry and reset the attempt count
+     */
+    void cancel_fault_retry();
+#endif
 
     IGpioHAL &hal_;       ///< HAL instance for hardware access
+    ITimerHAL *timer_;    ///< Timer HAL for timed features (nullptr = none)
     gpio_num_t gpio_;     ///< GPIO pin number
     bool inverted_logic_; ///< true = active LOW, false = active HIGH
     bool initial_on_;     ///< Initial state to apply after init
 
-    bool initialized_ = false; ///< Initialization state
-    bool is_on_ = false;       ///< Current logical state
+    bool idempotent_ = false;      ///< Skip writes that match the cached state
+    bool readback_verify_ = false; ///< Verify every write by reading the pin back
+    bool held_ = false;            ///< Pin latched by hold_for_sleep()
+
+    bool load_set_ = false;                            ///< Drive strength selected by set_load()
+    gpio_drive_cap_t steady_drive_ = GPIO_DRIVE_CAP_2; ///< Drive between edges
+    gpio_drive_cap_t edge_drive_ = GPIO_DRIVE_CAP_2;   ///< Drive during a switching edge
+    uint16_t edge_us_ = 0;                             ///< Duration of a boosted edge
+
+    uint32_t settle_time_us_;                       ///< Warm-up period after turn-on
+    int64_t on_since_us_ = 0;                       ///< Time of the last OFF -> ON transition
+    timer_handle_t settle_timer_ = nullptr;         ///< One-shot timer for turn_on_async()
+    ready_callback_t ready_cb_ = nullptr;           ///< Pending readiness callback
+    void *ready_ctx_ = nullptr;                     ///< Context of the pending callback
+    timer_handle_t auto_off_timer_ = nullptr;       ///< One-shot timer for turn_on_for(), created on first use
+    std::atomic<int64_t> auto_off_deadline_us_{-1}; ///< Time of the armed auto-off (-1 = none), claimed by CAS
+
+    bool initialized_ = false;       ///< Initialization state
+    std::atomic<bool> is_on_{false}; ///< Current logical state (also written from ISR)
+
+#if CONFIG_POWER_CONTROL_STATS
+    Stats stats_ = {};                       ///< Counters of closed ON periods (task side)
+    int64_t stats_on_start_us_ = -1;         ///< Start of the current ON period (-1 = not measured)
+    uint32_t stats_start_isr_count_ = 0;     ///< ISR transitions seen when that period started
+    std::atomic<uint32_t> isr_on_count_{0};  ///< OFF -> ON transitions by the ISR API
+    std::atomic<uint32_t> isr_off_count_{0}; ///< ON -> OFF transitions by the ISR API
+    uint32_t load_current_ua_ = 0;           ///< Load current for the charge estimate
+#endif
+
+#if CONFIG_POWER_CONTROL_PROTECTION
+    IFaultSenseHAL *fault_sense_ = nullptr;                 ///< Fault source while protection is enabled
+    PowerFault fault_kind_ = PowerFault::NONE;              ///< Kind reported by the fault source
+    std::atomic<PowerFault> fault_{PowerFault::NONE};       ///< Latched fault (also written from ISR)
+    std::atomic<uint32_t> fault_count_{0};                  ///< Number of cuts by the protection
+    uint32_t retry_delay_us_ = 0;                           ///< Delay before the first retry
+    uint8_t max_retries_ = 0;                               ///< Automatic retries (0 = latch)
+    std::atomic<uint8_t> retry_attempts_{0};                ///< Retries since the last reset (set by both timer tasks)
+    timer_handle_t fault_retry_timer_ = nullptr;            ///< One-shot retry timer, created on first use
+    std::atomic<RetryState> retry_state_{RetryState::IDLE}; ///< Use of the retry timer (set by both timer tasks)
+    std::atomic<bool> switching_on_{false};                 ///< Switch-ON write in progress (read by the fault ISR)
+#endif
+
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    uint8_t telemetry_slot_ = PowerTelemetry::NO_SLOT; ///< Slot in the PowerTelemetry table
+#endif
 };
 } // namespace power_control
\ No newline at end of file
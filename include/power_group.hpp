@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "i_gpio_hal.hpp"
+
+// ========================================
+// Power Group Implementation
+// ========================================
+
+namespace power_control {
+
+class DedicGpioHAL;
+
+/**
+ * @class PowerGroup
+ * @brief Switches several power rails together with one batched GPIO write
+ *
+ * A PowerGroup owns a set of GPIO pins, each with its own logic polarity. The
+ * set/clear register masks for "all ON" and "all OFF" are computed once at
+ * construction, so turn_on_all(), turn_off_all() and apply_mask() each reach the
+ * hardware through a single IGpioHAL::set_levels_mask() call instead of one
+ * IGpioHAL::set_level() call per rail. All rails in the group change state on the
+ * same register write, without the stagger of switching them one by one.
+ *
+ * Logical state is exposed as a bitmask where bit N refers to GPIO N, which makes
+ * it possible to compose states with plain bitwise operations:
+ * @code
+ * apply_mask(group.get_state_mask() | BIT64(GPIO_NUM_5));
+ * @endcode
+ *
+ * @note This implementation is not thread-safe. External synchronization is
+ *       required if used from multiple tasks.
+ * @see PowerControl for single-rail control
+ */
+class PowerGroup
+{
+public:
+    /**
+     * @brief Description of one rail in the group
+     */
+    struct Rail
+    {
+        gpio_num_t gpio;     ///< GPIO pin number
+        bool inverted_logic; ///< true = active LOW, false = active HIGH
+    };
+
+    /**
+     * @brief Construct a new Power Group instance
+     *
+     * @param hal Reference to the HAL implementation for hardware access
+     * @param rails Array describing the rails of the group (copied into bitmasks)
+     * @param count Number of entries in @p rails
+     * @param initial_on Initial logical state of every rail after init()
+     *
+     * @note The group is not initialized until init() is called
+     * @note Invalid or duplicated pins are reported by init() as ESP_ERR_INVALID_ARG
+     */
+    PowerGroup(IGpioHAL &hal, const Rail *rails, size_t count, const bool initial_on = false);
+
+    /**
+     * @brief Construct a Power Group switched through a dedicated GPIO bundle
+     *
+     * If every pin of the group belongs to the bundle of @p hal, the bundle
+     * channel masks are computed here and, once init() has activated the bundle,
+     * every state change is one DedicGpioHAL::write_channels() call. Otherwise the
+     * group behaves as with any other IGpioHAL.
+     *
+     * @copydetails PowerGroup(IGpioHAL &, const Rail *, size_t, const bool)
+     */
+    PowerGroup(DedicGpioHAL &hal, const Rail *rails, size_t count, const bool initial_on = false);
+
+    /**
+     * @brief Initialize every rail of the group
+     *
+     * Resets the pins with one IGpioHAL::reset_pins_mask() call, configures all of
+     * them as outputs with one gpio_config_t covering the whole group and applies
+     * the initial state in one batched write.
+     *
+     * @return ESP_OK on success or if already initialized
+     * @return ESP_ERR_INVALID_ARG: empty group, invalid or duplicated GPIO number
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     */
+    esp_err_t init();
+
+    /**
+     * @brief Deinitialize every rail of the group
+     *
+     * Forces all pins low in one batched write and resets them.
+     *
+     * @return ESP_OK on success or if already deinitialized
+     * @return Other: first error propagated from the underlying IGpioHAL implementation
+     *
+     * @note The group is marked as deinitialized even on partial failure
+     */
+    esp_err_t deinit();
+
+    /**
+     * @brief Set the drive capability of every pin of the group
+     *
+     * @param strength Drive capability applied to all pins
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: group not initialized
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     */
+    esp_err_t set_drive_capability(gpio_drive_cap_t strength);
+
+    /**
+     * @brief Turn every rail of the group ON in one write
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: group not initialized
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     */
+    esp_err_t turn_on_all();
+
+    /**
+     * @brief Turn every rail of the group OFF in one write
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: group not initialized
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     */
+    esp_err_t turn_off_all();
+
+    /**
+     * @brief Apply a logical state to every rail of the group in one write
+     *
+     * @param on_mask Bit N set = rail on GPIO N ON, cleared = OFF
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: group not initialized
+     * @return ESP_ERR_INVALID_ARG: @p on_mask contains pins outside the group
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     *
+     * @note The logical state is only updated on successful HAL operation
+     */
+    esp_err_t apply_mask(uint64_t on_mask);
+
+    /**
+     * @brief Get the logical state of the group
+     *
+     * @return uint64_t Bit N set = rail on GPIO N is logically ON
+     */
+    uint64_t get_state_mask() const { return state_mask_; }
+
+    /**
+     * @brief Get the pins that belong to the group
+     *
+     * @return uint64_t Bit N set = GPIO N is part of the group
+     */
+    uint64_t get_pin_mask() const { return pin_mask_; }
+
+    /**
+     * @brief Get the logical state of one rail
+     *
+     * @param gpio GPIO pin of the rail
+     * @return true Rail is part of the group and logically ON
+     */
+    bool is_on(gpio_num_t gpio) const { return (state_mask_ & bit_of(gpio)) != 0; }
+
+    /**
+     * @brief Check if the group is initialized
+     *
+     * @return true Group is initialized and ready for operations
+     */
+    bool is_initialized() const { return initialized_; }
+
+private:
+    /**
+     * @brief Bitmask of one GPIO, or 0 if the number is out of range
+     */
+    static uint64_t bit_of(gpio_num_t gpio)
+    {
+        return (gpio >= 0 && gpio < GPIO_NUM_MAX) ? (1ULL << gpio) : 0;
+    }
+
+    /**
+     * @brief Write a logical state (already masked to the group) to the hardware
+     */
+    esp_err_t write_state(uint64_t on_mask);
+
+    IGpioHAL &hal_; ///< HAL instance for hardware access
+
+    uint64_t pin_mask_ = 0;      ///< All pins of the group
+    uint64_t on_set_mask_ = 0;   ///< Pins driven HIGH for ON (active HIGH rails)
+    uint64_t on_clear_mask_ = 0; ///< Pins driven LOW for ON (active LOW rails)
+    bool valid_ = true;          ///< false if the rail list had invalid or duplicated pins
+    bool initial_on_;            ///< Initial state to apply after init
+
+    bool initialized_ = false; ///< Initialization state
+    uint64_t state_mask_ = 0;  ///< Current logical state
+
+    DedicGpioHAL *dedic_ = nullptr;  ///< Bundle driving every pin of the group, or nullptr
+    uint32_t channel_mask_ = 0;      ///< Bundle channels of the group
+    uint32_t inverted_channels_ = 0; ///< Bundle channels of the active LOW rails
+};
+} // namespace power_control
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+#include "driver/gpio.h"
+
+// ========================================
+// Load Profiles
+// ========================================
+
+namespace power_control {
+/**
+ * @struct PowerLoad
+ * @brief What a rail's pin drives, used to pick the weakest adequate drive strength
+ *
+ * Declared once per rail with PowerControl::set_load(). init() then selects the
+ * weakest GPIO drive capability that still sources the steady current, and, if
+ * the switching edge needs more (a MOSFET gate, a load with input capacitance),
+ * raises the drive only for the duration of each edge:
+ * @code
+ * rail.set_load(PowerLoad::direct(3));            // 3 mA sensor on the pin: GPIO_DRIVE_CAP_0
+ * gate.set_load(PowerLoad::gate(12, 1));          // 12 nC gate in 1 µs: CAP_2 on the edges, CAP_0 between
+ * probe.set_load(PowerLoad::direct(8, 30, 50));   // CAP_1, CAP_3 for the 50 µs of a 30 mA inrush
+ * @endcode
+ *
+ * Weaker drive means slower pad edges, less ground bounce and EMI, and less
+ * shoot-through current per switching edge.
+ */
+struct PowerLoad
+{
+    /// Nominal current each drive capability sources at a valid HIGH level (CAP_0..CAP_3)
+    static constexpr uint16_t DRIVE_CAP_MA[] = {5, 10, 20, 40};
+
+    uint16_t steady_ma; ///< Current drawn from the pin while the rail is ON
+    uint16_t edge_ma;   ///< Current needed during a switching edge (<= steady_ma = no boost)
+    uint16_t edge_us;   ///< Duration of the switching edge
+
+    /**
+     * @brief Load powered directly from the pin
+     *
+     * @param current_ma Steady current of the load
+     * @param inrush_ma Peak current while the load's input capacitance charges (0 = none)
+     * @param inrush_us Duration of the inrush
+     */
+    static constexpr PowerLoad direct(uint16_t current_ma, uint16_t inrush_ma = 0, uint16_t inrush_us = 0)
+    {
+        return PowerLoad{current_ma, inrush_ma, inrush_us};
+    }
+
+    /**
+     * @brief MOSFET gate driven by the pin (no steady current)
+     *
+     * The edge needs I = Qg / t_edge, rounded up to the next mA.
+     *
+     * @param gate_charge_nc Total gate charge Qg from the MOSFET datasheet
+     * @param edge_us Wanted switching time (at least 1 µs)
+     */
+    static constexpr PowerLoad gate(uint16_t gate_charge_nc, uint16_t edge_us = 1)
+    {
+        const uint16_t t_us = edge_us > 0 ? edge_us : 1;
+        return PowerLoad{0, static_cast<uint16_t>((gate_charge_nc + t_us - 1) / t_us), t_us};
+    }
+
+    /**
+     * @brief Weakest drive capability sourcing @p current_ma
+     *
+     * @param current_ma Current to source
+     * @param[out] drive Selected drive capability
+     * @return false if @p current_ma exceeds the strongest drive capability
+     */
+    static constexpr bool drive_for(uint32_t current_ma, gpio_drive_cap_t &drive)
+    {
+        for (int cap = GPIO_DRIVE_CAP_0; cap <= GPIO_DRIVE_CAP_3; cap++) {
+            if (current_ma <= DRIVE_CAP_MA[cap]) {
+                drive = static_cast<gpio_drive_cap_t>(cap);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Check whether the edge needs a stronger drive than the steady state
+     */
+    constexpr bool needs_edge_boost() const { return edge_ma > steady_ma; }
+};
+} // namespace power_control
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+// ========================================
+// Rail Profiles
+// ========================================
+
+namespace power_control {
+
+class IPowerControl;
+class PowerControl;
+
+/**
+ * @class PowerProfile
+ * @brief Immutable set of rails that are ON, as a GPIO bitmask
+ *
+ * Bit N set = the rail on GPIO N is ON; rails of the group whose bit is clear are
+ * OFF. Profiles are captured with PowerProfileGroup::snapshot() or declared as
+ * constants:
+ * @code
+ * constexpr PowerProfile MEASURE{(1ULL << GPIO_NUM_4) | (1ULL << GPIO_NUM_5)};
+ * constexpr PowerProfile IDLE{0};
+ * @endcode
+ */
+class PowerProfile
+{
+public:
+    constexpr explicit PowerProfile(uint64_t on_mask)
+        : on_mask_(on_mask)
+    {
+    }
+
+    /**
+     * @brief Rails that are ON in this profile (bit N = GPIO N)
+     */
+    constexpr uint64_t get_on_mask() const { return on_mask_; }
+
+    /**
+     * @brief Check whether the rail on @p gpio is ON in this profile
+     */
+    constexpr bool is_on(gpio_num_t gpio) const
+    {
+        return gpio >= 0 && gpio < GPIO_NUM_MAX && (on_mask_ & (1ULL << gpio)) != 0;
+    }
+
+private:
+    uint64_t on_mask_; ///< Bit N set = rail on GPIO N ON
+};
+
+/**
+ * @class PowerProfileGroup
+ * @brief Switches a fixed set of PowerControl rails between profiles in one write
+ *
+ * apply_profile() compares the profile with the current state of the rails and
+ * drives only the rails that change, through a single IGpioHAL::set_levels_mask()
+ * call. Switching between "measure", "transmit" and "idle" costs one HAL write
+ * instead of one turn_on()/turn_off() per rail, and rails already in the right
+ * state are not touched.
+ *
+ * The rails stay ordinary PowerControl objects: they can still be switched one by
+ * one, and after a profile switch their state, settle time, auto-off and
+ * statistics are updated as if turn_on()/turn_off() had been called.
+ *
+ * @code
+ * PowerControl *const rails[] = {&sensor, &modem, &heater};
+ * PowerProfileGroup profiles(rails);
+ *
+ * const PowerProfile measure = profiles.snapshot(); // After switching the rails by hand
+ * profiles.apply_profile(PowerProfile{0});          // Everything OFF in one write
+ * profiles.apply_profile(measure);                  // Back in one write
+ * @endcode
+ *
+ * @note All rails must use the same IGpioHAL instance and distinct GPIOs.
+ * @note Profile writes ignore the per-rail idempotent and read-back modes.
+ * @note Not thread-safe, like PowerControl.
+ */
+class PowerProfileGroup
+{
+public:
+    /**
+     * @brief Construct a profile group over @p count rails
+     *
+     * @param rails Array of rails; the array and the rails must outlive this object
+     * @param count Number of entries in @p rails
+     *
+     * @note Invalid lists (nullptr entry, invalid or duplicated GPIO, mixed HALs)
+     *       are reported by apply_profile()
+     */
+    PowerProfileGroup(PowerControl *const *rails, size_t count);
+
+    /**
+     * @brief Construct a profile group over an array of rails
+     */
+    template <size_t N>
+    explicit PowerProfileGroup(PowerControl *const (&rails)[N])
+        : PowerProfileGroup(rails, N)
+    {
+    }
+
+    /**
+     * @brief Capture the current state of the rails
+     *
+     * @return PowerProfile Rails that are ON now
+     */
+    PowerProfile snapshot() const;
+
+    /**
+     * @brief Switch the rails to @p profile with one masked write
+     *
+     * Only rails whose state differs from the profile are written. If none
+     * differs, the HAL is not called.
+     *
+     * @param profile Target profile
+     * @param rail_mask Rails to switch (bit N = GPIO N); the others are neither
+     *        checked nor written and keep their state whatever @p profile says
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_ARG: invalid rail list, or @p profile has rails outside the group
+     * @return ESP_ERR_INVALID_STATE: a rail of @p rail_mask is not initialized or held for sleep
+     * @return Other: error codes propagated from IGpioHAL::set_levels_mask(); the
+     *         state of every rail is left unchanged
+     */
+    esp_err_t apply_profile(const PowerProfile &profile, uint64_t rail_mask = UINT64_MAX);
+
+    /**
+     * @brief Check whether apply_profile() would accept switching the rail on @p gpio to @p on
+     *
+     * @return ESP_OK if it would
+     * @return ESP_ERR_INVALID_ARG: invalid rail list, or @p gpio is not a rail of the group
+     * @return ESP_ERR_INVALID_STATE: the rail is not initialized, held for sleep, or
+     *         latched OFF by a fault while @p on is true
+     */
+    esp_err_t check_switch(gpio_num_t gpio, bool on) const;
+
+    /**
+     * @brief Check whether @p rail is one of the rails of the group
+     */
+    bool contains(const IPowerControl *rail) const;
+
+    /**
+     * @brief Pins of the rails in the group (bit N = GPIO N)
+     */
+    uint64_t get_pin_mask() const { return pin_mask_; }
+
+    /**
+     * @brief Number of rails in the group
+     */
+    size_t get_count() const { return count_; }
+
+private:
+    /**
+     * @brief Check one rail for apply_profile() (see check_switch())
+     */
+    static esp_err_t check_rail(const PowerControl &rail, bool on);
+
+    PowerControl *const *rails_; ///< Rails of the group
+    size_t count_;               ///< Number of rails
+
+    uint64_t pin_mask_ = 0;        ///< Pins of the group
+    uint64_t active_low_mask_ = 0; ///< Pins of the inverted-logic rails
+    bool valid_ = true;            ///< Rail list passed construction checks
+};
+} // namespace power_control
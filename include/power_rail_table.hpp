@@ -0,0 +1,339 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+#include "i_gpio_hal.hpp"
+
+// ========================================
+// Power Rail Table Implementation
+// ========================================
+
+namespace power_control {
+/**
+ * @class PowerRailTable
+ * @brief Contiguous, heap-free table of up to 64 rails sharing one HAL
+ *
+ * Boards with dozens of rails do not need one PowerControl object per rail. The
+ * table keeps one `uint8_t` pin number per rail and the polarity, logical state
+ * and initialization state of all rails in three 64-bit bitsets, next to a single
+ * HAL reference: about one byte per rail plus 40 bytes per table, in one block
+ * that can live in static storage.
+ *
+ * Rails are registered with add() and addressed through the returned handle (the
+ * rail index). Bulk operations take a handle mask (bit i = handle i), work on the
+ * bitsets directly and reach the hardware with one IGpioHAL::set_levels_mask() call.
+ *
+ * @code
+ * static PowerRailTable<40> rails(hal);
+ *
+ * PowerRailTable<40>::Handle modem, gps;
+ * rails.add(GPIO_NUM_4, false, false, modem);
+ * rails.add(GPIO_NUM_5, true, false, gps);
+ * rails.init();                                              // One reset, config and write
+ * rails.turn_on(modem);
+ * rails.apply_mask(rails.mask_of(modem) | rails.mask_of(gps)); // Both ON in one write
+ * @endcode
+ *
+ * @tparam N Capacity of the table (at most 64)
+ *
+ * @note No settle time, statistics or ISR API; use PowerControl for rails that need them.
+ * @note This implementation is not thread-safe. External synchronization is
+ *       required if used from multiple tasks.
+ */
+template <size_t N>
+class PowerRailTable
+{
+    static_assert(N > 0 && N <= 64, "PowerRailTable holds 1 to 64 rails");
+
+public:
+    using Handle = uint8_t; ///< Index of a rail in the table
+
+    /**
+     * @brief Construct an empty table
+     *
+     * @param hal HAL shared by every rail of the table
+     */
+    explicit PowerRailTable(IGpioHAL &hal)
+        : hal_(hal)
+    {
+    }
+
+    PowerRailTable(const PowerRailTable &) = delete;
+    PowerRailTable &operator=(const PowerRailTable &) = delete;
+
+    /**
+     * @brief Register a rail
+     *
+     * The rail is configured by the next init() call.
+     *
+     * @param gpio GPIO pin number to control
+     * @param inverted_logic true = active LOW, false = active HIGH
+     * @param initial_on Logical state applied by init()
+     * @param[out] handle Handle of the new rail
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_ARG: invalid GPIO, or GPIO already in the table
+     * @return ESP_ERR_NO_MEM: table full
+     */
+    esp_err_t add(gpio_num_t gpio, bool inverted_logic, bool initial_on, Handle &handle)
+    {
+        if (gpio < 0 || gpio >= GPIO_NUM_MAX || (pin_mask_ & (1ULL << gpio)) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (count_ == N) {
+            return ESP_ERR_NO_MEM;
+        }
+        handle = count_++;
+        pins_[handle] = static_cast<uint8_t>(gpio);
+        pin_mask_ |= 1ULL << gpio;
+        const uint64_t bit = mask_of(handle);
+        inverted_ = inverted_logic ? (inverted_ | bit) : (inverted_ & ~bit);
+        on_ = initial_on ? (on_ | bit) : (on_ & ~bit);
+        return ESP_OK;
+    }
+
+    /**
+     * @brief Initialize every registered rail that is not initialized yet
+     *
+     * Resets the pins with one IGpioHAL::reset_pins_mask(), configures them with
+     * one gpio_config_t and applies their initial states with one masked write.
+     *
+     * @return ESP_OK on success, or if every rail is already initialized
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation;
+     *         no rail of the batch is marked initialized
+     */
+    esp_err_t init()
+    {
+        const uint64_t pending = all_mask() & ~initialized_;
+        if (pending == 0) {
+            return ESP_OK;
+        }
+        const uint64_t pins = pins_of(pending);
+
+        esp_err_t ret = hal_.reset_pins_mask(pins);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+
+        gpio_config_t io_conf = {};
+        io_conf.mode = GPIO_MODE_INPUT_OUTPUT;
+        io_conf.pin_bit_mask = pins;
+        io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+        io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+        io_conf.intr_type = GPIO_INTR_DISABLE;
+
+        ret = hal_.config(io_conf);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+
+        ret = write(pending, on_);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        initialized_ |= pending;
+        return ESP_OK;
+    }
+
+    /**
+     * @brief Force every initialized rail low and reset its pin
+     *
+     * @return ESP_OK on success
+     * @return Other: first error propagated from the underlying IGpioHAL implementation
+     *
+     * @note Rails are marked as deinitialized and OFF even on partial failure, and
+     *       stay registered: init() configures them again
+     */
+    esp_err_t deinit()
+    {
+        if (initialized_ == 0) {
+            return ESP_OK;
+        }
+        const uint64_t pins = pins_of(initialized_);
+
+        // Force GPIOs low before deinitialization for safety
+        esp_err_t final_ret = hal_.set_levels_mask(0, pins);
+
+        // Reset GPIOs (returns to high-impedance state)
+        esp_err_t ret = hal_.reset_pins_mask(pins);
+        if (final_ret == ESP_OK) {
+            final_ret = ret; // Only override if no previous error
+        }
+
+        // Mark as deinitialized regardless of hardware errors
+        on_ &= ~initialized_;
+        initialized_ = 0;
+        return final_ret;
+    }
+
+    /**
+     * @brief Turn one rail ON
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_ARG: unknown handle
+     * @return ESP_ERR_INVALID_STATE: rail not initialized
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     */
+    esp_err_t turn_on(Handle handle) { return set(handle, true); }
+
+    /// @copydoc turn_on()
+    esp_err_t turn_off(Handle handle) { return set(handle, false); }
+
+    /// @copydoc turn_on()
+    esp_err_t toggle(Handle handle) { return set(handle, !is_on(handle)); }
+
+    /**
+     * @brief Apply a logical state to one rail
+     *
+     * @copydetails turn_on()
+     */
+    esp_err_t set(Handle handle, bool on)
+    {
+        if (handle >= count_) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        const uint64_t bit = mask_of(handle);
+        return update(bit, on ? bit : 0);
+    }
+
+    /**
+     * @brief Turn the rails in @p handles ON in one write; the others are not touched
+     *
+     * @param handles Handle mask (bit i = handle i)
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_ARG: unknown handle in @p handles
+     * @return ESP_ERR_INVALID_STATE: a rail in @p handles is not initialized
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     */
+    esp_err_t turn_on_mask(uint64_t handles) { return update(handles, handles); }
+
+    /**
+     * @brief Turn the rails in @p handles OFF in one write; the others are not touched
+     *
+     * @copydetails turn_on_mask()
+     */
+    esp_err_t turn_off_mask(uint64_t handles) { return update(handles, 0); }
+
+    /**
+     * @brief Apply the logical state of every initialized rail in one write
+     *
+     * Only the rails whose state changes are written.
+     *
+     * @param on_handles Handle mask of the rails to turn ON; the others are turned OFF
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_ARG: unknown handle in @p on_handles
+     * @return ESP_ERR_INVALID_STATE: a rail in @p on_handles is not initialized
+     * @return Other: error codes propagated from the underlying IGpioHAL implementation
+     */
+    esp_err_t apply_mask(uint64_t on_handles)
+    {
+        if ((on_handles & ~initialized_) != 0) {
+            return (on_handles & ~all_mask()) != 0 ? ESP_ERR_INVALID_ARG : ESP_ERR_INVALID_STATE;
+        }
+        return update(initialized_, on_handles);
+    }
+
+    /**
+     * @brief Logical state of one rail (false for an unknown handle)
+     */
+    bool is_on(Handle handle) const { return handle < count_ && (on_ & mask_of(handle)) != 0; }
+
+    /**
+     * @brief Check whether one rail is initialized
+     */
+    bool is_initialized(Handle handle) const { return handle < count_ && (initialized_ & mask_of(handle)) != 0; }
+
+    /**
+     * @brief GPIO of one rail (GPIO_NUM_NC for an unknown handle)
+     */
+    gpio_num_t get_pin(Handle handle) const
+    {
+        return handle < count_ ? static_cast<gpio_num_t>(pins_[handle]) : GPIO_NUM_NC;
+    }
+
+    /**
+     * @brief Handle mask of the rails that are ON
+     */
+    uint64_t get_on_mask() const { return on_ & initialized_; }
+
+    /**
+     * @brief Handle mask of the initialized rails
+     */
+    uint64_t get_initialized_mask() const { return initialized_; }
+
+    /**
+     * @brief Number of registered rails
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief Maximum number of rails
+     */
+    static constexpr size_t capacity() { return N; }
+
+    /**
+     * @brief Handle mask with only @p handle set
+     */
+    static constexpr uint64_t mask_of(Handle handle) { return 1ULL << handle; }
+
+private:
+    /// Handle mask of every registered rail
+    uint64_t all_mask() const { return count_ == 64 ? ~0ULL : (1ULL << count_) - 1; }
+
+    /**
+     * @brief GPIO mask of the rails in @p handles
+     */
+    uint64_t pins_of(uint64_t handles) const
+    {
+        uint64_t pins = 0;
+        for (; handles != 0; handles &= handles - 1) {
+            pins |= 1ULL << pins_[__builtin_ctzll(handles)];
+        }
+        return pins;
+    }
+
+    /**
+     * @brief Set the rails in @p handles to the state in @p on_handles, writing only the changes
+     */
+    esp_err_t update(uint64_t handles, uint64_t on_handles)
+    {
+        if ((handles & ~all_mask()) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if ((handles & ~initialized_) != 0) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        const uint64_t changed = handles & (on_ ^ on_handles);
+        if (changed == 0) {
+            return ESP_OK;
+        }
+        esp_err_t ret = write(changed, on_handles);
+        if (ret == ESP_OK) {
+            on_ = (on_ & ~changed) | (on_handles & changed);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Drive the rails in @p handles to the state in @p on_handles with one masked write
+     */
+    esp_err_t write(uint64_t handles, uint64_t on_handles)
+    {
+        // A rail is driven HIGH when ON and active HIGH, or OFF and active LOW
+        const uint64_t high = handles & (on_handles ^ inverted_);
+        return hal_.set_levels_mask(pins_of(high), pins_of(handles & ~high));
+    }
+
+    IGpioHAL &hal_; ///< HAL shared by every rail
+
+    uint8_t pins_[N] = {};     ///< GPIO of each rail, by handle
+    uint8_t count_ = 0;        ///< Number of registered rails
+    uint64_t pin_mask_ = 0;    ///< GPIOs in use (duplicate check)
+    uint64_t inverted_ = 0;    ///< Handle bitset: active LOW
+    uint64_t on_ = 0;          ///< Handle bitset: logical state (initial state before init())
+    uint64_t initialized_ = 0; ///< Handle bitset: initialized
+};
+} // namespace power_control
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "sdkconfig.h"
+
+#include "i_power_control.hpp"
+#include "i_timer_hal.hpp"
+#include "power_profile.hpp"
+
+// ========================================
+// Power Scheduler Implementation
+// ========================================
+
+namespace power_control {
+/**
+ * @struct PowerSchedule
+ * @brief Periodic duty cycle of one rail: ON for @ref on_us every @ref period_us
+ *
+ * Like PowerSequenceStep, schedules are plain aggregates and whole tables can be
+ * declared `constexpr`:
+ * @code
+ * constexpr PowerSchedule duty_table[] = {
+ *     PowerSchedule::every(soil_probe, 60000000, 200000),          // 200 ms every minute
+ *     PowerSchedule::every(air_sensor, 10000000, 50000, 5000000),  // 50 ms every 10 s, 5 s late
+ * };
+ * @endcode
+ */
+struct PowerSchedule
+{
+    IPowerControl *rail; ///< Rail to duty-cycle
+    uint64_t period_us;  ///< Cycle period
+    uint64_t on_us;      ///< ON time at the start of each cycle (0 = never, period_us = always)
+    uint64_t phase_us;   ///< Offset of the first cycle from PowerScheduler::start()
+
+    /** @brief Schedule turning @p rail ON for @p on_us every @p period_us, starting @p phase_us late */
+    static constexpr PowerSchedule every(
+        IPowerControl &rail,
+        uint64_t period_us,
+        uint64_t on_us,
+        uint64_t phase_us = 0)
+    {
+        return PowerSchedule{&rail, period_us, on_us, phase_us};
+    }
+};
+
+/**
+ * @class PowerScheduler
+ * @brief Duty-cycles many rails from a single one-shot timer
+ *
+ * Replaces one task per duty-cycled rail. The next switching time of every rail
+ * is kept in a binary min-heap, and one timer is always armed for the earliest
+ * of them. On expiry every event due within the coalescing window is handled in
+ * the same callback, turn-offs first, so rails switching together cost a single
+ * wake-up and never overlap their inrush with a rail just going down.
+ *
+ * Event times are derived from the start time and the periods, not from the time
+ * the callback actually ran, so callback latency does not accumulate into drift.
+ * Cycles missed entirely (e.g. while the timer task was blocked) are skipped, not
+ * replayed.
+ *
+ * Phases spread the ON windows to flatten the peak current: either set each
+ * PowerSchedule::phase_us, or call set_auto_stagger() to spread every rail evenly
+ * over its own period.
+ *
+ * With set_group(), the scheduled rails that belong to a PowerProfileGroup are
+ * switched by one PowerProfileGroup::apply_profile() per wake-up, i.e. one
+ * IGpioHAL::set_levels_mask() call for all of them, ahead of the other rails:
+ * @code
+ * PowerControl *const rails[] = {&soil_probe, &air_sensor};
+ * PowerProfileGroup group(rails);
+ * PowerScheduler scheduler(timer, duty_table);
+ * scheduler.set_group(&group);
+ * @endcode
+ *
+ * @note Rails are expected to be OFF when start() is called and must not be
+ *       switched directly while scheduled.
+ * @note Rail switching runs in the timer context (esp_timer task with TimerHAL).
+ *       stop() may be called while a wake-up runs there, including from a rail's
+ *       own turn_on()/turn_off(); otherwise call start(), stop() and the setters
+ *       from one task.
+ * @note At most CONFIG_POWER_CONTROL_SCHEDULER_MAX_RAILS schedules per scheduler.
+ * @see PowerSchedule
+ */
+class PowerScheduler
+{
+public:
+    /// Maximum number of schedules handled by one scheduler
+    static constexpr size_t MAX_RAILS = CONFIG_POWER_CONTROL_SCHEDULER_MAX_RAILS;
+
+    /**
+     * @brief Construct a new Power Scheduler instance
+     *
+     * @param timer Reference to the timer HAL driving the schedule
+     * @param schedules Schedule table; it is referenced, not copied, and must outlive the scheduler
+     * @param count Number of entries in @p schedules
+     */
+    PowerScheduler(ITimerHAL &timer, const PowerSchedule *schedules, size_t count);
+
+    /**
+     * @brief Construct a new Power Scheduler instance from an array
+     */
+    template <size_t N>
+    PowerScheduler(ITimerHAL &timer, const PowerSchedule (&schedules)[N])
+        : PowerScheduler(timer, schedules, N)
+    {
+        static_assert(N <= MAX_RAILS, "Raise CONFIG_POWER_CONTROL_SCHEDULER_MAX_RAILS");
+    }
+
+    ~PowerScheduler();
+
+    PowerScheduler(const PowerScheduler &) = delete;
+    PowerScheduler &operator=(const PowerScheduler &) = delete;
+
+    /**
+     * @brief Start duty-cycling every rail of the table
+     *
+     * Rails with no phase are switched ON in the caller's context.
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: already running
+     * @return ESP_ERR_INVALID_ARG: more than MAX_RAILS entries, an entry without a
+     *         rail, a zero period or an ON time longer than the period
+     * @return Other: error codes propagated from the timer HAL
+     */
+    esp_err_t start();
+
+    /**
+     * @brief Stop the schedule and switch OFF every rail it left ON
+     *
+     * If a wake-up is running in the timer context, the stop is handed to it: it
+     * applies no further events, switches the rails OFF when it ends, and only then
+     * lets start() run again. stop() returns ESP_OK at once in that case; switch
+     * failures are logged by the wake-up.
+     *
+     * @return ESP_OK on success, if not running, or if handed to a running wake-up
+     * @return Other: first error propagated from IPowerControl::turn_off()
+     */
+    esp_err_t stop();
+
+    /**
+     * @brief Check whether the schedule is running
+     */
+    bool is_running() const
+    {
+        const RunState state = state_.load(std::memory_order_acquire);
+        return state == RunState::ARMED || state == RunState::IN_WAKE;
+    }
+
+    /**
+     * @brief Handle events due within @p window_us after a wake-up in that same wake-up
+     *
+     * Events pulled in are applied up to @p window_us early. Default 0: only
+     * events due at the same time are coalesced. Takes effect on the next start().
+     */
+    void set_coalesce_window_us(uint32_t window_us) { coalesce_window_us_ = window_us; }
+
+    /**
+     * @brief Ignore PowerSchedule::phase_us and spread the rails evenly over their periods
+     *
+     * Entry i of n starts at period_us * i / n. Takes effect on the next start().
+     */
+    void set_auto_stagger(bool enable) { auto_stagger_ = enable; }
+
+    /**
+     * @brief Switch the scheduled rails of @p group together, in one masked write per wake-up
+     *
+     * Turn-offs and turn-ons of the group due in the same wake-up land in the same
+     * write. Rails outside the group are still switched one by one. If the write is
+     * refused (e.g. a rail latched OFF by a fault), that wake-up falls back to one
+     * call per rail, so only the refused rail misses its event. Takes effect on the
+     * next start(); a running schedule, and the stop() that ends it, keep the group
+     * it was started with.
+     *
+     * @param group Group of PowerControl rails on one HAL, or nullptr to switch every rail
+     *        separately; it must outlive the scheduler
+     */
+    void set_group(PowerProfileGroup *group) { group_ = group; }
+
+    /**
+     * @brief Number of rail switches that failed since start()
+     */
+    uint32_t get_error_count() const { return error_count_; }
+
+private:
+    /// Owner of the schedule state, claimed by CAS between stop() and the wake-ups
+    enum class RunState : uint8_t
+    {
+        STOPPED,      ///< Not running
+        ARMED,        ///< Running, no wake-up in progress
+        IN_WAKE,      ///< A wake-up (start() or the timer callback) owns the state
+        STOP_PENDING, ///< stop() was called during the wake-up, which carries it out
+    };
+
+    /**
+     * @brief Apply every event due by @p now_us, then re-arm the timer
+     */
+    esp_err_t run(int64_t now_us);
+
+    /**
+     * @brief Hand the state back after a wake-up, or carry out a stop() requested during it
+     */
+    void end_wake();
+
+    /**
+     * @brief Switch OFF every rail the schedule left ON
+     *
+     * @return ESP_OK, or the first error propagated from IPowerControl::turn_off()
+     */
+    esp_err_t switch_off_rails();
+
+    /// True once stop() has been called during the current wake-up
+    bool stop_pending() const { return state_.load(std::memory_order_acquire) == RunState::STOP_PENDING; }
+
+    /**
+     * @brief Switch the group rails of @p batch with one masked write
+     *
+     * Entries handled are replaced by HANDLED; on failure @p batch is left untouched.
+     */
+    void apply_group(uint8_t *batch, size_t batch_size, int64_t now_us);
+
+    /**
+     * @brief Switch schedule @p index and compute its next event
+     *
+     * @param switched The rail was already switched by a masked write
+     * @return true if the schedule has further events
+     */
+    bool apply_event(size_t index, int64_t now_us, bool switched = false);
+
+    /**
+     * @brief Arm the timer for the earliest pending event
+     */
+    esp_err_t arm(int64_t now_us);
+
+    /// Min-heap of schedule indexes ordered by next_us_
+    void heap_push(uint8_t index);
+    uint8_t heap_pop();
+    bool heap_less(size_t a, size_t b) const { return next_us_[heap_[a]] < next_us_[heap_[b]]; }
+
+    /**
+     * @brief Timer expiry handler
+     */
+    static void timer_cb(void *arg);
+
+    ITimerHAL &timer_;               ///< Timer HAL driving the schedule
+    const PowerSchedule *schedules_; ///< Schedule table
+    size_t count_;                   ///< Number of schedules
+
+    PowerProfileGroup *group_ = nullptr;             ///< Group set for the next start(), or nullptr
+    PowerProfileGroup *active_group_ = nullptr;      ///< Group of the current (or last) run
+    timer_handle_t timer_handle_ = nullptr;          ///< One-shot timer, created on first start()
+    uint32_t coalesce_window_us_ = 0;                ///< Events due this close are handled together
+    bool auto_stagger_ = false;                      ///< Spread phases evenly instead of phase_us
+    std::atomic<RunState> state_{RunState::STOPPED}; ///< Schedule state and its owner
+    uint32_t error_count_ = 0;                       ///< Failed switches since start()
+
+    int64_t next_us_[MAX_RAILS] = {};   ///< Next event time of each schedule
+    bool on_[MAX_RAILS] = {};           ///< Phase of each schedule (true = in its ON time)
+    bool rail_on_[MAX_RAILS] = {};      ///< Rails this scheduler switched ON and not yet OFF
+    uint8_t group_pin_[MAX_RAILS] = {}; ///< GPIO of each schedule in group_, 0xFF if outside
+    uint8_t heap_[MAX_RAILS] = {};      ///< Schedule indexes, earliest next_us_ first
+    size_t heap_size_ = 0;              ///< Pending events in heap_
+};
+} // namespace power_control
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "i_power_control.hpp"
+#include "i_timer_hal.hpp"
+
+// ========================================
+// Power Sequencer Implementation
+// ========================================
+
+namespace power_control {
+/**
+ * @struct PowerSequenceStep
+ * @brief One step of a power sequence: switch a rail after a delay
+ *
+ * Steps are plain aggregates, so whole sequence tables can be declared
+ * `constexpr` and live in flash when the rails have static storage:
+ * @code
+ * constexpr PowerSequenceStep afe_sequence[] = {
+ *     PowerSequenceStep::on(rail_3v3, 0),
+ *     PowerSequenceStep::on(rail_5v_analog, 200),
+ *     PowerSequenceStep::on(rail_vref, 1000),
+ * };
+ * @endcode
+ */
+struct PowerSequenceStep
+{
+    IPowerControl *rail; ///< Rail to switch
+    bool turn_on;        ///< true = turn the rail ON, false = OFF
+    uint32_t delay_us;   ///< Delay before this step, relative to the previous one
+
+    /** @brief Step that turns @p rail ON @p delay_us after the previous step */
+    static constexpr PowerSequenceStep on(IPowerControl &rail, uint32_t delay_us = 0)
+    {
+        return PowerSequenceStep{&rail, true, delay_us};
+    }
+
+    /** @brief Step that turns @p rail OFF @p delay_us after the previous step */
+    static constexpr PowerSequenceStep off(IPowerControl &rail, uint32_t delay_us = 0)
+    {
+        return PowerSequenceStep{&rail, false, delay_us};
+    }
+};
+
+/**
+ * @class PowerSequencer
+ * @brief Runs an ordered multi-rail bring-up/tear-down without blocking
+ *
+ * The sequencer walks a table of PowerSequenceStep from a one-shot timer state
+ * machine: steps with no delay run back-to-back, and each delay re-arms the timer
+ * and returns, so the caller is never blocked. Tear-down runs the table in reverse
+ * with every action inverted and the same spacing between steps.
+ *
+ * If a step fails, the rails already switched by the current run are switched back
+ * in reverse order and the completion callback reports the failing step's error.
+ *
+ * @note Steps with no leading delay, and possibly the completion callback, run in
+ *       the caller's context. Later steps run in the timer context.
+ * @note This implementation is not thread-safe. External synchronization is
+ *       required if used from multiple tasks.
+ * @see PowerSequenceStep
+ */
+class PowerSequencer
+{
+public:
+    /**
+     * @brief Completion callback of a sequence run
+     *
+     * @param result ESP_OK, or the error of the step that failed (after unwinding)
+     * @param ctx User context passed to power_up()/power_down()
+     */
+    using done_callback_t = void (*)(esp_err_t result, void *ctx);
+
+    /**
+     * @brief Construct a new Power Sequencer instance
+     *
+     * @param timer Reference to the timer HAL used to schedule delays
+     * @param steps Sequence table; it is referenced, not copied, and must outlive the sequencer
+     * @param count Number of entries in @p steps
+     */
+    PowerSequencer(ITimerHAL &timer, const PowerSequenceStep *steps, size_t count);
+
+    /**
+     * @brief Construct a new Power Sequencer instance from an array
+     */
+    template <size_t N>
+    PowerSequencer(ITimerHAL &timer, const PowerSequenceStep (&steps)[N])
+        : PowerSequencer(timer, steps, N)
+    {
+    }
+
+    ~PowerSequencer();
+
+    PowerSequencer(const PowerSequencer &) = delete;
+    PowerSequencer &operator=(const PowerSequencer &) = delete;
+
+    /**
+     * @brief Run the table forward
+     *
+     * @param callback Called once the run completes or fails (may be nullptr)
+     * @param ctx User context passed to @p callback
+     * @return ESP_OK if the run was started
+     * @return ESP_ERR_INVALID_STATE: a run is already in progress
+     * @return ESP_ERR_INVALID_ARG: a step has no rail
+     * @return Other: error codes propagated from the timer HAL
+     *
+     * @note Step failures are reported through @p callback, not by this return value
+     */
+    esp_err_t power_up(done_callback_t callback, void *ctx);
+
+    /**
+     * @brief Run the table in reverse with every action inverted
+     *
+     * @copydetails power_up()
+     */
+    esp_err_t power_down(done_callback_t callback, void *ctx);
+
+    /**
+     * @brief Stop a run in progress, leaving the rails as they are
+     *
+     * @return ESP_OK on success or if no run is in progress
+     */
+    esp_err_t cancel();
+
+    /**
+     * @brief Check whether a run is in progress
+     */
+    bool is_running() const { return running_; }
+
+    /**
+     * @brief Number of steps of the current (or last) run that were applied
+     */
+    size_t get_position() const { return position_; }
+
+private:
+    /**
+     * @brief Start a run in the given direction
+     */
+    esp_err_t start(bool forward, done_callback_t callback, void *ctx);
+
+    /**
+     * @brief Execute steps until a delay is needed or the run ends
+     */
+    void run();
+
+    /**
+     * @brief Apply step @p index of the current run, or its inverse when @p undo is set
+     */
+    esp_err_t apply_step(size_t index, bool undo);
+
+    /**
+     * @brief Delay before step @p index of the current run
+     */
+    uint32_t delay_before(size_t index) const;
+
+    /**
+     * @brief End the current run and notify the caller
+     */
+    void finish(esp_err_t result);
+
+    /**
+     * @brief Timer expiry handler
+     */
+    static void timer_cb(void *arg);
+
+    ITimerHAL &timer_;               ///< Timer HAL used to schedule delays
+    const PowerSequenceStep *steps_; ///< Sequence table
+    size_t count_;                   ///< Number of steps
+
+    timer_handle_t timer_handle_ = nullptr; ///< One-shot timer, created on first run
+    done_callback_t callback_ = nullptr;    ///< Completion callback of the current run
+    void *ctx_ = nullptr;                   ///< Context of the completion callback
+    size_t position_ = 0;                   ///< Steps of the current run already applied
+    bool forward_ = true;                   ///< Direction of the current run
+    bool waited_ = false;                   ///< Delay before the next step has elapsed
+    bool running_ = false;                  ///< A run is in progress
+};
+} // namespace power_control
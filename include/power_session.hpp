@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esp_err.h"
+
+#include "i_power_control.hpp"
+#include "i_timer_hal.hpp"
+#include "shared_power_control.hpp"
+
+// ========================================
+// Power Session (RAII)
+// ========================================
+
+namespace power_control {
+/**
+ * @class PowerSession
+ * @brief Scoped use of a rail: ON when acquired, OFF (or released) when destroyed
+ *
+ * acquire() turns the rail ON and starts its settle countdown; the destructor
+ * turns it OFF again, or drops the reference for a SharedPowerControl, on every
+ * path out of the scope. An early error return can therefore no longer leave a
+ * sensor powered.
+ *
+ * wait_ready() blocks only for the part of the settle time that is left, so
+ * several sessions opened back-to-back warm up in parallel and the total wait is
+ * the longest settle time, not the sum:
+ * @code
+ * PowerSession imu, baro;
+ * ESP_ERROR_CHECK(PowerSession::acquire(imu_rail, timer, 20000, imu));   // 20 ms warm-up
+ * ESP_ERROR_CHECK(PowerSession::acquire(baro_rail, timer, 5000, baro));  // 5 ms, overlapped
+ *
+ * baro.wait_ready();  // ~5 ms
+ * read_baro();
+ * imu.wait_ready();   // ~15 ms left
+ * read_imu();
+ * // Both rails OFF when the sessions go out of scope
+ * @endcode
+ *
+ * Sessions are move-only; a moved-from session is empty and does nothing.
+ *
+ * @note The rail must be initialized and must outlive the session.
+ * @note A rail that was already ON when the session was acquired is treated as
+ *       settled. Its session still switches it OFF at the end (IPowerControl).
+ */
+class PowerSession
+{
+public:
+    /**
+     * @brief Construct an empty session, to be filled by acquire()
+     */
+    PowerSession() = default;
+
+    /**
+     * @brief Release the rail, if the session holds one
+     */
+    ~PowerSession() { release(); }
+
+    PowerSession(PowerSession &&other);
+    PowerSession &operator=(PowerSession &&other);
+
+    PowerSession(const PowerSession &) = delete;
+    PowerSession &operator=(const PowerSession &) = delete;
+
+    /**
+     * @brief Turn @p rail ON and start its settle countdown
+     *
+     * @param rail Rail to power; turned OFF when the session ends
+     * @param timer Timer HAL measuring and waiting the settle time
+     * @param settle_us Time the powered device needs before it can be used
+     * @param[out] session Receives the rail; a rail it held before is released first
+     * @return ESP_OK on success
+     * @return Other: error codes propagated from IPowerControl::turn_on(); @p session is left empty
+     */
+    static esp_err_t acquire(IPowerControl &rail, ITimerHAL &timer, uint32_t settle_us, PowerSession &session);
+
+    /**
+     * @brief Take a reference on @p shared and start its settle countdown
+     *
+     * @param shared Shared rail; the reference is released when the session ends
+     * @param timer Timer HAL measuring and waiting the settle time
+     * @param settle_us Time the powered device needs before it can be used
+     * @param[out] session Receives the reference; a rail it held before is released first
+     * @return ESP_OK on success
+     * @return Other: error codes propagated from SharedPowerControl::acquire(); @p session is left empty
+     */
+    static esp_err_t acquire(SharedPowerControl &shared, ITimerHAL &timer, uint32_t settle_us, PowerSession &session);
+
+    /**
+     * @brief Block until the settle time of the rail has elapsed
+     *
+     * Only the remaining part of the settle time is waited; returns at once if it
+     * has already elapsed.
+     *
+     * @return ESP_OK when the rail is ready
+     * @return ESP_ERR_INVALID_STATE: empty session
+     */
+    esp_err_t wait_ready();
+
+    /**
+     * @brief Time left until the rail is ready, 0 once settled or for an empty session
+     */
+    int64_t get_remaining_us() const;
+
+    /**
+     * @brief Check whether the settle time has elapsed (false for an empty session)
+     */
+    bool is_ready() const { return is_active() && get_remaining_us() == 0; }
+
+    /**
+     * @brief Check whether the session holds a rail
+     */
+    bool is_active() const { return rail_ != nullptr || shared_ != nullptr; }
+
+    /**
+     * @brief End the session early: turn the rail OFF or drop the reference
+     *
+     * @return ESP_OK on success or for an empty session
+     * @return Other: error codes propagated from IPowerControl::turn_off() or
+     *         SharedPowerControl::release(); the session is empty afterwards anyway
+     */
+    esp_err_t release();
+
+private:
+    IPowerControl *rail_ = nullptr;        ///< Rail switched OFF at the end, or nullptr
+    SharedPowerControl *shared_ = nullptr; ///< Shared rail released at the end, or nullptr
+    ITimerHAL *timer_ = nullptr;           ///< Timer HAL of the settle countdown
+    int64_t ready_at_us_ = 0;              ///< Time at which the rail is ready
+};
+} // namespace power_control
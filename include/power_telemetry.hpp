@@ -0,0 +1,179 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+#if CONFIG_POWER_CONTROL_TELEMETRY
+
+#include <cstddef>
+#include <cstdint>
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+#include "i_power_control.hpp"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include "i_timer_hal.hpp"
+#endif
+
+// ========================================
+// Rail Telemetry
+// ========================================
+
+namespace power_control {
+/**
+ * @struct PowerTelemetryRail
+ * @brief Counters of one rail, as copied by PowerTelemetry::snapshot()
+ */
+struct PowerTelemetryRail
+{
+    uint64_t on_time_us; ///< Cumulative ON time, including the current period
+    uint32_t on_count;   ///< OFF -> ON transitions
+    uint32_t off_count;  ///< ON -> OFF transitions
+    uint8_t gpio;        ///< GPIO pin number
+    uint8_t on;          ///< Logical state (1 = ON)
+    PowerFault fault;    ///< Latched protection fault
+};
+
+/**
+ * @struct PowerTelemetrySnapshot
+ * @brief Consistent copy of every rail registered with PowerTelemetry
+ */
+struct PowerTelemetrySnapshot
+{
+    int64_t time_us;     ///< esp_timer_get_time() when the snapshot was taken
+    uint32_t rail_count; ///< Valid entries in rails
+    /// Rails in slot order
+    PowerTelemetryRail rails[CONFIG_POWER_CONTROL_TELEMETRY_MAX_RAILS];
+};
+
+/**
+ * @class PowerTelemetry
+ * @brief Component-wide table of per-rail counters, readable without blocking writers
+ *
+ * Enabled with CONFIG_POWER_CONTROL_TELEMETRY. Every PowerControl registers itself
+ * on init() and keeps its slot until it is destroyed. Each transition, from task or
+ * ISR, then updates the slot of its rail in place: ON/OFF counts, accumulated ON
+ * time and the latched fault. A telemetry task copies the whole table with
+ * snapshot() and ships it with serialize():
+ * @code
+ * PowerTelemetrySnapshot snap;
+ * uint8_t frame[PowerTelemetry::MAX_FRAME_SIZE];
+ * PowerTelemetry::snapshot(snap);
+ * size_t len = PowerTelemetry::serialize(snap, frame, sizeof(frame));
+ * esp_now_send(gateway_mac, frame, len);
+ * @endcode
+ *
+ * Each slot is a seqlock: the writer claims it by making its sequence number odd
+ * (compare-and-swap), updates the counters and makes it even again, which costs a
+ * few dozen cycles and never waits. A transition recorded while another writer
+ * holds the slot, such as the fault ISR cutting a rail in the middle of its
+ * task's record(), is queued in the slot and applied by that writer before it
+ * lets go. The latched fault is a single value kept outside the seqlock. The
+ * reader copies a slot and retries if the sequence number changed meanwhile; it
+ * never blocks a writer, even one running in an ISR.
+ *
+ * @note The table holds CONFIG_POWER_CONTROL_TELEMETRY_MAX_RAILS slots of 32 bytes
+ *       each (counters plus sequence number), in internal RAM. Rails initialized
+ *       once the table is full are not covered.
+ */
+class PowerTelemetry
+{
+public:
+    /// Number of rails covered
+    static constexpr size_t MAX_RAILS = CONFIG_POWER_CONTROL_TELEMETRY_MAX_RAILS;
+    static_assert(MAX_RAILS <= 64, "CONFIG_POWER_CONTROL_TELEMETRY_MAX_RAILS must not exceed 64");
+
+    /// Returned by attach() when the table is full
+    static constexpr uint8_t NO_SLOT = 0xFF;
+
+    /// Version byte at the start of a serialized frame
+    static constexpr uint8_t FRAME_VERSION = 1;
+    /// Serialized frame header: version, rail count, 2 reserved bytes, time_us
+    static constexpr size_t FRAME_HEADER_SIZE = 12;
+    /// Serialized rail: gpio, state (bit 0 ON, bits 4-7 PowerFault), on_count, on_time_us
+    static constexpr size_t FRAME_RAIL_SIZE = 14;
+    /// Size of a frame carrying every slot
+    static constexpr size_t MAX_FRAME_SIZE = FRAME_HEADER_SIZE + MAX_RAILS * FRAME_RAIL_SIZE;
+
+    PowerTelemetry() = delete;
+
+    /**
+     * @brief Claim a slot for the rail on @p gpio, OFF and with zeroed counters
+     *
+     * @return Slot index, or NO_SLOT if every slot is in use
+     */
+    static uint8_t attach(gpio_num_t gpio);
+
+    /**
+     * @brief Release a slot claimed by attach() (NO_SLOT is ignored)
+     */
+    static void detach(uint8_t slot);
+
+    /**
+     * @brief Record a transition of the rail in @p slot (IRAM, ISR-safe)
+     *
+     * @param slot Slot returned by attach() (NO_SLOT is ignored)
+     * @param on New logical state; must differ from the recorded one
+     */
+    static void record(uint8_t slot, bool on);
+
+    /**
+     * @brief Record the latched fault of the rail in @p slot (IRAM, ISR-safe)
+     *
+     * @param slot Slot returned by attach() (NO_SLOT is ignored)
+     * @param fault Latched fault, PowerFault::NONE once cleared
+     */
+    static void record_fault(uint8_t slot, PowerFault fault);
+
+    /**
+     * @brief Copy every registered rail in one pass
+     *
+     * A slot rewritten while it is copied is read again, a bounded number of times,
+     * so the call cannot be held up by a busy rail; a slot still not read
+     * consistently is left out.
+     *
+     * @param[out] out Destination; on_time_us includes the ON period in progress
+     * @return Number of rails copied (out.rail_count)
+     */
+    static size_t snapshot(PowerTelemetrySnapshot &out);
+
+    /**
+     * @brief Encode @p snapshot into a fixed-layout, little-endian frame
+     *
+     * A FRAME_HEADER_SIZE header (FRAME_VERSION, rail count, two zero bytes,
+     * int64 time_us) is followed by FRAME_RAIL_SIZE bytes per rail (gpio, state
+     * byte, uint32 on_count, uint64 on_time_us). off_count is not sent: it is
+     * on_count minus the ON bit.
+     *
+     * @param snapshot Snapshot to encode
+     * @param buf Destination buffer
+     * @param len Capacity of @p buf
+     * @return Bytes written, or 0 if @p buf is too small
+     */
+    static size_t serialize(const PowerTelemetrySnapshot &snapshot, uint8_t *buf, size_t len);
+
+    /**
+     * @brief Decode a frame written by serialize()
+     *
+     * @param buf Received frame
+     * @param len Length of the frame
+     * @param[out] out Decoded snapshot
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_VERSION: unknown frame version
+     * @return ESP_ERR_INVALID_SIZE: truncated frame or more rails than MAX_RAILS
+     */
+    static esp_err_t deserialize(const uint8_t *buf, size_t len, PowerTelemetrySnapshot &out);
+
+#if CONFIG_IDF_TARGET_LINUX
+    /**
+     * @brief Timestamp source for host builds (esp_timer is mocked there)
+     *
+     * @param timer Timer HAL read by record() and snapshot(), or nullptr for a zero timestamp
+     */
+    static void set_timer(ITimerHAL *timer);
+#endif
+};
+} // namespace power_control
+
+#endif // CONFIG_POWER_CONTROL_TELEMETRY
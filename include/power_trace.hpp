@@ -0,0 +1,119 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+#if CONFIG_POWER_CONTROL_TRACE
+
+#include <cstddef>
+#include <cstdint>
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include "i_timer_hal.hpp"
+#endif
+
+// ========================================
+// Rail Transition Trace
+// ========================================
+
+namespace power_control {
+/**
+ * @struct PowerTraceRecord
+ * @brief One rail transition captured by PowerTrace
+ */
+struct PowerTraceRecord
+{
+    int64_t time_us;  ///< esp_timer_get_time() at the write
+    uint32_t index;   ///< Sequence number since boot (gaps = overwritten records)
+    esp_err_t result; ///< Result of the write
+    uint8_t gpio;     ///< GPIO pin number
+    uint8_t on;       ///< New logical state (1 = ON)
+    uint8_t core;     ///< CPU core that made the write
+};
+
+/**
+ * @class PowerTrace
+ * @brief Component-wide, fixed-size ring of rail transitions
+ *
+ * Enabled with CONFIG_POWER_CONTROL_TRACE. Every PowerControl write, from task or
+ * ISR, appends one record with its timestamp, pin, new state, result and CPU core,
+ * so rail activity can be lined up with radio TX, ADC sampling or a brownout.
+ *
+ * Recording claims a slot with one atomic increment and publishes it with a
+ * per-slot sequence number: it never blocks, never allocates and costs a few
+ * dozen cycles. When the ring is full the oldest records are overwritten; readers
+ * skip a slot that is being rewritten while they copy it.
+ *
+ * @note The ring holds CONFIG_POWER_CONTROL_TRACE_DEPTH records of 32 bytes each
+ *       (record plus sequence number), in internal RAM.
+ */
+class PowerTrace
+{
+public:
+    /// Number of records kept
+    static constexpr size_t DEPTH = CONFIG_POWER_CONTROL_TRACE_DEPTH;
+    static_assert((DEPTH & (DEPTH - 1)) == 0, "CONFIG_POWER_CONTROL_TRACE_DEPTH must be a power of two");
+
+    PowerTrace() = delete;
+
+    /**
+     * @brief Append one transition (IRAM, ISR-safe)
+     */
+    static void record(gpio_num_t gpio, bool on, esp_err_t result);
+
+    /**
+     * @brief Copy the records still in the ring, oldest first
+     *
+     * @param out Destination array
+     * @param max Capacity of @p out
+     * @return Number of records copied
+     */
+    static size_t snapshot(PowerTraceRecord *out, size_t max);
+
+    /**
+     * @brief Print the records still in the ring to the console, oldest first
+     *
+     * Uses printf(), independently of the component log level.
+     */
+    static void dump();
+
+#if CONFIG_APPTRACE_ENABLE
+    /**
+     * @brief Send the records still in the ring to the host through esp_app_trace
+     *
+     * Records are written as a raw array of PowerTraceRecord, oldest first, so
+     * they can be merged with a SystemView or app_trace capture on the host.
+     *
+     * @param timeout_us Maximum time to wait for the trace channel
+     * @return ESP_OK on success
+     * @return Other: error codes propagated from esp_apptrace_write()/esp_apptrace_flush()
+     */
+    static esp_err_t export_apptrace(uint32_t timeout_us);
+#endif
+
+    /**
+     * @brief Drop every record
+     *
+     * @note Not safe against concurrent record() calls
+     */
+    static void clear();
+
+    /**
+     * @brief Total number of records written since boot or clear()
+     */
+    static uint32_t get_total();
+
+#if CONFIG_IDF_TARGET_LINUX
+    /**
+     * @brief Timestamp source for host builds (esp_timer is mocked there)
+     *
+     * @param timer Timer HAL read by record(), or nullptr for a zero timestamp
+     */
+    static void set_timer(ITimerHAL *timer);
+#endif
+};
+} // namespace power_control
+
+#endif // CONFIG_POWER_CONTROL_TRACE
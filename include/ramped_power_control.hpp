@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "i_gpio_hal.hpp"
+#include "i_ledc_hal.hpp"
+#include "i_power_control.hpp"
+#include "i_timer_hal.hpp"
+
+// ========================================
+// Ramped Power Control Implementation
+// ========================================
+
+namespace power_control {
+/**
+ * @class RampedPowerControl
+ * @brief IPowerControl implementation with a PWM soft-start for high-inrush loads
+ *
+ * turn_on() does not switch the gate in one step. The pin is routed to a PWM
+ * channel at 0 % duty and an ILedcHAL hardware fade raises the duty to 100 % over
+ * the configured ramp time, so the bulk capacitance of the load charges gradually
+ * instead of browning out the supply. When the ramp time has elapsed a one-shot
+ * timer drives the GPIO output register to the ON level and routes the pin back
+ * to plain GPIO, then stops the PWM channel. The CPU is only involved at the
+ * start and at the hand-off.
+ *
+ * turn_off() is immediate; a ramp in progress is aborted.
+ *
+ * @code
+ * GpioHAL gpio;
+ * LedcHAL ledc(LEDC_CHANNEL_0, LEDC_TIMER_0, 20000);
+ * TimerHAL timer;
+ * RampedPowerControl motor(gpio, ledc, timer, GPIO_NUM_4, false, false, 20); // 20 ms soft-start
+ *
+ * motor.init();
+ * motor.turn_on();   // Returns at once; the duty ramps in hardware
+ * @endcode
+ *
+ * @note is_on() reports the requested state and is true during the ramp;
+ *       is_ramping() tells whether the hand-off to GPIO is still pending.
+ * @note This implementation is not thread-safe. The hand-off runs from the timer
+ *       context (esp_timer task with TimerHAL); it is claimed atomically, so a
+ *       turn_off() racing it still leaves the rail OFF.
+ * @see PowerControl for instant switching
+ */
+class RampedPowerControl : public IPowerControl
+{
+public:
+    /**
+     * @brief Construct a new Ramped Power Control instance
+     *
+     * @param hal Reference to the GPIO HAL used for init and after the ramp
+     * @param ledc Reference to the PWM HAL performing the ramp
+     * @param timer Reference to the timer HAL scheduling the hand-off to GPIO
+     * @param gpio GPIO pin number to control
+     * @param inverted_logic true = active LOW, false = active HIGH
+     * @param initial_on Initial logical state after init() (ramped if ON)
+     * @param ramp_time_ms Duration of the 0 to 100 % duty ramp (0 = switch instantly)
+     *
+     * @note The component is not initialized until init() is called
+     */
+    RampedPowerControl(
+        IGpioHAL &hal,
+        ILedcHAL &ledc,
+        ITimerHAL &timer,
+        const gpio_num_t gpio,
+        const bool inverted_logic = false,
+        const bool initial_on = false,
+        const uint32_t ramp_time_ms = 10);
+
+    ~RampedPowerControl() override;
+
+    RampedPowerControl(const RampedPowerControl &) = delete;
+    RampedPowerControl &operator=(const RampedPowerControl &) = delete;
+
+    /// @copydoc IPowerControl::init()
+    esp_err_t init() override;
+
+    /// @copydoc IPowerControl::deinit()
+    esp_err_t deinit() override;
+
+    /// @copydoc IPowerControl::set_drive_capability()
+    esp_err_t set_drive_capability(gpio_drive_cap_t strength) override;
+
+    /**
+     * @brief Start the soft-start ramp
+     *
+     * Returns as soon as the hardware fade is started. Calling it while the rail
+     * is ON or ramping does nothing.
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: Component not initialized
+     * @return Other: error codes propagated from the LEDC, GPIO or timer HAL
+     */
+    esp_err_t turn_on() override;
+
+    /**
+     * @brief Switch the rail OFF at once, aborting a ramp in progress
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: Component not initialized
+     * @return Other: error codes propagated from the GPIO or LEDC HAL
+     */
+    esp_err_t turn_off() override;
+
+    /// @copydoc IPowerControl::toggle()
+    esp_err_t toggle() override;
+
+    /// @copydoc IPowerControl::is_on()
+    bool is_on() const override { return is_on_.load(std::memory_order_acquire); }
+
+    /// @copydoc IPowerControl::is_initialized()
+    bool is_initialized() const override { return initialized_; }
+
+    /// @copydoc IPowerControl::get_pin()
+    gpio_num_t get_pin() const override { return gpio_; }
+
+    /**
+     * @brief Check whether the pin is still driven by the PWM ramp
+     */
+    bool is_ramping() const { return ramping_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Ramp duration in milliseconds
+     */
+    uint32_t get_ramp_time_ms() const { return ramp_time_ms_; }
+
+private:
+    /**
+     * @brief Write a physical level to the GPIO output register and route the pin to GPIO
+     */
+    esp_err_t drive_gpio(bool level);
+
+    /**
+     * @brief End the ramp: the pin goes back to GPIO at @p level and the PWM channel stops
+     *
+     * The caller must have claimed the hand-off by clearing ramping_ with an exchange,
+     * so that the timer callback and turn_off() never both drive the final level.
+     */
+    esp_err_t end_ramp(bool level);
+
+    /**
+     * @brief Hand-off timer expiry handler
+     */
+    static void ramp_timer_cb(void *arg);
+
+    IGpioHAL &hal_;               ///< GPIO HAL instance
+    ILedcHAL &ledc_;              ///< PWM HAL instance
+    ITimerHAL &timer_;            ///< Timer HAL for the hand-off
+    gpio_num_t gpio_;             ///< GPIO pin number
+    bool inverted_logic_;         ///< true = active LOW, false = active HIGH
+    bool initial_on_;             ///< Initial state to apply after init
+    const uint32_t ramp_time_ms_; ///< Ramp duration
+
+    timer_handle_t ramp_timer_ = nullptr; ///< Hand-off timer, created by init()
+    bool initialized_ = false;            ///< Initialization state
+    std::atomic<bool> is_on_{false};      ///< Requested logical state
+    std::atomic<bool> ramping_{false};    ///< PWM ramp in progress
+};
+} // namespace power_control
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "i_power_control.hpp"
+#include "i_timer_hal.hpp"
+
+// ========================================
+// Shared Power Control Implementation
+// ========================================
+
+namespace power_control {
+/**
+ * @class SharedPowerControl
+ * @brief Reference-counted access to a rail shared by several consumers
+ *
+ * Each consumer calls acquire() before using the rail and release() when done.
+ * The rail is turned ON by the first acquire() and OFF by the last release(), so
+ * drivers sharing a rail no longer have to know about each other.
+ *
+ * The reference count, the applied state and a "switching" flag are packed in one
+ * atomic word updated with compare-and-swap, so acquire() and release() can be
+ * called from any task on either core without a mutex. Only the task that makes
+ * the 0 -> 1 or 1 -> 0 transition touches the underlying rail; a task that finds
+ * another one in the middle of a switch waits for it to finish, so acquire()
+ * always returns with the rail ON.
+ *
+ * With a linger time, the last release() leaves the rail ON and arms a one-shot
+ * timer. An acquire() before it expires reuses the rail without a power cycle.
+ *
+ * @code
+ * SharedPowerControl sensor_bus(rail, timer, 50000); // 50 ms linger
+ *
+ * // In each sensor driver
+ * sensor_bus.acquire();
+ * read_sensor();
+ * sensor_bus.release();
+ * @endcode
+ *
+ * @note The wrapped rail must be initialized before the first acquire() and
+ *       must not be switched directly while it is shared.
+ * @note Not ISR-safe: the underlying rail may log and the wait uses vTaskDelay().
+ * @see IPowerControl
+ */
+class SharedPowerControl
+{
+public:
+    /**
+     * @brief Construct a shared rail without linger
+     *
+     * @param rail Rail to share; it must outlive this object
+     */
+    explicit SharedPowerControl(IPowerControl &rail);
+
+    /**
+     * @brief Construct a shared rail with a linger time after the last release
+     *
+     * @param rail Rail to share; it must outlive this object
+     * @param timer Timer HAL used for the linger timer
+     * @param linger_us Time the rail stays ON after the last release (0 = none)
+     */
+    SharedPowerControl(IPowerControl &rail, ITimerHAL &timer, uint32_t linger_us);
+
+    ~SharedPowerControl();
+
+    SharedPowerControl(const SharedPowerControl &) = delete;
+    SharedPowerControl &operator=(const SharedPowerControl &) = delete;
+
+    /**
+     * @brief Take a reference, turning the rail ON if it was OFF
+     *
+     * @return ESP_OK on success; the rail is ON when this returns
+     * @return ESP_ERR_INVALID_STATE: reference count overflow
+     * @return Other: error codes propagated from the timer HAL (linger timer creation)
+     * @return Other: error codes propagated from IPowerControl::turn_on()
+     *
+     * @note On failure no reference is taken
+     */
+    esp_err_t acquire();
+
+    /**
+     * @brief Drop a reference, turning the rail OFF (or arming the linger timer) on the last one
+     *
+     * @return ESP_OK on success
+     * @return ESP_ERR_INVALID_STATE: no reference is held
+     * @return Other: error codes propagated from IPowerControl::turn_off() or the timer HAL
+     *
+     * @note The reference is dropped even if turning the rail OFF fails; the next
+     *       last release() tries again
+     */
+    esp_err_t release();
+
+    /**
+     * @brief Number of references currently held
+     */
+    uint32_t get_ref_count() const { return state_.load(std::memory_order_acquire) & REF_MASK; }
+
+    /**
+     * @brief Check whether the rail was left ON by this object (held or lingering)
+     */
+    bool is_on() const { return (state_.load(std::memory_order_acquire) & ON_BIT) != 0; }
+
+    /**
+     * @brief Linger time after the last release, in microseconds
+     */
+    uint32_t get_linger_us() const { return linger_us_; }
+
+private:
+    static constexpr uint32_t REF_MASK = 0x3FFFFFFF;    ///< Reference count bits
+    static constexpr uint32_t ON_BIT = 1u << 30;        ///< Rail left ON by this object
+    static constexpr uint32_t SWITCHING_BIT = 1u << 31; ///< A task is switching the rail
+
+    /**
+     * @brief Turn the rail OFF if no reference is held (linger expiry)
+     */
+    esp_err_t switch_off_if_idle();
+
+    /**
+     * @brief Back off while another task is switching the rail
+     */
+    static void wait_for_switch(uint32_t &spins);
+
+    /**
+     * @brief Linger timer expiry handler
+     */
+    static void linger_timer_cb(void *arg);
+
+    IPowerControl &rail_;      ///< Shared rail
+    ITimerHAL *timer_;         ///< Timer HAL for linger, or nullptr
+    const uint32_t linger_us_; ///< Linger time after the last release
+
+    /// Linger timer, created by the first switch ON (only written while SWITCHING_BIT is held)
+    timer_handle_t linger_timer_ = nullptr;
+    std::atomic<uint32_t> state_{0}; ///< Reference count | ON_BIT | SWITCHING_BIT
+};
+} // namespace power_control
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+
+#include "sdkconfig.h"
+
+#include "gpio_hal.hpp"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "soc/soc_caps.h"
+#endif
+
+// ========================================
+// Static Power Control Implementation
+// ========================================
+
+namespace power_control {
+/**
+ * @class StaticPowerControl
+ * @brief Compile-time configured power control with no runtime dispatch
+ *
+ * Offers the same public API as PowerControl, but the GPIO pin and the logic
+ * polarity are template parameters. Pin mask and set/clear registers are folded
+ * into constants, there is no vtable and no runtime inverted-logic branch. With
+ * the default GpioHAL backend, turn_on() and turn_off() inline down to a single
+ * store to the GPIO W1TS or W1TC register.
+ *
+ * Use PowerControl when the pin or polarity is only known at runtime, or when the
+ * rail must be handled through IPowerControl (e.g. injected into other classes or
+ * mocked in tests).
+ *
+ * @tparam Pin GPIO pin number to control
+ * @tparam Inverted true = active LOW, false = active HIGH
+ * @tparam Hal HAL type; calls are resolved statically, so a `final` class such as
+ *             GpioHAL is fully inlined
+ *
+ * @note This implementation is not thread-safe. External synchronization is
+ *       required if used from multiple tasks.
+ * @see PowerControl for the runtime-configurable implementation
+ */
+template <gpio_num_t Pin, bool Inverted, class Hal = GpioHAL>
+class StaticPowerControl
+{
+    static_assert(Pin >= 0 && Pin < GPIO_NUM_MAX, "Invalid GPIO number");
+#if !CONFIG_IDF_TARGET_LINUX
+    static_assert((SOC_GPIO_VALID_OUTPUT_GPIO_MASK & (1ULL << Pin)) != 0, "GPIO cannot be used as output");
+#endif
+
+public:
+    static constexpr uint64_t PIN_MASK = 1ULL << Pin;                  ///< Bit of the controlled GPIO
+    static constexpr uint64_t ON_SET_MASK = Inverted ? 0 : PIN_MASK;   ///< W1TS mask for ON
+    static constexpr uint64_t ON_CLEAR_MASK = Inverted ? PIN_MASK : 0; ///< W1TC mask for ON
+
+    /**
+     * @brief Construct a new Static Power Control instance
+     *
+     * @param hal Reference to the HAL implementation for hardware access
+     * @param initial_on Initial logical state after init()
+     *
+     * @note The component is not initialized until init() is called
+     */
+    explicit StaticPowerControl(Hal &hal, const bool initial_on = false)
+        : hal_(hal)
+        , initial_on_(initial_on)
+    {
+    }
+
+    /// @copydoc IPowerControl::init()
+    esp_err_t init()
+    {
+        if (initialized_) {
+            return ESP_OK;
+        }
+
+        // Reset GPIO before initialization
+        esp_err_t ret = hal_.reset_pin(Pin);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+
+        // Set GPIO as output
+        gpio_config_t io_conf = {};
+        io_conf.mode = GPIO_MODE_INPUT_OUTPUT;
+        io_conf.pin_bit_mask = PIN_MASK;
+        io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+        io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+        io_conf.intr_type = GPIO_INTR_DISABLE;
+
+        ret = hal_.config(io_conf);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+
+        initialized_ = true;
+        return initial_on_ ? turn_on() : turn_off();
+    }
+
+    /// @copydoc IPowerControl::deinit()
+    esp_err_t deinit()
+    {
+        if (!initialized_) {
+            return ESP_OK;
+        }
+
+        // Force GPIO low before deinitialization for safety
+        esp_err_t final_ret = hal_.set_levels_mask(0, PIN_MASK);
+
+        // Reset GPIO (returns to high-impedance state)
+        esp_err_t ret = hal_.reset_pin(Pin);
+        if (final_ret == ESP_OK) {
+            final_ret = ret; // Only override if no previous error
+        }
+
+        // Mark as deinitialized regardless of hardware errors
+        initialized_ = false;
+        is_on_ = false;
+        return final_ret;
+    }
+
+    /// @copydoc IPowerControl::set_drive_capability()
+    esp_err_t set_drive_capability(gpio_drive_cap_t strength)
+    {
+        if (!initialized_) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        return hal_.set_drive_capability(Pin, strength);
+    }
+
+    /// @copydoc IPowerControl::turn_on()
+    esp_err_t turn_on() { return apply(true); }
+
+    /// @copydoc IPowerControl::turn_off()
+    esp_err_t turn_off() { return apply(false); }
+
+    /// @copydoc IPowerControl::toggle()
+    esp_err_t toggle() { return apply(!is_on_); }
+
+    /// @copydoc IPowerControl::is_on()
+    bool is_on() const { return is_on_; }
+
+    /// @copydoc IPowerControl::is_initialized()
+    bool is_initialized() const { return initialized_; }
+
+    /// @copydoc IPowerControl::get_pin()
+    static constexpr gpio_num_t get_pin() { return Pin; }
+
+private:
+    /**
+     * @brief Apply a logical state to the GPIO
+     *
+     * Both branches pass compile-time constant masks, so with a final HAL the
+     * call reduces to one register store.
+     *
+     * @note Updates is_on_ only on successful HAL operation
+     */
+    esp_err_t apply(bool enable)
+    {
+        if (!initialized_) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        esp_err_t ret = enable ? hal_.set_levels_mask(ON_SET_MASK, ON_CLEAR_MASK)
+                               : hal_.set_levels_mask(ON_CLEAR_MASK, ON_SET_MASK);
+        if (ret == ESP_OK) {
+            is_on_ = enable;
+        }
+        return ret;
+    }
+
+    Hal &hal_;        ///< HAL instance for hardware access
+    bool initial_on_; ///< Initial state to apply after init
+
+    bool initialized_ = false; ///< Initialization state
+    bool is_on_ = false;       ///< Current logical state
+};
+} // namespace power_control
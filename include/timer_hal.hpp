@@ -0,0 +1,80 @@
+#pragma once
+
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "i_timer_hal.hpp"
+
+namespace power_control {
+/**
+ * @class TimerHAL
+ * @brief Concrete implementation of ITimerHAL using esp_timer
+ *
+ * Callbacks are dispatched from the esp_timer task.
+ * @internal
+ */
+class TimerHAL final : public ITimerHAL
+{
+public:
+    TimerHAL() = default;
+    ~TimerHAL() override = default;
+
+    /** @copydoc ITimerHAL::get_time_us() */
+    int64_t get_time_us() override { return esp_timer_get_time(); }
+
+    /** @copydoc ITimerHAL::create() */
+    esp_err_t create(timer_callback_t callback, void *arg, timer_handle_t *out_handle) override
+    {
+        esp_timer_create_args_t args = {};
+        args.callback = callback;
+        args.arg = arg;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "power_control";
+
+        esp_timer_handle_t handle = nullptr;
+        esp_err_t ret = esp_timer_create(&args, &handle);
+        *out_handle = handle;
+        return ret;
+    }
+
+    /** @copydoc ITimerHAL::start_once() */
+    esp_err_t start_once(timer_handle_t handle, uint64_t timeout_us) override
+    {
+        return esp_timer_start_once(static_cast<esp_timer_handle_t>(handle), timeout_us);
+    }
+
+    /** @copydoc ITimerHAL::stop() */
+    esp_err_t stop(timer_handle_t handle) override
+    {
+        esp_err_t ret = esp_timer_stop(static_cast<esp_timer_handle_t>(handle));
+        return ret == ESP_ERR_INVALID_STATE ? ESP_OK : ret; // Not running is not an error
+    }
+
+    /** @copydoc ITimerHAL::remove() */
+    esp_err_t remove(timer_handle_t handle) override
+    {
+        return esp_timer_delete(static_cast<esp_timer_handle_t>(handle));
+    }
+
+    /**
+     * @copydoc ITimerHAL::delay_us()
+     *
+     * Whole RTOS ticks but one are slept with vTaskDelay(), which may return up
+     * to a tick early; the rest is busy-waited against esp_timer.
+     */
+    void delay_us(uint32_t us) override
+    {
+        const int64_t deadline_us = esp_timer_get_time() + us;
+        const uint32_t tick_us = portTICK_PERIOD_MS * 1000;
+        if (tick_us > 0 && us >= 2 * tick_us) {
+            vTaskDelay(us / tick_us - 1);
+        }
+        const int64_t remaining_us = deadline_us - esp_timer_get_time();
+        if (remaining_us > 0) {
+            esp_rom_delay_us(static_cast<uint32_t>(remaining_us));
+        }
+    }
+};
+} // namespace power_control
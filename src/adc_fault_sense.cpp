@@ -0,0 +1,108 @@
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "adc_fault_sense.hpp"
+
+#if CONFIG_POWER_CONTROL_PROTECTION && !CONFIG_IDF_TARGET_LINUX && SOC_ADC_DMA_SUPPORTED
+
+namespace power_control {
+
+/// Bytes of one conversion frame
+static constexpr uint32_t FRAME_BYTES = AdcFaultSense::FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES;
+
+esp_err_t AdcFaultSense::start(fault_isr_t handler, void *arg)
+{
+    if (handle_ != nullptr) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    adc_continuous_handle_cfg_t handle_cfg = {};
+    handle_cfg.max_store_buf_size = FRAME_BYTES * 4;
+    handle_cfg.conv_frame_size = FRAME_BYTES;
+    esp_err_t ret = adc_continuous_new_handle(&handle_cfg, &handle_);
+    if (ret != ESP_OK) {
+        handle_ = nullptr;
+        return ret;
+    }
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = atten_;
+    pattern.channel = channel_;
+    pattern.unit = unit_;
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_continuous_config_t config = {};
+    config.pattern_num = 1;
+    config.adc_pattern = &pattern;
+    config.sample_freq_hz = sample_freq_hz_;
+    config.conv_mode = unit_ == ADC_UNIT_1 ? ADC_CONV_SINGLE_UNIT_1 : ADC_CONV_SINGLE_UNIT_2;
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+#else
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+#endif
+
+    adc_continuous_evt_cbs_t callbacks = {};
+    callbacks.on_conv_done = conv_done;
+
+    handler_ = handler;
+    arg_ = arg;
+    ret = adc_continuous_config(handle_, &config);
+    if (ret == ESP_OK) {
+        ret = adc_continuous_register_event_callbacks(handle_, &callbacks, this);
+    }
+    if (ret == ESP_OK) {
+        ret = adc_continuous_start(handle_);
+    }
+    if (ret != ESP_OK) {
+        adc_continuous_deinit(handle_);
+        handle_ = nullptr;
+        handler_ = nullptr;
+    }
+    return ret;
+}
+
+esp_err_t AdcFaultSense::stop()
+{
+    if (handle_ == nullptr) {
+        return ESP_OK;
+    }
+    adc_continuous_stop(handle_);
+    esp_err_t ret = adc_continuous_deinit(handle_);
+    handle_ = nullptr;
+    handler_ = nullptr;
+    return ret;
+}
+
+bool IRAM_ATTR AdcFaultSense::conv_done(
+    adc_continuous_handle_t handle,
+    const adc_continuous_evt_data_t *edata,
+    void *user_data)
+{
+    (void)handle;
+    AdcFaultSense *self = static_cast<AdcFaultSense *>(user_data);
+
+    uint32_t peak = 0;
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= edata->size; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t *sample =
+            reinterpret_cast<const adc_digi_output_data_t *>(&edata->conv_frame_buffer[i]);
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+        const uint32_t raw = sample->type1.data;
+#else
+        const uint32_t raw = sample->type2.data;
+#endif
+        peak = raw > peak ? raw : peak;
+    }
+    self->last_raw_.store(peak, std::memory_order_relaxed);
+
+    fault_isr_t handler = self->handler_;
+    if (peak > self->threshold_raw_ && handler != nullptr) {
+        handler(self->arg_);
+    }
+    return false; // The fault handler yields on its own if it woke a task
+}
+
+} // namespace power_control
+
+#endif
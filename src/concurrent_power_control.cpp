@@ -0,0 +1,196 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "concurrent_power_control.hpp"
+
+namespace power_control {
+
+static const char *TAG = "ConcurrentPowerControl";
+
+ConcurrentPowerControl::ConcurrentPowerControl(
+    IGpioHAL &hal,
+    const gpio_num_t gpio,
+    const bool inverted_logic,
+    const bool initial_on)
+    : hal_(hal)
+    , gpio_(gpio)
+    , inverted_logic_(inverted_logic)
+    , initial_on_(initial_on)
+{
+    const uint64_t pin_mask = (gpio >= 0 && gpio < GPIO_NUM_MAX) ? (1ULL << gpio) : 0;
+    on_set_mask_ = inverted_logic ? 0 : pin_mask;
+    on_clear_mask_ = inverted_logic ? pin_mask : 0;
+}
+
+esp_err_t ConcurrentPowerControl::init()
+{
+    uint8_t expected = UNINITIALIZED;
+    if (!lifecycle_.compare_exchange_strong(expected, BUSY, std::memory_order_acquire)) {
+        if (expected == READY) {
+            return ESP_OK;
+        }
+        ESP_LOGE(TAG, "init() called while init()/deinit() is in progress");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ESP_LOGI(
+        TAG,
+        "Initializing concurrent power control on GPIO %d (active_%s, initial_%s)",
+        gpio_,
+        inverted_logic_ ? "true" : "false",
+        initial_on_ ? "on" : "off");
+
+    if (on_set_mask_ == 0 && on_clear_mask_ == 0) {
+        ESP_LOGE(TAG, "Invalid GPIO %d", gpio_);
+        lifecycle_.store(UNINITIALIZED, std::memory_order_release);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Reset GPIO before initialization
+    esp_err_t ret = hal_.reset_pin(gpio_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to reset GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        lifecycle_.store(UNINITIALIZED, std::memory_order_release);
+        return ret;
+    }
+
+    // Set GPIO as output
+    gpio_config_t io_conf = {};
+    io_conf.mode = GPIO_MODE_INPUT_OUTPUT;
+    io_conf.pin_bit_mask = 1ULL << gpio_;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+
+    ret = hal_.config(io_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        lifecycle_.store(UNINITIALIZED, std::memory_order_release);
+        return ret;
+    }
+
+    // Apply the initial state before the rail becomes usable by other tasks
+    ret = write_level(initial_on_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to apply initial state on GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        lifecycle_.store(UNINITIALIZED, std::memory_order_release);
+        return ret;
+    }
+    is_on_.store(initial_on_, std::memory_order_relaxed);
+    lifecycle_.store(READY, std::memory_order_release);
+
+    ESP_LOGI(TAG, "Concurrent power control initialized successfully");
+
+    return ESP_OK;
+}
+
+esp_err_t ConcurrentPowerControl::converge(bool previous, bool enable)
+{
+    while (true) {
+        esp_err_t ret = write_level(enable);
+        if (ret != ESP_OK) {
+            // Restore the previous state unless another call replaced it meanwhile
+            is_on_.compare_exchange_strong(enable, previous, std::memory_order_acq_rel);
+            ESP_LOGE(TAG, "Failed to set GPIO %d to enable=%d", gpio_, enable);
+            return ret;
+        }
+        // A concurrent call may have published a newer state while we were writing
+        const bool latest = is_on_.load(std::memory_order_acquire);
+        if (latest == enable) {
+            return ESP_OK;
+        }
+        enable = latest;
+    }
+}
+
+esp_err_t ConcurrentPowerControl::turn_on()
+{
+    if (!is_initialized()) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    return converge(is_on_.exchange(true, std::memory_order_acq_rel), true);
+}
+
+esp_err_t ConcurrentPowerControl::turn_off()
+{
+    if (!is_initialized()) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    return converge(is_on_.exchange(false, std::memory_order_acq_rel), false);
+}
+
+esp_err_t ConcurrentPowerControl::toggle()
+{
+    if (!is_initialized()) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Each concurrent toggle flips the state exactly once
+    bool current = is_on_.load(std::memory_order_relaxed);
+    while (!is_on_.compare_exchange_weak(current, !current, std::memory_order_acq_rel)) {
+    }
+    return converge(current, !current);
+}
+
+esp_err_t ConcurrentPowerControl::deinit()
+{
+    uint8_t expected = READY;
+    if (!lifecycle_.compare_exchange_strong(expected, BUSY, std::memory_order_acquire)) {
+        if (expected == UNINITIALIZED) {
+            return ESP_OK;
+        }
+        ESP_LOGE(TAG, "deinit() called while init()/deinit() is in progress");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t final_ret = ESP_OK;
+
+    // Force GPIO low before deinitialization for safety
+    esp_err_t ret = hal_.set_levels_mask(0, on_set_mask_ | on_clear_mask_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set GPIO low during deinit");
+        final_ret = ret; // Store error but continue
+    }
+
+    // Reset GPIO (returns to high-impedance state)
+    ret = hal_.reset_pin(gpio_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to reset GPIO during deinit");
+        if (final_ret == ESP_OK) {
+            final_ret = ret; // Only override if no previous error
+        }
+    }
+
+    // Mark as deinitialized regardless of hardware errors
+    is_on_.store(false, std::memory_order_relaxed);
+    lifecycle_.store(UNINITIALIZED, std::memory_order_release);
+    ESP_LOGI(
+        TAG,
+        "Concurrent power control deinitialized on GPIO %d (status: %s)",
+        gpio_,
+        final_ret == ESP_OK ? "OK" : "partial failure");
+
+    return final_ret;
+}
+
+esp_err_t ConcurrentPowerControl::set_drive_capability(gpio_drive_cap_t strength)
+{
+    if (!is_initialized()) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = hal_.set_drive_capability(gpio_, strength);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set GPIO %d drive capability to %d", gpio_, strength);
+        return ret;
+    }
+    ESP_LOGD(TAG, "GPIO %d drive capability set to %d ", gpio_, strength);
+    return ret;
+}
+
+} // namespace power_control
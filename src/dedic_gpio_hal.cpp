@@ -0,0 +1,141 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "dedic_gpio_hal.hpp"
+
+namespace power_control {
+
+DedicGpioHAL::DedicGpioHAL(const gpio_num_t *pins, size_t count)
+{
+    if (count > MAX_PINS) {
+        return; // Empty bundle: every pin goes through GpioHAL
+    }
+    uint64_t mask = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (pins[i] < 0 || pins[i] >= GPIO_NUM_MAX || (mask & (1ULL << pins[i])) != 0) {
+            return;
+        }
+        mask |= 1ULL << pins[i];
+    }
+    for (size_t i = 0; i < count; i++) {
+        pins_[i] = pins[i];
+    }
+    count_ = count;
+    pin_mask_ = mask;
+}
+
+DedicGpioHAL::~DedicGpioHAL()
+{
+    release_bundle();
+}
+
+void DedicGpioHAL::release_bundle()
+{
+#if POWER_CONTROL_DEDIC_GPIO
+    if (bundle_ != nullptr) {
+        dedic_gpio_del_bundle(bundle_);
+        bundle_ = nullptr;
+    }
+#endif
+}
+
+uint32_t DedicGpioHAL::to_channels(uint64_t gpio_mask) const
+{
+    uint32_t channels = 0;
+    for (size_t i = 0; i < count_; i++) {
+        if ((gpio_mask & (1ULL << pins_[i])) != 0) {
+            channels |= 1u << i;
+        }
+    }
+    return channels;
+}
+
+esp_err_t DedicGpioHAL::reset_pin(const gpio_num_t pin)
+{
+    if (pin >= 0 && pin < GPIO_NUM_MAX && (pin_mask_ & (1ULL << pin)) != 0) {
+        release_bundle();
+    }
+    return gpio_hal_.reset_pin(pin);
+}
+
+esp_err_t DedicGpioHAL::reset_pins_mask(const uint64_t mask)
+{
+    if ((mask & pin_mask_) != 0) {
+        release_bundle();
+    }
+    return gpio_hal_.reset_pins_mask(mask);
+}
+
+esp_err_t DedicGpioHAL::config(const gpio_config_t &config)
+{
+    esp_err_t ret = gpio_hal_.config(config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+#if POWER_CONTROL_DEDIC_GPIO
+    // gpio_config() routes the pins back to the GPIO matrix output: route them to the bundle again
+    if (pin_mask_ != 0 && (config.pin_bit_mask & pin_mask_) == pin_mask_ && (config.mode & GPIO_MODE_OUTPUT) != 0) {
+        release_bundle();
+
+        // Levels the pads drive now, from the GPIO output registers
+        uint64_t levels = REG_READ(GPIO_OUT_REG);
+#if SOC_GPIO_PIN_COUNT > 32
+        levels |= static_cast<uint64_t>(REG_READ(GPIO_OUT1_REG)) << 32;
+#endif
+        dedic_gpio_bundle_config_t bundle_conf = {};
+        bundle_conf.gpio_array = pins_;
+        bundle_conf.array_size = count_;
+        bundle_conf.flags.out_en = 1;
+        ret = dedic_gpio_new_bundle(&bundle_conf, &bundle_);
+        if (ret != ESP_OK) {
+            bundle_ = nullptr;
+            return ret;
+        }
+        dedic_gpio_get_out_offset(bundle_, &offset_);
+        core_ = esp_cpu_get_core_id();
+
+        // The pads now follow the channels, which hold 0 or a stale level: load the levels they had
+        const uint32_t all = (1u << count_) - 1;
+        write_channels(all, to_channels(levels));
+    }
+    else if ((config.pin_bit_mask & pin_mask_) != 0) {
+        release_bundle(); // Pins leave output mode or are reconfigured one by one
+    }
+#endif
+    return ESP_OK;
+}
+
+esp_err_t DedicGpioHAL::set_level(const gpio_num_t pin, const bool level)
+{
+    if (pin >= 0 && pin < GPIO_NUM_MAX && is_active() && (pin_mask_ & (1ULL << pin)) != 0) {
+        const uint32_t channel = to_channels(1ULL << pin);
+        return write_channels(channel, level ? channel : 0);
+    }
+    return gpio_hal_.set_level(pin, level);
+}
+
+esp_err_t DedicGpioHAL::set_levels_mask(const uint64_t set_mask, const uint64_t clear_mask)
+{
+    if ((set_mask & clear_mask) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint64_t other_set = set_mask;
+    uint64_t other_clear = clear_mask;
+    if (is_active()) {
+        const uint64_t bundle = (set_mask | clear_mask) & pin_mask_;
+        if (bundle != 0) {
+            esp_err_t ret = write_channels(to_channels(bundle), to_channels(set_mask));
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+        other_set &= ~pin_mask_;
+        other_clear &= ~pin_mask_;
+    }
+    if ((other_set | other_clear) == 0) {
+        return ESP_OK;
+    }
+    return GpioHAL::write_levels_mask(other_set, other_clear);
+}
+
+} // namespace power_control
@@ -0,0 +1,198 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "expander_gpio_hal.hpp"
+
+namespace power_control {
+
+ExpanderGpioHAL::ExpanderGpioHAL(IRegisterBus &bus, ExpanderChip chip)
+    : bus_(bus)
+    , registers_(registers_of(chip))
+{
+}
+
+ExpanderGpioHAL::Registers ExpanderGpioHAL::registers_of(ExpanderChip chip)
+{
+    switch (chip) {
+    case ExpanderChip::MCP23017:
+        return {0x12, 0x14, 0x00}; // GPIO, OLAT, IODIR (IOCON.BANK = 0)
+    case ExpanderChip::TCA9555:
+    default:
+        return {0x00, 0x02, 0x06}; // Input, Output, Configuration
+    }
+}
+
+esp_err_t ExpanderGpioHAL::init()
+{
+    uint8_t data[2];
+    esp_err_t ret = bus_.read_registers(registers_.output, data, sizeof(data));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    output_ = written_output_ = static_cast<uint16_t>(data[0] | (data[1] << 8));
+
+    ret = bus_.read_registers(registers_.direction, data, sizeof(data));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    input_mask_ = written_input_mask_ = static_cast<uint16_t>(data[0] | (data[1] << 8));
+
+    initialized_ = true;
+    return ESP_OK;
+}
+
+esp_err_t ExpanderGpioHAL::end_batch()
+{
+    if (batch_depth_ == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (--batch_depth_ > 0) {
+        return ESP_OK;
+    }
+    return flush();
+}
+
+esp_err_t ExpanderGpioHAL::flush()
+{
+    if (!initialized_) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Outputs first, so a pin turning into an output starts at its new level
+    if (output_ != written_output_) {
+        esp_err_t ret = write16(registers_.output, output_);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        written_output_ = output_;
+    }
+    if (input_mask_ != written_input_mask_) {
+        esp_err_t ret = write16(registers_.direction, input_mask_);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        written_input_mask_ = input_mask_;
+    }
+    return ESP_OK;
+}
+
+bool ExpanderGpioHAL::to_pins(uint64_t mask, uint16_t &pins)
+{
+    if ((mask >> PIN_COUNT) != 0) {
+        return false;
+    }
+    pins = static_cast<uint16_t>(mask);
+    return true;
+}
+
+esp_err_t ExpanderGpioHAL::commit(uint16_t output, uint16_t input_mask)
+{
+    if (!initialized_) {
+        output_ = output;
+        input_mask_ = input_mask;
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (batch_depth_ > 0) {
+        return ESP_OK; // Written by end_batch()
+    }
+    esp_err_t ret = flush();
+    if (ret != ESP_OK) {
+        output_ = output;
+        input_mask_ = input_mask;
+    }
+    return ret;
+}
+
+esp_err_t ExpanderGpioHAL::write16(uint8_t reg, uint16_t value)
+{
+    const uint8_t data[2] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+    return bus_.write_registers(reg, data, sizeof(data));
+}
+
+esp_err_t ExpanderGpioHAL::reset_pin(const gpio_num_t pin)
+{
+    if (pin < 0 || pin >= PIN_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return reset_pins_mask(1ULL << pin);
+}
+
+esp_err_t ExpanderGpioHAL::reset_pins_mask(const uint64_t mask)
+{
+    uint16_t pins = 0;
+    if (!to_pins(mask, pins)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint16_t output = output_;
+    const uint16_t input_mask = input_mask_;
+    input_mask_ |= pins;
+    return commit(output, input_mask);
+}
+
+esp_err_t ExpanderGpioHAL::config(const gpio_config_t &config)
+{
+    uint16_t pins = 0;
+    if (!to_pins(config.pin_bit_mask, pins)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint16_t output = output_;
+    const uint16_t input_mask = input_mask_;
+    if ((config.mode & GPIO_MODE_OUTPUT) != 0) {
+        input_mask_ &= ~pins;
+    }
+    else {
+        input_mask_ |= pins;
+    }
+    return commit(output, input_mask);
+}
+
+esp_err_t ExpanderGpioHAL::set_level(const gpio_num_t pin, bool level)
+{
+    if (pin < 0 || pin >= PIN_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint64_t bit = 1ULL << pin;
+    return level ? set_levels_mask(bit, 0) : set_levels_mask(0, bit);
+}
+
+esp_err_t ExpanderGpioHAL::set_levels_mask(const uint64_t set_mask, const uint64_t clear_mask)
+{
+    uint16_t set_pins = 0;
+    uint16_t clear_pins = 0;
+    if (!to_pins(set_mask, set_pins) || !to_pins(clear_mask, clear_pins) || (set_pins & clear_pins) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint16_t output = output_;
+    output_ = static_cast<uint16_t>((output_ | set_pins) & ~clear_pins);
+    return commit(output, input_mask_);
+}
+
+esp_err_t ExpanderGpioHAL::set_drive_capability(const gpio_num_t gpio_num, gpio_drive_cap_t strength)
+{
+    (void)gpio_num;
+    (void)strength;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t ExpanderGpioHAL::get_level(const gpio_num_t pin, bool &level)
+{
+    if (pin < 0 || pin >= PIN_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!initialized_) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const uint16_t bit = static_cast<uint16_t>(1u << pin);
+    if ((input_mask_ & bit) == 0 && ((output_ ^ written_output_) & bit) != 0) {
+        level = (output_ & bit) != 0; // Pending in a batch
+        return ESP_OK;
+    }
+    uint8_t data[2];
+    esp_err_t ret = bus_.read_registers(registers_.input, data, sizeof(data));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    level = ((data[0] | (data[1] << 8)) & bit) != 0;
+    return ESP_OK;
+}
+
+} // namespace power_control
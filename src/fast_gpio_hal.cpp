@@ -0,0 +1,79 @@
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "hal/gpio_ll.h"
+#include "soc/gpio_struct.h"
+#endif
+
+#include "fast_gpio_hal.hpp"
+
+namespace power_control {
+
+esp_err_t FastGpioHAL::reset_pin(const gpio_num_t pin)
+{
+    if (pin >= 0 && pin < GPIO_NUM_MAX) {
+        output_mask_ &= ~(1ULL << pin); // Pin leaves output mode
+    }
+    return gpio_reset_pin(pin);
+}
+
+esp_err_t FastGpioHAL::reset_pins_mask(const uint64_t mask)
+{
+    output_mask_ &= ~mask; // Pins leave output mode
+    return GpioHAL().reset_pins_mask(mask);
+}
+
+esp_err_t FastGpioHAL::config(const gpio_config_t &config)
+{
+    esp_err_t ret = gpio_config(&config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Only pins with the output driver enabled can use the fast path
+    if ((config.mode & GPIO_MODE_OUTPUT) != 0) {
+        output_mask_ |= config.pin_bit_mask;
+    }
+    else {
+        output_mask_ &= ~config.pin_bit_mask;
+    }
+    return ESP_OK;
+}
+
+esp_err_t IRAM_ATTR FastGpioHAL::set_level(const gpio_num_t pin, const bool level)
+{
+    if (pin < 0 || pin >= GPIO_NUM_MAX || (output_mask_ & (1ULL << pin)) == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+#if CONFIG_IDF_TARGET_LINUX
+    return gpio_set_level(pin, level);
+#else
+    gpio_ll_set_level(&GPIO, pin, level);
+    return ESP_OK;
+#endif
+}
+
+esp_err_t IRAM_ATTR FastGpioHAL::get_level(const gpio_num_t pin, bool &level)
+{
+    if (pin < 0 || pin >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+#if CONFIG_IDF_TARGET_LINUX
+    level = gpio_get_level(pin) != 0;
+#else
+    level = gpio_ll_get_level(&GPIO, pin) != 0;
+#endif
+    return ESP_OK;
+}
+
+esp_err_t IRAM_ATTR FastGpioHAL::set_levels_mask(const uint64_t set_mask, const uint64_t clear_mask)
+{
+    if (((set_mask | clear_mask) & ~output_mask_) != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return GpioHAL::write_levels_mask(set_mask, clear_mask);
+}
+
+} // namespace power_control
@@ -0,0 +1,66 @@
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "gpio_fault_sense.hpp"
+
+#if CONFIG_POWER_CONTROL_PROTECTION
+
+namespace power_control {
+
+esp_err_t GpioFaultSense::start(fault_isr_t handler, void *arg)
+{
+    if (handler_ != nullptr) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    gpio_config_t io_conf = {};
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = 1ULL << gpio_;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.pull_up_en = active_low_ ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE;
+    io_conf.intr_type = active_low_ ? GPIO_INTR_NEGEDGE : GPIO_INTR_POSEDGE;
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Already installed by the application: use its service
+    ret = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        return ret;
+    }
+
+    handler_ = handler;
+    arg_ = arg;
+    ret = gpio_isr_handler_add(gpio_, isr, this);
+    if (ret != ESP_OK) {
+        handler_ = nullptr;
+        return ret;
+    }
+    return gpio_intr_enable(gpio_);
+}
+
+esp_err_t GpioFaultSense::stop()
+{
+    if (handler_ == nullptr) {
+        return ESP_OK;
+    }
+    gpio_intr_disable(gpio_);
+    esp_err_t ret = gpio_isr_handler_remove(gpio_);
+    handler_ = nullptr;
+    return ret;
+}
+
+void IRAM_ATTR GpioFaultSense::isr(void *arg)
+{
+    GpioFaultSense *self = static_cast<GpioFaultSense *>(arg);
+    fault_isr_t handler = self->handler_;
+    if (handler != nullptr) {
+        handler(self->arg_);
+    }
+}
+
+} // namespace power_control
+
+#endif
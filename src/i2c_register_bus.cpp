@@ -0,0 +1,31 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "i2c_register_bus.hpp"
+
+#if !CONFIG_IDF_TARGET_LINUX
+
+#include <cstring>
+
+namespace power_control {
+
+esp_err_t I2cRegisterBus::write_registers(uint8_t reg, const uint8_t *data, size_t len)
+{
+    if (len > MAX_WRITE_LEN) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // Register address and data in a single START ... STOP
+    uint8_t buffer[1 + MAX_WRITE_LEN];
+    buffer[0] = reg;
+    memcpy(&buffer[1], data, len);
+    return i2c_master_transmit(device_, buffer, 1 + len, timeout_ms_);
+}
+
+esp_err_t I2cRegisterBus::read_registers(uint8_t reg, uint8_t *data, size_t len)
+{
+    return i2c_master_transmit_receive(device_, &reg, 1, data, len, timeout_ms_);
+}
+
+} // namespace power_control
+
+#endif // !CONFIG_IDF_TARGET_LINUX
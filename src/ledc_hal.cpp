@@ -0,0 +1,63 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "ledc_hal.hpp"
+
+#if !CONFIG_IDF_TARGET_LINUX
+
+namespace power_control {
+
+esp_err_t LedcHAL::start_ramp(gpio_num_t gpio, bool inverted, uint32_t ramp_time_ms)
+{
+    // Fade service is shared by all channels; a second install reports INVALID_STATE
+    esp_err_t ret = ledc_fade_func_install(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        return ret;
+    }
+
+    ledc_timer_config_t timer_conf = {};
+    timer_conf.speed_mode = speed_mode_;
+    timer_conf.duty_resolution = DUTY_RESOLUTION;
+    timer_conf.timer_num = timer_;
+    timer_conf.freq_hz = freq_hz_;
+    timer_conf.clk_cfg = LEDC_AUTO_CLK;
+    ret = ledc_timer_config(&timer_conf);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Connecting the channel at 0 % duty keeps the pin at its OFF level
+    ledc_channel_config_t channel_conf = {};
+    channel_conf.gpio_num = gpio;
+    channel_conf.speed_mode = speed_mode_;
+    channel_conf.channel = channel_;
+    channel_conf.intr_type = LEDC_INTR_DISABLE;
+    channel_conf.timer_sel = timer_;
+    channel_conf.duty = 0;
+    channel_conf.hpoint = 0;
+    channel_conf.flags.output_invert = inverted ? 1 : 0;
+    ret = ledc_channel_config(&channel_conf);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = ledc_set_fade_with_time(speed_mode_, channel_, FULL_DUTY, static_cast<int>(ramp_time_ms));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return ledc_fade_start(speed_mode_, channel_, LEDC_FADE_NO_WAIT);
+}
+
+esp_err_t LedcHAL::stop(gpio_num_t gpio)
+{
+    (void)gpio; // The channel is fixed at construction
+    esp_err_t ret = ledc_fade_stop(speed_mode_, channel_);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        return ret;
+    }
+    return ledc_stop(speed_mode_, channel_, 0);
+}
+
+} // namespace power_control
+
+#endif // !CONFIG_IDF_TARGET_LINUX
@@ -0,0 +1,312 @@
+#include <cinttypes>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "power_budget.hpp"
+
+namespace power_control {
+
+static const char *TAG = "PowerBudget";
+
+/// Busy-wait iterations before yielding the CPU while another task holds the queue lock
+static constexpr uint32_t SPINS_BEFORE_YIELD = 64;
+
+// ========================================
+// PowerBudget
+// ========================================
+
+PowerBudget::PowerBudget(ITimerHAL &timer, uint32_t budget_ma)
+    : timer_(timer)
+    , budget_ma_(budget_ma)
+{
+}
+
+bool PowerBudget::try_reserve(uint32_t ma)
+{
+    uint32_t used = used_ma_.load(std::memory_order_relaxed);
+    while (used + ma <= budget_ma_) {
+        if (used_ma_.compare_exchange_weak(used, used + ma, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PowerBudget::admit_or_enqueue(BudgetedRail &rail)
+{
+    // Fast path: nobody waits, so taking the budget now does not overtake anyone
+    if (waiting_.load(std::memory_order_acquire) == 0 && try_reserve(rail.peak_ma())) {
+        rail.state_.store(BudgetedRail::ADMITTING, std::memory_order_release);
+        return true;
+    }
+
+    rail.state_.store(BudgetedRail::PENDING, std::memory_order_release);
+    lock();
+    rail.next_ = nullptr;
+    if (tail_ != nullptr) {
+        tail_->next_ = &rail;
+    }
+    else {
+        head_ = &rail;
+    }
+    tail_ = &rail;
+    waiting_.fetch_add(1, std::memory_order_acq_rel);
+    unlock();
+
+    ESP_LOGD(TAG, "Rail on GPIO %d waits for %" PRIu32 " mA", rail.get_pin(), rail.peak_ma());
+
+    // Current may have been given back between the failed reservation and the enqueue
+    drain();
+    return false;
+}
+
+bool PowerBudget::cancel(BudgetedRail &rail)
+{
+    lock();
+    BudgetedRail *prev = nullptr;
+    BudgetedRail *node = head_;
+    while (node != nullptr && node != &rail) {
+        prev = node;
+        node = node->next_;
+    }
+    if (node == nullptr) {
+        unlock();
+        return false; // Admitted meanwhile
+    }
+    if (prev != nullptr) {
+        prev->next_ = node->next_;
+    }
+    else {
+        head_ = node->next_;
+    }
+    if (tail_ == node) {
+        tail_ = prev;
+    }
+    node->next_ = nullptr;
+    waiting_.fetch_sub(1, std::memory_order_acq_rel);
+    unlock();
+
+    // Rails behind may fit now that the head is gone
+    drain();
+    return true;
+}
+
+void PowerBudget::release(uint32_t ma)
+{
+    if (ma == 0) {
+        return;
+    }
+    used_ma_.fetch_sub(ma, std::memory_order_acq_rel);
+    if (waiting_.load(std::memory_order_acquire) != 0) {
+        drain();
+    }
+}
+
+void PowerBudget::drain()
+{
+    while (true) {
+        lock();
+        BudgetedRail *head = head_;
+        if (head == nullptr || !try_reserve(head->peak_ma())) {
+            unlock();
+            return;
+        }
+        head_ = head->next_;
+        if (head_ == nullptr) {
+            tail_ = nullptr;
+        }
+        head->next_ = nullptr;
+        waiting_.fetch_sub(1, std::memory_order_acq_rel);
+
+        // BudgetedRail::withdraw() leaves PENDING with a CAS as well: exactly one side owns the request
+        BudgetedRail::State expected = BudgetedRail::PENDING;
+        const bool claimed =
+            head->state_.compare_exchange_strong(expected, BudgetedRail::ADMITTING, std::memory_order_acq_rel);
+        unlock();
+        if (!claimed) {
+            used_ma_.fetch_sub(head->peak_ma(), std::memory_order_acq_rel); // Withdrawn meanwhile
+            continue;
+        }
+
+        // Switch outside the lock; a failed rail gives its reservation back
+        head->admit();
+    }
+}
+
+void PowerBudget::lock()
+{
+    uint32_t spins = 0;
+    while (queue_lock_.test_and_set(std::memory_order_acquire)) {
+        // The holder only moves a few pointers: spin briefly, then let it run
+        if (++spins >= SPINS_BEFORE_YIELD) {
+            spins = 0;
+            vTaskDelay(1);
+        }
+    }
+}
+
+// ========================================
+// BudgetedRail
+// ========================================
+
+BudgetedRail::BudgetedRail(
+    PowerBudget &budget,
+    IPowerControl &rail,
+    uint32_t inrush_ma,
+    uint32_t steady_ma,
+    uint32_t inrush_us)
+    : budget_(budget)
+    , rail_(rail)
+    , inrush_ma_(inrush_ma)
+    , steady_ma_(steady_ma)
+    , inrush_us_(inrush_us)
+{
+}
+
+BudgetedRail::~BudgetedRail()
+{
+    withdraw();
+    if (inrush_timer_ != nullptr) {
+        budget_.timer_.stop(inrush_timer_);
+        budget_.timer_.remove(inrush_timer_);
+    }
+    budget_.release(reserved_ma_.exchange(0));
+}
+
+esp_err_t BudgetedRail::deinit()
+{
+    withdraw();
+    if (inrush_timer_ != nullptr) {
+        budget_.timer_.stop(inrush_timer_);
+    }
+    esp_err_t ret = rail_.deinit(); // Forces the rail OFF
+    state_.store(OFF);
+    budget_.release(reserved_ma_.exchange(0));
+    return ret;
+}
+
+esp_err_t BudgetedRail::turn_on()
+{
+    if (!rail_.is_initialized()) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (peak_ma() > budget_.get_budget_ma()) {
+        ESP_LOGE(
+            TAG,
+            "Rail on GPIO %d needs %" PRIu32 " mA, above the %" PRIu32 " mA budget",
+            rail_.get_pin(),
+            peak_ma(),
+            budget_.get_budget_ma());
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (state_.load() != OFF) {
+        return ESP_OK; // Already ON or waiting
+    }
+    if (!budget_.admit_or_enqueue(*this)) {
+        return ESP_OK; // Switched ON later, in request order
+    }
+    return admit();
+}
+
+esp_err_t BudgetedRail::turn_off()
+{
+    if (withdraw()) {
+        return ESP_OK; // Never switched ON, or switched back OFF by admit()
+    }
+
+    if (inrush_timer_ != nullptr) {
+        budget_.timer_.stop(inrush_timer_);
+    }
+    esp_err_t ret = rail_.turn_off();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to turn rail on GPIO %d OFF, error: %s", rail_.get_pin(), esp_err_to_name(ret));
+        return ret; // Still drawing current: keep the reservation
+    }
+    state_.store(OFF);
+    budget_.release(reserved_ma_.exchange(0));
+    return ESP_OK;
+}
+
+bool BudgetedRail::withdraw()
+{
+    State state = state_.load(std::memory_order_acquire);
+    while (state == PENDING || state == ADMITTING) {
+        if (state_.compare_exchange_weak(state, OFF, std::memory_order_acq_rel)) {
+            if (state == PENDING) {
+                budget_.cancel(*this); // Not found if drain() dequeued it: drain() gives the current back
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+esp_err_t BudgetedRail::admit()
+{
+    const uint32_t peak = peak_ma();
+    reserved_ma_.store(peak, std::memory_order_release);
+
+    esp_err_t ret = rail_.turn_on();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to turn rail on GPIO %d ON, error: %s", rail_.get_pin(), esp_err_to_name(ret));
+        state_.store(OFF);
+        budget_.release(reserved_ma_.exchange(0));
+        return ret;
+    }
+
+    State expected = ADMITTING;
+    if (!state_.compare_exchange_strong(expected, ON, std::memory_order_acq_rel)) {
+        // withdraw() ran while the rail was switched: the turn-off is finished here
+        ret = rail_.turn_off();
+        if (ret != ESP_OK) {
+            // Still drawing current: the reservation is given back by the next turn_off()
+            ESP_LOGE(TAG, "Failed to turn rail on GPIO %d OFF, error: %s", rail_.get_pin(), esp_err_to_name(ret));
+            return ret;
+        }
+        budget_.release(reserved_ma_.exchange(0));
+        return ESP_OK;
+    }
+
+    if (peak == steady_ma_) {
+        return ESP_OK; // No inrush to wait for
+    }
+    if (inrush_us_ == 0) {
+        inrush_timer_cb(this); // Inrush only has to fit at the switching instant
+        return ESP_OK;
+    }
+
+    if (inrush_timer_ == nullptr) {
+        ret = budget_.timer_.create(inrush_timer_cb, this, &inrush_timer_);
+        if (ret != ESP_OK) {
+            inrush_timer_ = nullptr;
+        }
+    }
+    if (ret == ESP_OK) {
+        budget_.timer_.stop(inrush_timer_);
+        ret = budget_.timer_.start_once(inrush_timer_, inrush_us_);
+    }
+    if (ret != ESP_OK) {
+        // Keeping the peak reserved until turn_off() only leaves less budget to the others
+        ESP_LOGE(TAG, "Failed to time inrush of GPIO %d, error: %s", rail_.get_pin(), esp_err_to_name(ret));
+    }
+    return ESP_OK;
+}
+
+void BudgetedRail::inrush_timer_cb(void *arg)
+{
+    BudgetedRail *self = static_cast<BudgetedRail *>(arg);
+    uint32_t expected = self->peak_ma();
+    if (self->reserved_ma_.compare_exchange_strong(expected, self->steady_ma_, std::memory_order_acq_rel)) {
+        self->budget_.release(expected - self->steady_ma_);
+    }
+}
+
+} // namespace power_control
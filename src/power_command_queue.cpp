@@ -0,0 +1,266 @@
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "power_command_queue.hpp"
+
+namespace power_control {
+
+static const char *TAG = "PowerCommandQueue";
+
+static constexpr uint32_t MASK = PowerCommandQueue::DEPTH - 1;
+
+PowerCommandQueue::PowerCommandQueue(PowerProfileGroup &group)
+    : group_(group)
+    , pin_mask_(group.get_pin_mask())
+{
+    for (uint32_t i = 0; i < DEPTH; i++) {
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+PowerCommandQueue::~PowerCommandQueue()
+{
+    stop();
+}
+
+esp_err_t PowerCommandQueue::start(UBaseType_t priority, uint32_t stack_size, BaseType_t core)
+{
+    if (is_running()) {
+        ESP_LOGE(TAG, "Power task already running");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    stopping_.store(false, std::memory_order_relaxed);
+    task_exited_.store(false, std::memory_order_relaxed);
+    TaskHandle_t task = nullptr;
+    if (xTaskCreatePinnedToCore(task_entry, "power_cmd", stack_size, this, priority, &task, core) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create power task");
+        task_exited_.store(true, std::memory_order_relaxed);
+        return ESP_ERR_NO_MEM;
+    }
+    // Commands posted before the handle was published are picked up by this wake-up
+    task_.store(task, std::memory_order_release);
+    xTaskNotifyGive(task);
+
+    ESP_LOGI(TAG, "Power task started (priority %u)", static_cast<unsigned>(priority));
+    return ESP_OK;
+}
+
+esp_err_t PowerCommandQueue::stop()
+{
+    // Unpublish the handle first: later posts leave their commands queued
+    TaskHandle_t task = task_.exchange(nullptr);
+    if (task == nullptr) {
+        return ESP_OK;
+    }
+    // Posts that read the handle before that notify a task that is still alive
+    while (notifying_.load() != 0) {
+        vTaskDelay(1);
+    }
+
+    stopping_.store(true, std::memory_order_release);
+    xTaskNotifyGive(task);
+    while (!task_exited_.load(std::memory_order_acquire)) {
+        vTaskDelay(1);
+    }
+
+    ESP_LOGI(TAG, "Power task stopped");
+    return ESP_OK;
+}
+
+esp_err_t PowerCommandQueue::post(gpio_num_t rail, PowerAction action, PowerCommandCallback done, void *arg)
+{
+    return post_command(Command{done, arg, nullptr, static_cast<uint8_t>(rail), action});
+}
+
+esp_err_t PowerCommandQueue::post(gpio_num_t rail, PowerAction action, TaskHandle_t notify_task)
+{
+    return post_command(Command{nullptr, nullptr, notify_task, static_cast<uint8_t>(rail), action});
+}
+
+esp_err_t PowerCommandQueue::post_command(const Command &command)
+{
+    const gpio_num_t rail = static_cast<gpio_num_t>(command.gpio);
+    if (!accepts(rail, command.action)) {
+        ESP_LOGE(TAG, "GPIO %d is not a rail of the group, or invalid action", rail);
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = push(command);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Queue full, command for GPIO %d dropped", rail);
+        return ret;
+    }
+    // Sequentially consistent with stop(): it either sees this post or unpublished the handle first
+    notifying_.fetch_add(1);
+    TaskHandle_t task = task_.load();
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+    notifying_.fetch_sub(1);
+    return ESP_OK;
+}
+
+esp_err_t IRAM_ATTR PowerCommandQueue::post_from_isr(
+    gpio_num_t rail,
+    PowerAction action,
+    BaseType_t *higher_priority_task_woken,
+    PowerCommandCallback done,
+    void *arg)
+{
+    if (!accepts(rail, action)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = push(Command{done, arg, nullptr, static_cast<uint8_t>(rail), action});
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    notifying_.fetch_add(1);
+    TaskHandle_t task = task_.load();
+    if (task != nullptr) {
+        vTaskNotifyGiveFromISR(task, higher_priority_task_woken);
+    }
+    notifying_.fetch_sub(1);
+    return ESP_OK;
+}
+
+bool IRAM_ATTR PowerCommandQueue::accepts(gpio_num_t rail, PowerAction action) const
+{
+    return rail >= 0 && rail < GPIO_NUM_MAX && (pin_mask_ & (1ULL << rail)) != 0 &&
+           (action == PowerAction::ON || action == PowerAction::OFF || action == PowerAction::TOGGLE);
+}
+
+esp_err_t IRAM_ATTR PowerCommandQueue::push(const Command &command)
+{
+    uint32_t pos = tail_.load(std::memory_order_relaxed);
+    while (true) {
+        Slot &slot = slots_[pos & MASK];
+        const int32_t diff =
+            static_cast<int32_t>(slot.seq.load(std::memory_order_acquire)) - static_cast<int32_t>(pos);
+        if (diff == 0) {
+            // Slot free for this position: claim it
+            if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.command = command;
+                slot.seq.store(pos + 1, std::memory_order_release);
+                return ESP_OK;
+            }
+        }
+        else if (diff < 0) {
+            return ESP_ERR_NO_MEM; // Still holds the command DEPTH positions back
+        }
+        else {
+            pos = tail_.load(std::memory_order_relaxed); // Claimed by another producer
+        }
+    }
+}
+
+bool PowerCommandQueue::pop(Command &command)
+{
+    const uint32_t pos = head_.load(std::memory_order_relaxed);
+    Slot &slot = slots_[pos & MASK];
+    // A producer that claimed the slot but has not stored it yet ends this drain
+    if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
+        return false;
+    }
+    command = slot.command;
+    slot.seq.store(pos + DEPTH, std::memory_order_release);
+    head_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+size_t PowerCommandQueue::drain()
+{
+    size_t count = 0;
+    while (count < DEPTH && pop(batch_[count])) {
+        count++;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    // Later commands of the batch override earlier ones for the same rail
+    uint64_t target = group_.snapshot().get_on_mask();
+    uint64_t switched = 0;
+    size_t rejected = 0;
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t bit = 1ULL << batch_[i].gpio;
+        bool on = false;
+        switch (batch_[i].action) {
+        case PowerAction::ON:
+            on = true;
+            break;
+        case PowerAction::OFF:
+            on = false;
+            break;
+        case PowerAction::TOGGLE:
+            on = (target & bit) == 0;
+            break;
+        }
+        // A rail that cannot be switched (held, latched by a fault) only fails its own command
+        results_[i] = group_.check_switch(static_cast<gpio_num_t>(batch_[i].gpio), on);
+        if (results_[i] != ESP_OK) {
+            rejected++;
+            continue;
+        }
+        target = on ? (target | bit) : (target & ~bit);
+        switched |= bit;
+    }
+
+    // Rails without an accepted command are left out, so a held one does not block the others
+    esp_err_t ret = group_.apply_profile(PowerProfile(target), switched);
+    if (ret != ESP_OK) {
+        ESP_LOGE(
+            TAG,
+            "Failed to apply %u queued commands, error: %s",
+            static_cast<unsigned>(count - rejected),
+            esp_err_to_name(ret));
+    }
+    else {
+        ESP_LOGD(
+            TAG,
+            "Applied %u queued commands (state 0x%llx)",
+            static_cast<unsigned>(count - rejected),
+            static_cast<unsigned long long>(target));
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const Command &command = batch_[i];
+        const esp_err_t result = results_[i] != ESP_OK ? results_[i] : ret;
+        if (command.done != nullptr) {
+            command.done(result, command.arg);
+        }
+        if (command.notify_task != nullptr) {
+            xTaskNotify(command.notify_task, static_cast<uint32_t>(result), eSetValueWithOverwrite);
+        }
+    }
+    return count;
+}
+
+size_t PowerCommandQueue::get_pending() const
+{
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+}
+
+void PowerCommandQueue::task_entry(void *arg)
+{
+    PowerCommandQueue *self = static_cast<PowerCommandQueue *>(arg);
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // Commands posted while a batch is applied form the next batch
+        while (self->drain() > 0) {
+        }
+        if (self->stopping_.load(std::memory_order_acquire)) {
+            break;
+        }
+    }
+    self->task_exited_.store(true, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
+
+} // namespace power_control
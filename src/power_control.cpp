@@ -1,9 +1,25 @@
+#include "esp_attr.h"
 #include "esp_err.h"
+#include "sdkconfig.h"
 
-#define LOG_LOCAL_LEVEL ESP_LOG_INFO
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
 #include "esp_log.h"
 
+#include "esp_rom_sys.h"
+
+#if CONFIG_POWER_CONTROL_ISR_API && !CONFIG_IDF_TARGET_LINUX
+#include "hal/gpio_ll.h"
+#include "soc/gpio_struct.h"
+#endif
+
+#if CONFIG_POWER_CONTROL_PROTECTION && !CONFIG_IDF_TARGET_LINUX
+#include "freertos/FreeRTOS.h"
+#include "freertos/timers.h"
+#endif
+
 #include "power_control.hpp"
+#include "power_telemetry.hpp"
+#include "power_trace.hpp"
 
 namespace power_control {
 
@@ -11,11 +27,53 @@ static const char *TAG = "PowerControl";
 
 PowerControl::PowerControl(IGpioHAL &hal, const gpio_num_t gpio, const bool inverted_logic, const bool initial_on)
     : hal_(hal)
+    , timer_(nullptr)
+    , gpio_(gpio)
+    , inverted_logic_(inverted_logic)
+    , initial_on_(initial_on)
+    , settle_time_us_(0)
+
+{
+}
+
+PowerControl::PowerControl(
+    IGpioHAL &hal,
+    ITimerHAL &timer,
+    const gpio_num_t gpio,
+    const bool inverted_logic,
+    const bool initial_on,
+    const uint32_t settle_time_us)
+    : hal_(hal)
+    , timer_(&timer)
     , gpio_(gpio)
     , inverted_logic_(inverted_logic)
     , initial_on_(initial_on)
+    , settle_time_us_(settle_time_us)
+{
+}
 
+PowerControl::~PowerControl()
 {
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    PowerTelemetry::detach(telemetry_slot_);
+#endif
+#if CONFIG_POWER_CONTROL_PROTECTION
+    if (fault_sense_ != nullptr) {
+        fault_sense_->stop();
+    }
+    if (fault_retry_timer_ != nullptr) {
+        timer_->stop(fault_retry_timer_);
+        timer_->remove(fault_retry_timer_);
+    }
+#endif
+    if (settle_timer_ != nullptr) {
+        timer_->stop(settle_timer_);
+        timer_->remove(settle_timer_);
+    }
+    if (auto_off_timer_ != nullptr) {
+        timer_->stop(auto_off_timer_);
+        timer_->remove(auto_off_timer_);
+    }
 }
 
 esp_err_t PowerControl::init()
@@ -54,34 +112,489 @@ esp_err_t PowerControl::init()
     }
     ESP_LOGD(TAG, "GPIO %d configured successfully", gpio_);
 
+    ret = apply_load_drive();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = create_settle_timer();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    attach_telemetry();
+#endif
     initialized_ = true;
-    ret = initial_on_ ? turn_on() : turn_off();
+    // The pin level after reset is not known: always write the initial state
+    ret = apply_gpio(initial_on_, true);
 
     ESP_LOGI(TAG, "Power control initialized successfully");
 
     return ESP_OK;
 }
 
-esp_err_t PowerControl::apply_gpio(bool enable)
+esp_err_t PowerControl::init_all(PowerControl *const *rails, size_t count)
+{
+    // Collect the rails still to initialize that share the HAL of the first one
+    IGpioHAL *hal = nullptr;
+    uint64_t pin_mask = 0;
+    uint64_t set_mask = 0;
+    uint64_t clear_mask = 0;
+    uint64_t on_mask = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        PowerControl *rail = rails[i];
+        if (rail == nullptr || rail->initialized_) {
+            continue;
+        }
+        if (rail->gpio_ < 0 || rail->gpio_ >= GPIO_NUM_MAX) {
+            ESP_LOGE(TAG, "Bulk init: invalid GPIO %d", rail->gpio_);
+            return ESP_ERR_INVALID_ARG;
+        }
+        // Pin numbers are per HAL: pin 0 of an IO expander is not GPIO 0
+        for (size_t j = 0; j < i; j++) {
+            const PowerControl *other = rails[j];
+            if (other != nullptr && !other->initialized_ && &other->hal_ == &rail->hal_ &&
+                other->gpio_ == rail->gpio_) {
+                ESP_LOGE(TAG, "Bulk init: GPIO %d used by two rails", rail->gpio_);
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
+        if (hal == nullptr) {
+            hal = &rail->hal_;
+        }
+        if (&rail->hal_ != hal) {
+            continue; // Initialized one by one below
+        }
+
+        const uint64_t bit = 1ULL << rail->gpio_;
+        pin_mask |= bit;
+        const bool level = rail->inverted_logic_ ? !rail->initial_on_ : rail->initial_on_;
+        (level ? set_mask : clear_mask) |= bit;
+        if (rail->initial_on_) {
+            on_mask |= bit;
+        }
+    }
+
+    if (pin_mask != 0) {
+        // One configuration for every pin, no per-pin reset
+        gpio_config_t io_conf = {};
+        io_conf.mode = GPIO_MODE_INPUT_OUTPUT;
+        io_conf.pin_bit_mask = pin_mask;
+        io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+        io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+        io_conf.intr_type = GPIO_INTR_DISABLE;
+
+        esp_err_t ret = hal->config(io_conf);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Bulk init: failed to configure GPIOs, error: %s", esp_err_to_name(ret));
+            return ret;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            PowerControl *rail = rails[i];
+            if (rail != nullptr && !rail->initialized_ && &rail->hal_ == hal) {
+                ret = rail->apply_load_drive();
+                if (ret == ESP_OK) {
+                    ret = rail->create_settle_timer();
+                }
+                if (ret != ESP_OK) {
+                    return ret;
+                }
+#if CONFIG_POWER_CONTROL_TELEMETRY
+                rail->attach_telemetry();
+#endif
+            }
+        }
+
+        // Every initial level in one masked write
+        ret = hal->set_levels_mask(set_mask, clear_mask);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Bulk init: failed to apply initial levels, error: %s", esp_err_to_name(ret));
+            return ret;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            PowerControl *rail = rails[i];
+            if (rail != nullptr && !rail->initialized_ && &rail->hal_ == hal) {
+                rail->initialized_ = true;
+                rail->commit_state(rail->initial_on_);
+            }
+        }
+
+        ESP_LOGI(
+            TAG,
+            "Bulk init: %d rails initialized (pins=0x%llx, on=0x%llx)",
+            __builtin_popcountll(pin_mask),
+            static_cast<unsigned long long>(pin_mask),
+            static_cast<unsigned long long>(on_mask));
+    }
+
+    // Rails on another HAL cannot share the batched writes
+    for (size_t i = 0; i < count; i++) {
+        PowerControl *rail = rails[i];
+        if (rail != nullptr && !rail->initialized_) {
+            esp_err_t ret = rail->init();
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t PowerControl::warm_init()
+{
+    if (initialized_) {
+        return ESP_OK;
+    }
+
+    // Input enabled first: after a deep-sleep wake the pad may not feed GPIO_IN yet.
+    // Held pads still drive the level they had when the chip went to sleep
+    esp_err_t ret = configure_warm_pin();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    bool level = false;
+    ret = hal_.get_level(gpio_, level);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read back GPIO %d for warm init, error: %s", gpio_, esp_err_to_name(ret));
+        return ret;
+    }
+    return adopt_state(inverted_logic_ ? !level : level);
+}
+
+esp_err_t PowerControl::warm_init(bool retained_on)
+{
+    if (initialized_) {
+        return ESP_OK;
+    }
+    esp_err_t ret = configure_warm_pin();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return adopt_state(retained_on);
+}
+
+esp_err_t PowerControl::configure_warm_pin()
+{
+    // No reset_pin(): the pad keeps its level while the pin is reconfigured
+    gpio_config_t io_conf = {};
+    io_conf.mode = GPIO_MODE_INPUT_OUTPUT;
+    io_conf.pin_bit_mask = 1ULL << gpio_;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+
+    esp_err_t ret = hal_.config(io_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        return ret;
+    }
+    return apply_load_drive();
+}
+
+esp_err_t PowerControl::adopt_state(bool enable)
+{
+    ESP_LOGI(TAG, "Warm init on GPIO %d, adopting state %s", gpio_, enable ? "on" : "off");
+
+    // Load the output register before releasing the hold, so the pad does not glitch
+    const bool level = inverted_logic_ ? !enable : enable;
+    esp_err_t ret = hal_.set_level(gpio_, level);
+    if (ret == ESP_OK) {
+        ret = hal_.set_hold(gpio_, false);
+        if (ret == ESP_ERR_NOT_SUPPORTED) {
+            ret = ESP_OK; // Nothing to release
+        }
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to restore GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = create_settle_timer();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (enable && timer_ != nullptr) {
+        // The device stayed powered through sleep: no new warm-up period
+        on_since_us_ = timer_->get_time_us() - static_cast<int64_t>(settle_time_us_);
+#if CONFIG_POWER_CONTROL_STATS
+        start_period(timer_->get_time_us());
+#endif
+    }
+
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    attach_telemetry();
+    if (enable != is_on()) {
+        PowerTelemetry::record(telemetry_slot_, enable);
+    }
+#endif
+
+    held_ = false;
+    is_on_.store(enable, std::memory_order_release);
+    initialized_ = true;
+    ESP_LOGI(TAG, "Power control warm-initialized successfully");
+    return ESP_OK;
+}
+
+esp_err_t PowerControl::hold_for_sleep(bool deep_sleep)
+{
+    if (!initialized_) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = hal_.set_hold(gpio_, true);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to hold GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        return ret;
+    }
+
+    if (deep_sleep) {
+        ret = hal_.set_deep_sleep_hold(true);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to enable deep-sleep hold, error: %s", esp_err_to_name(ret));
+            hal_.set_hold(gpio_, false); // All or nothing: the rail stays switchable
+            return ret;
+        }
+    }
+    held_ = true;
+    ESP_LOGD(TAG, "GPIO %d held for %s sleep", gpio_, deep_sleep ? "deep" : "light");
+    return ESP_OK;
+}
+
+esp_err_t PowerControl::release_hold()
+{
+    if (!held_) {
+        return ESP_OK;
+    }
+    esp_err_t ret = hal_.set_hold(gpio_, false);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to release hold on GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        return ret;
+    }
+    held_ = false;
+    return ESP_OK;
+}
+
+esp_err_t PowerControl::apply_gpio(bool enable, bool force)
 {
     // Check if the power control is initialized
     if (!initialized_) {
         ESP_LOGE(TAG, "Power control not initialized");
         return ESP_ERR_INVALID_STATE;
     }
+    if (held_) {
+        ESP_LOGE(TAG, "GPIO %d is held for sleep", gpio_);
+        return ESP_ERR_INVALID_STATE;
+    }
+#if CONFIG_POWER_CONTROL_PROTECTION
+    if (enable && get_fault() != PowerFault::NONE) {
+        ESP_LOGE(TAG, "GPIO %d is latched OFF by a fault", gpio_);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!enable) {
+        cancel_fault_retry(); // Switched OFF on purpose: no retry anymore
+    }
+#endif
 
     // Set physical level to logic level
     bool level = inverted_logic_ ? !enable : enable;
-    esp_err_t ret = hal_.set_level(gpio_, level); // Set GPIO
+
+    // Already in the requested state: nothing to write
+    if (idempotent_ && !force && enable == is_on()) {
+        return readback_verify_ ? verify_pin(level) : ESP_OK;
+    }
+
+    // Only a real edge is driven with the boosted strength
+    const bool boost = is_edge_boost() && enable != is_on();
+    if (boost) {
+        esp_err_t ret = hal_.set_drive_capability(gpio_, edge_drive_);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to raise GPIO %d drive for the edge, error: %s", gpio_, esp_err_to_name(ret));
+            return ret;
+        }
+    }
+
+#if CONFIG_POWER_CONTROL_PROTECTION
+    // Published before the write: a fault edge before commit_state() must not look like one on an OFF rail
+    if (enable) {
+        switching_on_.store(true, std::memory_order_seq_cst);
+    }
+#endif
+    esp_err_t ret = write_pin(level); // Set GPIO
+#if CONFIG_POWER_CONTROL_TRACE
+    PowerTrace::record(gpio_, enable, ret);
+#endif
     if (ret != ESP_OK) {
+#if CONFIG_POWER_CONTROL_PROTECTION
+        switching_on_.store(false, std::memory_order_release);
+#endif
+        if (boost) {
+            end_edge_boost(false);
+        }
         ESP_LOGE(TAG, "Failed to set GPIO %d to enable=%d (physical_level=%d)", gpio_, enable, level);
         return ret;
     }
-    else {
-        is_on_ = enable; // Update internal state
-        ESP_LOGD(TAG, "GPIO %d enabled=%d (physical_level=%d)", gpio_, enable, level);
+
+    commit_state(enable); // Update internal state
+#if CONFIG_POWER_CONTROL_PROTECTION
+    if (enable && cut_if_faulted_on_switch(level)) {
+        if (boost) {
+            end_edge_boost(false);
+        }
+        return ESP_ERR_INVALID_STATE;
+    }
+#endif
+    if (boost) {
+        end_edge_boost(true);
+    }
+    ESP_LOGD(TAG, "GPIO %d enabled=%d (physical_level=%d)", gpio_, enable, level);
+    return ESP_OK;
+}
+
+esp_err_t PowerControl::set_load(const PowerLoad &load)
+{
+    gpio_drive_cap_t steady = GPIO_DRIVE_CAP_0;
+    gpio_drive_cap_t edge = GPIO_DRIVE_CAP_0;
+    const uint32_t edge_ma = load.needs_edge_boost() ? load.edge_ma : load.steady_ma;
+    if (!PowerLoad::drive_for(load.steady_ma, steady) || !PowerLoad::drive_for(edge_ma, edge)) {
+        ESP_LOGE(
+            TAG,
+            "Load on GPIO %d needs %u mA, more than the pin can source",
+            gpio_,
+            static_cast<unsigned>(edge_ma));
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    load_set_ = true;
+    steady_drive_ = steady;
+    edge_drive_ = edge;
+    edge_us_ = load.edge_us;
+    ESP_LOGD(TAG, "GPIO %d drive: %d steady, %d on edges", gpio_, steady, edge);
+    return initialized_ ? apply_load_drive() : ESP_OK;
+}
+
+esp_err_t PowerControl::apply_load_drive()
+{
+    if (!load_set_) {
         return ESP_OK;
     }
+    esp_err_t ret = hal_.set_drive_capability(gpio_, steady_drive_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set GPIO %d drive capability to %d", gpio_, steady_drive_);
+    }
+    return ret;
+}
+
+void PowerControl::end_edge_boost(bool wait)
+{
+    if (wait && edge_us_ > 0) {
+        if (timer_ != nullptr) {
+            timer_->delay_us(edge_us_);
+        }
+        else {
+            esp_rom_delay_us(edge_us_);
+        }
+    }
+    // The rail has switched already: a failure only costs the energy saving
+    esp_err_t ret = hal_.set_drive_capability(gpio_, steady_drive_);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to restore GPIO %d drive capability, error: %s", gpio_, esp_err_to_name(ret));
+    }
+}
+
+void PowerControl::commit_state(bool enable)
+{
+    if (enable && !is_on() && timer_ != nullptr) {
+        on_since_us_ = timer_->get_time_us(); // Settle time starts now
+    }
+    if (!enable && ready_cb_ != nullptr) {
+        timer_->stop(settle_timer_); // Rail went down before it settled
+        ready_cb_ = nullptr;
+    }
+    if (!enable) {
+        cancel_auto_off();
+    }
+#if CONFIG_POWER_CONTROL_STATS
+    if (enable != is_on()) {
+        record_transition(enable);
+    }
+#endif
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    if (enable != is_on()) {
+        PowerTelemetry::record(telemetry_slot_, enable);
+    }
+#endif
+    is_on_.store(enable, std::memory_order_release);
+}
+
+esp_err_t PowerControl::create_settle_timer()
+{
+    // Created once; it survives deinit/init cycles
+    if (timer_ == nullptr || settle_timer_ != nullptr) {
+        return ESP_OK;
+    }
+    esp_err_t ret = timer_->create(settle_timer_cb, this, &settle_timer_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create settle timer for GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        settle_timer_ = nullptr;
+    }
+    return ret;
+}
+
+esp_err_t PowerControl::write_pin(bool level)
+{
+    esp_err_t ret = hal_.set_level(gpio_, level);
+    if (ret != ESP_OK || !readback_verify_) {
+        return ret;
+    }
+    return verify_pin(level);
+}
+
+esp_err_t PowerControl::verify_pin(bool level)
+{
+    bool actual = false;
+    esp_err_t ret = hal_.get_level(gpio_, actual);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read back GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        return ret;
+    }
+    if (actual == level) {
+        return ESP_OK;
+    }
+
+    // Pin drifted from the expected level: rewrite it once
+    ESP_LOGW(TAG, "GPIO %d reads %d, expected %d: rewriting", gpio_, actual, level);
+    ret = hal_.set_level(gpio_, level);
+    if (ret == ESP_OK) {
+        ret = hal_.get_level(gpio_, actual);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (actual != level) {
+        ESP_LOGE(TAG, "GPIO %d stuck at level %d", gpio_, actual);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t PowerControl::refresh()
+{
+    if (!initialized_) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (held_) {
+        ESP_LOGE(TAG, "GPIO %d is held for sleep", gpio_);
+        return ESP_ERR_INVALID_STATE;
+    }
+    const bool enable = is_on();
+    return write_pin(inverted_logic_ ? !enable : enable);
 }
 
 esp_err_t PowerControl::turn_on()
@@ -96,9 +609,557 @@ esp_err_t PowerControl::turn_off()
 
 esp_err_t PowerControl::toggle()
 {
-    return apply_gpio(!is_on_);
+    return apply_gpio(!is_on());
 }
 
+esp_err_t PowerControl::set_settle_time_us(uint32_t settle_time_us)
+{
+    if (settle_time_us != 0 && timer_ == nullptr) {
+        ESP_LOGE(TAG, "Settle time on GPIO %d requires a timer HAL", gpio_);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    settle_time_us_ = settle_time_us;
+    return ESP_OK;
+}
+
+int64_t PowerControl::settle_remaining_us() const
+{
+    if (!is_on() || settle_time_us_ == 0 || timer_ == nullptr) {
+        return 0;
+    }
+    int64_t remaining = static_cast<int64_t>(settle_time_us_) - (timer_->get_time_us() - on_since_us_);
+    return remaining > 0 ? remaining : 0;
+}
+
+bool PowerControl::is_ready() const
+{
+    return is_on() && settle_remaining_us() == 0;
+}
+
+esp_err_t PowerControl::turn_on_async(ready_callback_t callback, void *ctx)
+{
+    if (settle_time_us_ != 0 && timer_ == nullptr) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    esp_err_t ret = apply_gpio(true);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Replace any callback still pending from a previous call
+    if (ready_cb_ != nullptr) {
+        timer_->stop(settle_timer_);
+        ready_cb_ = nullptr;
+    }
+
+    int64_t remaining = settle_remaining_us();
+    if (remaining == 0) {
+        if (callback != nullptr) {
+            callback(*this, ctx); // Already settled
+        }
+        return ESP_OK;
+    }
+
+    if (callback == nullptr) {
+        return ESP_OK; // Readiness can still be polled with is_ready()
+    }
+
+    ready_cb_ = callback;
+    ready_ctx_ = ctx;
+    ret = timer_->start_once(settle_timer_, static_cast<uint64_t>(remaining));
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start settle timer for GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        ready_cb_ = nullptr;
+        return ret;
+    }
+    ESP_LOGD(TAG, "GPIO %d ready in %lld us", gpio_, static_cast<long long>(remaining));
+    return ESP_OK;
+}
+
+esp_err_t PowerControl::turn_on_for(uint64_t duration_us)
+{
+    if (!initialized_) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (timer_ == nullptr) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (duration_us == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Only rails that use auto-off pay for the timer
+    esp_err_t ret = ESP_OK;
+    if (auto_off_timer_ == nullptr) {
+        ret = timer_->create(auto_off_timer_cb, this, &auto_off_timer_);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create auto-off timer for GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+            auto_off_timer_ = nullptr;
+            return ret;
+        }
+    }
+
+    // Take the pending expiry back first: an expiry dispatched meanwhile finds nothing to claim
+    const bool was_on = is_on();
+    const int64_t pending = auto_off_deadline_us_.exchange(-1, std::memory_order_acq_rel);
+    ret = apply_gpio(true);
+    if (ret != ESP_OK) {
+        if (pending >= 0) {
+            // The running countdown stays in force; run an expiry skipped meanwhile
+            auto_off_deadline_us_.store(pending, std::memory_order_release);
+            if (timer_->get_time_us() >= pending) {
+                auto_off_timer_cb(this);
+            }
+        }
+        return ret;
+    }
+
+    // Restart the countdown from now
+    timer_->stop(auto_off_timer_);
+    auto_off_deadline_us_.store(timer_->get_time_us() + static_cast<int64_t>(duration_us), std::memory_order_release);
+    ret = timer_->start_once(auto_off_timer_, duration_us);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start auto-off timer for GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        auto_off_deadline_us_.store(-1, std::memory_order_release);
+        if (!was_on) {
+            apply_gpio(false); // Never leave a rail ON without its turn-off
+        }
+        return ret;
+    }
+    ESP_LOGD(TAG, "GPIO %d ON for %llu us", gpio_, static_cast<unsigned long long>(duration_us));
+    return ESP_OK;
+}
+
+esp_err_t PowerControl::pulse(uint64_t duration_us)
+{
+    if (is_on()) {
+        ESP_LOGE(TAG, "Pulse on GPIO %d requested while the rail is ON", gpio_);
+        return ESP_ERR_INVALID_STATE;
+    }
+    return turn_on_for(duration_us);
+}
+
+void PowerControl::cancel_auto_off()
+{
+    if (auto_off_deadline_us_.exchange(-1, std::memory_order_acq_rel) >= 0) {
+        timer_->stop(auto_off_timer_);
+    }
+}
+
+void PowerControl::auto_off_timer_cb(void *arg)
+{
+    PowerControl *self = static_cast<PowerControl *>(arg);
+    // Claimed only if still the deadline that expired: a restarted countdown has a later one
+    int64_t deadline = self->auto_off_deadline_us_.load(std::memory_order_acquire);
+    if (deadline < 0 || self->timer_->get_time_us() < deadline) {
+        return; // Cancelled or restarted while the callback was being dispatched
+    }
+    if (!self->auto_off_deadline_us_.compare_exchange_strong(deadline, -1, std::memory_order_acq_rel)) {
+        return;
+    }
+    esp_err_t ret = self->apply_gpio(false);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Auto-off failed on GPIO %d, error: %s", self->gpio_, esp_err_to_name(ret));
+    }
+}
+
+void PowerControl::settle_timer_cb(void *arg)
+{
+    PowerControl *self = static_cast<PowerControl *>(arg);
+    ready_callback_t callback = self->ready_cb_;
+    self->ready_cb_ = nullptr;
+    if (callback != nullptr && self->is_on()) {
+        callback(*self, self->ready_ctx_);
+    }
+}
+
+#if CONFIG_POWER_CONTROL_STATS
+void PowerControl::record_transition(bool enable)
+{
+    if (enable) {
+        stats_.on_count++;
+        start_period(timer_ != nullptr ? on_since_us_ : -1);
+        return;
+    }
+
+    stats_.off_count++;
+    if (period_timed()) {
+        const uint64_t period = static_cast<uint64_t>(timer_->get_time_us() - stats_on_start_us_);
+        stats_.on_time_us += period;
+        if (period > stats_.longest_on_us) {
+            stats_.longest_on_us = period;
+        }
+    }
+    stats_on_start_us_ = -1;
+}
+
+void PowerControl::start_period(int64_t start_us)
+{
+    stats_on_start_us_ = start_us;
+    stats_start_isr_count_ = isr_on_count_.load(std::memory_order_relaxed) +
+                             isr_off_count_.load(std::memory_order_relaxed);
+}
+
+bool PowerControl::period_timed() const
+{
+    // An ISR switch since the start leaves the period without a known duration
+    return stats_on_start_us_ >= 0 && stats_start_isr_count_ == isr_on_count_.load(std::memory_order_relaxed) +
+                                                                   isr_off_count_.load(std::memory_order_relaxed);
+}
+
+PowerControl::Stats PowerControl::get_stats() const
+{
+    Stats stats = stats_;
+    stats.on_count += isr_on_count_.load(std::memory_order_relaxed);
+    stats.off_count += isr_off_count_.load(std::memory_order_relaxed);
+
+    // Include the period still in progress
+    if (is_on() && period_timed()) {
+        const uint64_t period = static_cast<uint64_t>(timer_->get_time_us() - stats_on_start_us_);
+        stats.on_time_us += period;
+        if (period > stats.longest_on_us) {
+            stats.longest_on_us = period;
+        }
+    }
+
+    // mAh = uA * us / (1000 uA/mA * 3600e6 us/h)
+    stats.charge_mah = static_cast<float>(static_cast<double>(stats.on_time_us) * load_current_ua_ / 3.6e12);
+    return stats;
+}
+
+void PowerControl::reset_stats()
+{
+    stats_ = {};
+    isr_on_count_.store(0, std::memory_order_relaxed);
+    isr_off_count_.store(0, std::memory_order_relaxed);
+    start_period((is_on() && timer_ != nullptr) ? timer_->get_time_us() : -1);
+}
+#endif
+
+#if CONFIG_POWER_CONTROL_TELEMETRY
+void PowerControl::attach_telemetry()
+{
+    if (telemetry_slot_ != PowerTelemetry::NO_SLOT) {
+        return;
+    }
+    telemetry_slot_ = PowerTelemetry::attach(gpio_);
+    if (telemetry_slot_ == PowerTelemetry::NO_SLOT) {
+        ESP_LOGW(TAG, "Telemetry table full: GPIO %d not covered", gpio_);
+    }
+}
+#endif
+
+#if CONFIG_POWER_CONTROL_ISR_API
+esp_err_t IRAM_ATTR PowerControl::apply_gpio_from_isr(bool enable)
+{
+    // No logging here: this path must not touch flash
+    if (!initialized_ || held_) {
+        return ESP_ERR_INVALID_STATE;
+    }
+#if CONFIG_POWER_CONTROL_PROTECTION
+    if (enable && fault_.load(std::memory_order_acquire) != PowerFault::NONE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+#endif
+
+#if CONFIG_POWER_CONTROL_STATS || CONFIG_POWER_CONTROL_TELEMETRY
+    // Not is_on(): a virtual call would read the vtable from flash
+    const bool was_on = is_on_.load(std::memory_order_relaxed);
+#endif
+    bool level = inverted_logic_ ? !enable : enable;
+#if CONFIG_IDF_TARGET_LINUX
+    // No GPIO registers on the host: go through the injected HAL so tests can observe it
+    esp_err_t ret = hal_.set_level(gpio_, level);
+#if CONFIG_POWER_CONTROL_TRACE
+    PowerTrace::record(gpio_, enable, ret);
+#endif
+    if (ret != ESP_OK) {
+        return ret;
+    }
+#else
+    gpio_ll_set_level(&GPIO, gpio_, level);
+#if CONFIG_POWER_CONTROL_TRACE
+    PowerTrace::record(gpio_, enable, ESP_OK);
+#endif
+#endif
+#if CONFIG_POWER_CONTROL_STATS
+    // Count the transition only: reading the time would go through the (flash) timer HAL.
+    // The atomic counters also end the period the task side is timing (see period_timed()).
+    if (enable != was_on) {
+        (enable ? isr_on_count_ : isr_off_count_).fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    if (enable != was_on) {
+        PowerTelemetry::record(telemetry_slot_, enable);
+    }
+#endif
+    is_on_.store(enable, std::memory_order_release);
+    return ESP_OK;
+}
+
+esp_err_t IRAM_ATTR PowerControl::turn_on_from_isr()
+{
+    return apply_gpio_from_isr(true);
+}
+
+esp_err_t IRAM_ATTR PowerControl::turn_off_from_isr()
+{
+    return apply_gpio_from_isr(false);
+}
+#endif
+
+#if CONFIG_POWER_CONTROL_PROTECTION
+esp_err_t PowerControl::set_fault_protection(IFaultSenseHAL &sense, uint32_t retry_delay_us, uint8_t max_retries)
+{
+    if (fault_sense_ != nullptr) {
+        ESP_LOGE(TAG, "Fault protection already enabled on GPIO %d", gpio_);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (max_retries > 0 && timer_ == nullptr) {
+        ESP_LOGE(TAG, "Fault retry on GPIO %d requires a timer HAL", gpio_);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (max_retries > 0 && retry_delay_us == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Only rails that retry pay for the timer
+    esp_err_t ret = ESP_OK;
+    if (max_retries > 0 && fault_retry_timer_ == nullptr) {
+        ret = timer_->create(fault_retry_timer_cb, this, &fault_retry_timer_);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create fault retry timer for GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+            fault_retry_timer_ = nullptr;
+            return ret;
+        }
+    }
+
+    retry_delay_us_ = retry_delay_us;
+    max_retries_ = max_retries;
+    retry_attempts_.store(0);
+    fault_kind_ = sense.get_kind();
+    fault_sense_ = &sense;
+    ret = sense.start(fault_isr, this);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start fault sense for GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        fault_sense_ = nullptr;
+        return ret;
+    }
+
+    // An edge-triggered source does not report a fault that is already present
+    if (is_on() && sense.is_fault_active() && latch_fault()) {
+        fault_count_.fetch_add(1, std::memory_order_relaxed);
+        ESP_LOGE(TAG, "Fault already present on GPIO %d: rail cut", gpio_);
+        apply_gpio(false, true);
+        if (max_retries_ > 0) {
+            schedule_fault_retry();
+        }
+    }
+
+    ESP_LOGI(TAG, "Fault protection enabled on GPIO %d (%u retries)", gpio_, static_cast<unsigned>(max_retries));
+    return ESP_OK;
+}
+
+void PowerControl::disable_fault_protection()
+{
+    if (fault_sense_ == nullptr) {
+        return;
+    }
+    fault_sense_->stop();
+    fault_sense_ = nullptr;
+    cancel_fault_retry();
+}
+
+esp_err_t PowerControl::clear_fault()
+{
+    if (get_fault() == PowerFault::NONE) {
+        return ESP_OK;
+    }
+    if (fault_sense_ != nullptr && fault_sense_->is_fault_active()) {
+        ESP_LOGE(TAG, "Fault on GPIO %d still present", gpio_);
+        return ESP_ERR_INVALID_STATE;
+    }
+    cancel_fault_retry();
+    fault_.store(PowerFault::NONE, std::memory_order_release);
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    PowerTelemetry::record_fault(telemetry_slot_, PowerFault::NONE);
+#endif
+    ESP_LOGI(TAG, "Fault on GPIO %d cleared", gpio_);
+    return ESP_OK;
+}
+
+void IRAM_ATTR PowerControl::fault_isr(void *arg)
+{
+    PowerControl *self = static_cast<PowerControl *>(arg);
+    // A rail being switched ON counts as ON: apply_gpio() commits the state only after its write.
+    // Members are read directly: a virtual call would read the vtable from flash
+    if (!self->is_on_.load(std::memory_order_acquire) && !self->switching_on_.load(std::memory_order_seq_cst)) {
+        return;
+    }
+    // Latched before the cut, so the rail cannot be switched back ON in between. Sources
+    // such as the ADC keep reporting while the fault lasts: only the first report cuts
+    if (!self->latch_fault()) {
+        return;
+    }
+    self->apply_gpio_from_isr(false);
+    self->fault_count_.fetch_add(1, std::memory_order_relaxed);
+
+#if CONFIG_IDF_TARGET_LINUX
+    // Deterministic in host tests: no timer service task to defer to
+    fault_deferred_cb(self, 0);
+#else
+    // The rail is already cut; if the timer queue is full, only the bookkeeping is lost
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    xTimerPendFunctionCallFromISR(fault_deferred_cb, self, 0, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+#endif
+}
+
+bool IRAM_ATTR PowerControl::latch_fault()
+{
+    PowerFault expected = PowerFault::NONE;
+    if (!fault_.compare_exchange_strong(expected, fault_kind_, std::memory_order_seq_cst)) {
+        return false;
+    }
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    PowerTelemetry::record_fault(telemetry_slot_, fault_kind_);
+#endif
+    return true;
+}
+
+bool PowerControl::cut_if_faulted_on_switch(bool level)
+{
+    // Pairs with the seq_cst latch in fault_isr(): either the ISR saw switching_on_, or this sees its latch
+    bool latched_here = false;
+    if (get_fault() == PowerFault::NONE && fault_sense_ != nullptr && fault_sense_->is_fault_active()) {
+        latched_here = latch_fault(); // Edge lost, or the rail switched ON into a fault already present
+    }
+    switching_on_.store(false, std::memory_order_seq_cst);
+    if (get_fault() == PowerFault::NONE) {
+        return false;
+    }
+
+    write_pin(!level);
+#if CONFIG_POWER_CONTROL_TRACE
+    PowerTrace::record(gpio_, false, ESP_OK);
+#endif
+    commit_state(false); // The ISR cut may have come before commit_state(true)
+    if (latched_here) {
+        fault_count_.fetch_add(1, std::memory_order_relaxed);
+        fault_deferred_cb(this, 0);
+    }
+    else {
+        ESP_LOGE(TAG, "GPIO %d latched OFF by a fault while switching ON", gpio_);
+    }
+    return true;
+}
+
+void PowerControl::fault_deferred_cb(void *arg, uint32_t unused)
+{
+    (void)unused;
+    PowerControl *self = static_cast<PowerControl *>(arg);
+    ESP_LOGE(
+        TAG,
+        "Fault on GPIO %d (%s): rail cut",
+        self->gpio_,
+        self->fault_kind_ == PowerFault::OVERCURRENT ? "overcurrent" : "fault input");
+
+    // Pending readiness and auto-off of the cut rail are void
+    self->commit_state(false);
+    if (self->retry_attempts_.load() < self->max_retries_) {
+        self->schedule_fault_retry(); // Also ends a stability window: the attempts keep counting
+    }
+    else if (self->retry_state_.exchange(RetryState::IDLE) != RetryState::IDLE) {
+        self->timer_->stop(self->fault_retry_timer_);
+    }
+}
+
+uint64_t PowerControl::fault_backoff_us(uint8_t attempt) const
+{
+    // Exponential backoff, capped so that the shift cannot overflow
+    const uint32_t shift = attempt < 20 ? attempt : 20;
+    return static_cast<uint64_t>(retry_delay_us_) << shift;
+}
+
+void PowerControl::schedule_fault_retry()
+{
+    const uint64_t delay_us = fault_backoff_us(retry_attempts_.load());
+
+    timer_->stop(fault_retry_timer_);
+    retry_state_.store(RetryState::PENDING);
+    esp_err_t ret = timer_->start_once(fault_retry_timer_, delay_us);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start fault retry timer for GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        retry_state_.store(RetryState::IDLE);
+        return; // Stays latched
+    }
+    ESP_LOGD(TAG, "GPIO %d retry in %llu us", gpio_, static_cast<unsigned long long>(delay_us));
+}
+
+void PowerControl::cancel_fault_retry()
+{
+    if (retry_state_.exchange(RetryState::IDLE) != RetryState::IDLE) {
+        timer_->stop(fault_retry_timer_);
+    }
+    retry_attempts_.store(0);
+}
+
+void PowerControl::fault_retry_timer_cb(void *arg)
+{
+    PowerControl *self = static_cast<PowerControl *>(arg);
+    const RetryState state = self->retry_state_.exchange(RetryState::IDLE);
+    if (state == RetryState::STABLE) {
+        // Up for a whole backoff since the last retry: the next fault starts over
+        if (self->get_fault() == PowerFault::NONE) {
+            self->retry_attempts_.store(0);
+            ESP_LOGD(TAG, "GPIO %d stable after fault retry: attempts reset", self->gpio_);
+        }
+        return;
+    }
+    if (state != RetryState::PENDING) {
+        return; // Cancelled while the callback was being dispatched
+    }
+    const uint8_t attempts = self->retry_attempts_.fetch_add(1) + 1;
+
+    if (self->fault_sense_ != nullptr && self->fault_sense_->is_fault_active()) {
+        if (attempts < self->max_retries_) {
+            self->schedule_fault_retry();
+        }
+        else {
+            ESP_LOGE(
+                TAG,
+                "Fault on GPIO %d persists after %u retries: latched",
+                self->gpio_,
+                static_cast<unsigned>(attempts));
+        }
+        return;
+    }
+
+    // Released before the write; a fault that trips again latches it anew
+    self->fault_.store(PowerFault::NONE, std::memory_order_release);
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    PowerTelemetry::record_fault(self->telemetry_slot_, PowerFault::NONE);
+#endif
+    esp_err_t ret = self->apply_gpio(true);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Fault retry failed on GPIO %d, error: %s", self->gpio_, esp_err_to_name(ret));
+        return;
+    }
+    ESP_LOGW(TAG, "GPIO %d back ON after fault (retry %u)", self->gpio_, static_cast<unsigned>(attempts));
+
+    // Reset the attempts once the rail has stayed up for as long as the backoff it waited
+    self->retry_state_.store(RetryState::STABLE);
+    ret = self->timer_->start_once(self->fault_retry_timer_, self->fault_backoff_us(attempts - 1));
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to time fault retry window of GPIO %d, error: %s", self->gpio_, esp_err_to_name(ret));
+        self->retry_state_.store(RetryState::IDLE);
+    }
+}
+#endif
+
 esp_err_t PowerControl::deinit()
 {
     if (!initialized_) {
@@ -108,11 +1169,23 @@ esp_err_t PowerControl::deinit()
     esp_err_t final_ret = ESP_OK;
     esp_err_t ret;
 
+    // A held pad would ignore the writes below
+    if (held_) {
+        ret = hal_.set_hold(gpio_, false);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to release hold during deinit");
+            final_ret = ret; // Store error but continue
+        }
+        held_ = false;
+    }
+
     // Force GPIO low before deinitialization for safety
     ret = hal_.set_level(gpio_, 0);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set GPIO low during deinit");
-        final_ret = ret; // Store error but continue
+        if (final_ret == ESP_OK) {
+            final_ret = ret; // Store error but continue
+        }
     }
 
     // Reset GPIO (returns to high-impedance state)
@@ -124,9 +1197,30 @@ esp_err_t PowerControl::deinit()
         }
     }
 
+    // Cancel a pending readiness notification
+    if (ready_cb_ != nullptr) {
+        timer_->stop(settle_timer_);
+        ready_cb_ = nullptr;
+    }
+    cancel_auto_off();
+#if CONFIG_POWER_CONTROL_PROTECTION
+    cancel_fault_retry();
+#endif
+
+#if CONFIG_POWER_CONTROL_STATS
+    if (is_on()) {
+        record_transition(false);
+    }
+#endif
+#if CONFIG_POWER_CONTROL_TELEMETRY
+    if (is_on()) {
+        PowerTelemetry::record(telemetry_slot_, false);
+    }
+#endif
+
     // Mark as deinitialized regardless of hardware errors
     initialized_ = false;
-    is_on_ = false;
+    is_on_.store(false, std::memory_order_release);
     ESP_LOGI(
         TAG,
         "Power control deinitialized on GPIO %d (status: %s)",
@@ -148,6 +1242,10 @@ esp_err_t PowerControl::set_drive_capability(gpio_drive_cap_t strength)
         ESP_LOGE(TAG, "Failed to set GPIO %d drive capability to %d", gpio_, strength);
         return ret;
     }
+    // Manual strength: no automatic selection or edge boost anymore
+    load_set_ = false;
+    steady_drive_ = strength;
+    edge_drive_ = strength;
     ESP_LOGD(TAG, "GPIO %d drive capability set to %d ", gpio_, strength);
     return ret;
 }
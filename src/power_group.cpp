@@ -0,0 +1,201 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "dedic_gpio_hal.hpp"
+#include "power_group.hpp"
+
+namespace power_control {
+
+static const char *TAG = "PowerGroup";
+
+PowerGroup::PowerGroup(IGpioHAL &hal, const Rail *rails, size_t count, const bool initial_on)
+    : hal_(hal)
+    , initial_on_(initial_on)
+{
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t bit = bit_of(rails[i].gpio);
+        if (bit == 0 || (pin_mask_ & bit) != 0) {
+            valid_ = false; // Reported by init()
+            continue;
+        }
+        pin_mask_ |= bit;
+        if (rails[i].inverted_logic) {
+            on_clear_mask_ |= bit;
+        }
+        else {
+            on_set_mask_ |= bit;
+        }
+    }
+}
+
+PowerGroup::PowerGroup(DedicGpioHAL &hal, const Rail *rails, size_t count, const bool initial_on)
+    : PowerGroup(static_cast<IGpioHAL &>(hal), rails, count, initial_on)
+{
+    if (valid_ && pin_mask_ != 0 && (pin_mask_ & ~hal.get_pin_mask()) == 0) {
+        dedic_ = &hal;
+        channel_mask_ = hal.to_channels(pin_mask_);
+        inverted_channels_ = hal.to_channels(on_clear_mask_);
+    }
+}
+
+esp_err_t PowerGroup::init()
+{
+    if (initialized_) {
+        return ESP_OK;
+    }
+
+    if (!valid_ || pin_mask_ == 0) {
+        ESP_LOGE(TAG, "Invalid rail list (empty, invalid or duplicated GPIO)");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ESP_LOGI(
+        TAG,
+        "Initializing power group (pins=0x%llx, inverted=0x%llx, initial_%s)",
+        static_cast<unsigned long long>(pin_mask_),
+        static_cast<unsigned long long>(on_clear_mask_),
+        initial_on_ ? "on" : "off");
+
+    // Reset every GPIO before initialization
+    esp_err_t ret = hal_.reset_pins_mask(pin_mask_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to reset power group GPIOs, error: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Set all GPIOs as output with a single configuration
+    gpio_config_t io_conf = {};
+    io_conf.mode = GPIO_MODE_INPUT_OUTPUT;
+    io_conf.pin_bit_mask = pin_mask_;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+
+    ret = hal_.config(io_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure power group, error: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    initialized_ = true;
+    ret = initial_on_ ? turn_on_all() : turn_off_all();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to apply initial state, error: %s", esp_err_to_name(ret));
+        initialized_ = false;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Power group initialized successfully");
+
+    return ESP_OK;
+}
+
+esp_err_t PowerGroup::write_state(uint64_t on_mask)
+{
+    // Check if the power group is initialized
+    if (!initialized_) {
+        ESP_LOGE(TAG, "Power group not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Rails ON take their active level, rails OFF take the opposite one
+    const uint64_t off_mask = pin_mask_ & ~on_mask;
+    const uint64_t set_mask = (on_mask & on_set_mask_) | (off_mask & on_clear_mask_);
+    const uint64_t clear_mask = (on_mask & on_clear_mask_) | (off_mask & on_set_mask_);
+
+    esp_err_t ret = ESP_OK;
+    if (dedic_ != nullptr && dedic_->is_active()) {
+        // Channel levels are the logical state XOR the polarity; all/none need no translation
+        const uint32_t on_channels = on_mask == pin_mask_ ? channel_mask_
+                                     : on_mask == 0      ? 0
+                                                         : dedic_->to_channels(on_mask);
+        ret = dedic_->write_channels(channel_mask_, on_channels ^ inverted_channels_);
+    }
+    else {
+        ret = hal_.set_levels_mask(set_mask, clear_mask);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to apply state 0x%llx", static_cast<unsigned long long>(on_mask));
+        return ret;
+    }
+
+    state_mask_ = on_mask; // Update internal state
+    ESP_LOGD(
+        TAG,
+        "State 0x%llx applied (set=0x%llx, clear=0x%llx)",
+        static_cast<unsigned long long>(on_mask),
+        static_cast<unsigned long long>(set_mask),
+        static_cast<unsigned long long>(clear_mask));
+    return ESP_OK;
+}
+
+esp_err_t PowerGroup::turn_on_all()
+{
+    return write_state(pin_mask_);
+}
+
+esp_err_t PowerGroup::turn_off_all()
+{
+    return write_state(0);
+}
+
+esp_err_t PowerGroup::apply_mask(uint64_t on_mask)
+{
+    if ((on_mask & ~pin_mask_) != 0) {
+        ESP_LOGE(TAG, "Mask 0x%llx contains pins outside the group", static_cast<unsigned long long>(on_mask));
+        return ESP_ERR_INVALID_ARG;
+    }
+    return write_state(on_mask);
+}
+
+esp_err_t PowerGroup::set_drive_capability(gpio_drive_cap_t strength)
+{
+    if (!initialized_) {
+        ESP_LOGE(TAG, "Power group not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = hal_.set_drive_capability_mask(pin_mask_, strength);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set power group drive capability to %d", strength);
+        return ret;
+    }
+    ESP_LOGD(TAG, "Power group drive capability set to %d", strength);
+    return ESP_OK;
+}
+
+esp_err_t PowerGroup::deinit()
+{
+    if (!initialized_) {
+        return ESP_OK;
+    }
+
+    esp_err_t final_ret = ESP_OK;
+
+    // Force every GPIO low before deinitialization for safety
+    esp_err_t ret = hal_.set_levels_mask(0, pin_mask_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set GPIOs low during deinit");
+        final_ret = ret; // Store error but continue
+    }
+
+    // Reset every GPIO (returns to high-impedance state)
+    ret = hal_.reset_pins_mask(pin_mask_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to reset GPIOs during deinit");
+        if (final_ret == ESP_OK) {
+            final_ret = ret; // Only override if no previous error
+        }
+    }
+
+    // Mark as deinitialized regardless of hardware errors
+    initialized_ = false;
+    state_mask_ = 0;
+    ESP_LOGI(TAG, "Power group deinitialized (status: %s)", final_ret == ESP_OK ? "OK" : "partial failure");
+
+    return final_ret;
+}
+
+} // namespace power_control
@@ -0,0 +1,153 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "power_control.hpp"
+#include "power_profile.hpp"
+#include "power_trace.hpp"
+
+namespace power_control {
+
+static const char *TAG = "PowerProfileGroup";
+
+PowerProfileGroup::PowerProfileGroup(PowerControl *const *rails, size_t count)
+    : rails_(rails)
+    , count_(count)
+{
+    const IGpioHAL *hal = count > 0 && rails[0] != nullptr ? &rails[0]->hal_ : nullptr;
+    for (size_t i = 0; i < count; i++) {
+        const PowerControl *rail = rails[i];
+        if (rail == nullptr || rail->gpio_ < 0 || rail->gpio_ >= GPIO_NUM_MAX || &rail->hal_ != hal) {
+            valid_ = false; // Reported by apply_profile()
+            continue;
+        }
+        const uint64_t bit = 1ULL << rail->gpio_;
+        if ((pin_mask_ & bit) != 0) {
+            valid_ = false;
+            continue;
+        }
+        pin_mask_ |= bit;
+        if (rail->inverted_logic_) {
+            active_low_mask_ |= bit;
+        }
+    }
+}
+
+PowerProfile PowerProfileGroup::snapshot() const
+{
+    uint64_t on_mask = 0;
+    for (size_t i = 0; i < count_; i++) {
+        if (rails_[i] != nullptr && rails_[i]->is_on()) {
+            on_mask |= 1ULL << rails_[i]->gpio_;
+        }
+    }
+    return PowerProfile(on_mask & pin_mask_);
+}
+
+bool PowerProfileGroup::contains(const IPowerControl *rail) const
+{
+    for (size_t i = 0; i < count_; i++) {
+        if (rail != nullptr && static_cast<const IPowerControl *>(rails_[i]) == rail) {
+            return true;
+        }
+    }
+    return false;
+}
+
+esp_err_t PowerProfileGroup::check_switch(gpio_num_t gpio, bool on) const
+{
+    for (size_t i = 0; valid_ && i < count_; i++) {
+        if (rails_[i]->gpio_ == gpio) {
+            return check_rail(*rails_[i], on);
+        }
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t PowerProfileGroup::check_rail(const PowerControl &rail, bool on)
+{
+    if (!rail.initialized_ || rail.held_) {
+        ESP_LOGE(TAG, "GPIO %d is not initialized or held for sleep", rail.gpio_);
+        return ESP_ERR_INVALID_STATE;
+    }
+#if CONFIG_POWER_CONTROL_PROTECTION
+    if (on && !rail.is_on() && rail.get_fault() != PowerFault::NONE) {
+        ESP_LOGE(TAG, "GPIO %d is latched OFF by a fault", rail.gpio_);
+        return ESP_ERR_INVALID_STATE;
+    }
+#else
+    (void)on;
+#endif
+    return ESP_OK;
+}
+
+esp_err_t PowerProfileGroup::apply_profile(const PowerProfile &profile, uint64_t rail_mask)
+{
+    if (!valid_ || count_ == 0) {
+        ESP_LOGE(TAG, "Invalid rail list (empty, nullptr, invalid or duplicated GPIO, or mixed HALs)");
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint64_t target = profile.get_on_mask();
+    if ((target & ~pin_mask_) != 0) {
+        ESP_LOGE(TAG, "Profile 0x%llx contains pins outside the group", static_cast<unsigned long long>(target));
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < count_; i++) {
+        const uint64_t bit = 1ULL << rails_[i]->gpio_;
+        if ((rail_mask & bit) == 0) {
+            continue; // Left as it is
+        }
+        esp_err_t ret = check_rail(*rails_[i], (target & bit) != 0);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    // Only the rails that change are written
+    const uint64_t delta = (snapshot().get_on_mask() ^ target) & rail_mask;
+    if (delta == 0) {
+        return ESP_OK;
+    }
+    const uint64_t on = delta & target;
+    const uint64_t off = delta & ~target;
+    const uint64_t set_mask = (on & ~active_low_mask_) | (off & active_low_mask_);
+    const uint64_t clear_mask = (on & active_low_mask_) | (off & ~active_low_mask_);
+
+    esp_err_t ret = rails_[0]->hal_.set_levels_mask(set_mask, clear_mask);
+    if (ret != ESP_OK) {
+        ESP_LOGE(
+            TAG,
+            "Failed to apply profile 0x%llx, error: %s",
+            static_cast<unsigned long long>(target),
+            esp_err_to_name(ret));
+    }
+
+    for (size_t i = 0; i < count_; i++) {
+        PowerControl *rail = rails_[i];
+        const uint64_t bit = 1ULL << rail->gpio_;
+        if ((delta & bit) == 0) {
+            continue;
+        }
+#if CONFIG_POWER_CONTROL_TRACE
+        PowerTrace::record(rail->gpio_, (target & bit) != 0, ret);
+#endif
+        if (ret == ESP_OK) {
+            rail->commit_state((target & bit) != 0);
+        }
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ESP_LOGD(
+        TAG,
+        "Profile 0x%llx applied (set=0x%llx, clear=0x%llx)",
+        static_cast<unsigned long long>(target),
+        static_cast<unsigned long long>(set_mask),
+        static_cast<unsigned long long>(clear_mask));
+    return ESP_OK;
+}
+
+} // namespace power_control
@@ -0,0 +1,357 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "power_scheduler.hpp"
+
+namespace power_control {
+
+static const char *TAG = "PowerScheduler";
+
+/// Marks a batch entry already handled by the group write or the turn-off pass
+static constexpr uint8_t HANDLED = 0xFF;
+
+/// group_pin_ of a schedule whose rail is not in the group
+static constexpr uint8_t NO_PIN = 0xFF;
+
+PowerScheduler::PowerScheduler(ITimerHAL &timer, const PowerSchedule *schedules, size_t count)
+    : timer_(timer)
+    , schedules_(schedules)
+    , count_(count)
+{
+}
+
+PowerScheduler::~PowerScheduler()
+{
+    if (timer_handle_ != nullptr) {
+        timer_.stop(timer_handle_);
+        timer_.remove(timer_handle_);
+    }
+}
+
+esp_err_t PowerScheduler::start()
+{
+    if (state_.load(std::memory_order_acquire) != RunState::STOPPED) {
+        ESP_LOGE(TAG, "Scheduler already running");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (count_ > MAX_RAILS) {
+        ESP_LOGE(
+            TAG,
+            "%u schedules exceed the limit of %u",
+            static_cast<unsigned>(count_),
+            static_cast<unsigned>(MAX_RAILS));
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < count_; i++) {
+        const PowerSchedule &s = schedules_[i];
+        if (s.rail == nullptr || s.period_us == 0 || s.on_us > s.period_us) {
+            ESP_LOGE(TAG, "Schedule %u is invalid", static_cast<unsigned>(i));
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    // Create the timer on first use; it is kept for later runs
+    if (timer_handle_ == nullptr) {
+        esp_err_t ret = timer_.create(timer_cb, this, &timer_handle_);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create scheduler timer, error: %s", esp_err_to_name(ret));
+            timer_handle_ = nullptr;
+            return ret;
+        }
+    }
+
+    const int64_t now = timer_.get_time_us();
+    active_group_ = group_;
+    heap_size_ = 0;
+    error_count_ = 0;
+    for (size_t i = 0; i < count_; i++) {
+        const PowerSchedule &s = schedules_[i];
+        on_[i] = false;
+        rail_on_[i] = false;
+        group_pin_[i] = NO_PIN;
+        if (active_group_ != nullptr && active_group_->contains(s.rail)) {
+            group_pin_[i] = static_cast<uint8_t>(s.rail->get_pin());
+        }
+        if (s.on_us == 0) {
+            continue; // Never ON: no events
+        }
+        const uint64_t phase = auto_stagger_ ? s.period_us * i / count_ : s.phase_us;
+        next_us_[i] = now + static_cast<int64_t>(phase);
+        heap_push(static_cast<uint8_t>(i));
+    }
+
+    ESP_LOGD(TAG, "Starting schedule (%u rails)", static_cast<unsigned>(count_));
+    // The first wake-up runs here: a rail's turn_on() may already call stop()
+    state_.store(RunState::IN_WAKE, std::memory_order_release);
+    esp_err_t ret = run(now);
+    end_wake();
+    if (ret != ESP_OK) {
+        stop();
+        return ret;
+    }
+    return ESP_OK;
+}
+
+esp_err_t PowerScheduler::stop()
+{
+    RunState state = state_.load(std::memory_order_acquire);
+    while (true) {
+        if (state == RunState::IN_WAKE) {
+            if (state_.compare_exchange_weak(state, RunState::STOP_PENDING)) {
+                return ESP_OK; // The wake-up switches the rails OFF when it ends
+            }
+            continue;
+        }
+        if (state == RunState::STOP_PENDING) {
+            return ESP_OK;
+        }
+        if (state == RunState::STOPPED || state_.compare_exchange_weak(state, RunState::STOPPED)) {
+            break; // Claimed: a timer expiry from now on finds the schedule stopped
+        }
+    }
+    if (timer_handle_ != nullptr) {
+        timer_.stop(timer_handle_);
+    }
+    return switch_off_rails();
+}
+
+void PowerScheduler::end_wake()
+{
+    RunState expected = RunState::IN_WAKE;
+    if (state_.compare_exchange_strong(expected, RunState::ARMED)) {
+        return;
+    }
+    // stop() was called during the wake-up; arm() may have re-armed the timer
+    timer_.stop(timer_handle_);
+    switch_off_rails();
+    state_.store(RunState::STOPPED, std::memory_order_release);
+}
+
+esp_err_t PowerScheduler::switch_off_rails()
+{
+    heap_size_ = 0;
+
+    // Rails of the group go OFF in one write; on failure they are retried one by one
+    uint64_t off_mask = 0;
+    for (size_t i = 0; i < count_ && i < MAX_RAILS; i++) {
+        on_[i] = false;
+        if (rail_on_[i] && group_pin_[i] != NO_PIN) {
+            off_mask |= 1ULL << group_pin_[i];
+        }
+    }
+    if (off_mask != 0 &&
+        active_group_->apply_profile(PowerProfile(active_group_->snapshot().get_on_mask() & ~off_mask)) == ESP_OK) {
+        for (size_t i = 0; i < count_ && i < MAX_RAILS; i++) {
+            rail_on_[i] = rail_on_[i] && group_pin_[i] == NO_PIN;
+        }
+    }
+
+    esp_err_t final_ret = ESP_OK;
+    for (size_t i = 0; i < count_ && i < MAX_RAILS; i++) {
+        if (!rail_on_[i]) {
+            continue;
+        }
+        esp_err_t ret = schedules_[i].rail->turn_off();
+        if (ret != ESP_OK) {
+            ESP_LOGE(
+                TAG,
+                "Failed to switch schedule %u OFF, error: %s",
+                static_cast<unsigned>(i),
+                esp_err_to_name(ret));
+            if (final_ret == ESP_OK) {
+                final_ret = ret;
+            }
+            continue; // Still ON: the next stop() retries
+        }
+        rail_on_[i] = false;
+    }
+    ESP_LOGD(TAG, "Schedule stopped");
+    return final_ret;
+}
+
+esp_err_t PowerScheduler::run(int64_t now_us)
+{
+    if (heap_size_ == 0 || next_us_[heap_[0]] > now_us) {
+        return arm(now_us); // Nothing due yet
+    }
+
+    // Take every event due by now, plus those due within the coalescing window
+    const int64_t deadline = now_us + coalesce_window_us_;
+    uint8_t batch[MAX_RAILS];
+    size_t batch_size = 0;
+    while (heap_size_ > 0 && next_us_[heap_[0]] <= deadline) {
+        batch[batch_size++] = heap_pop();
+    }
+
+    if (active_group_ != nullptr) {
+        apply_group(batch, batch_size, now_us);
+    }
+
+    // Turn-offs first, so no inrush overlaps a rail that is going down anyway
+    for (size_t k = 0; k < batch_size && !stop_pending(); k++) {
+        if (batch[k] != HANDLED && on_[batch[k]]) {
+            if (apply_event(batch[k], now_us)) {
+                heap_push(batch[k]);
+            }
+            batch[k] = HANDLED;
+        }
+    }
+    for (size_t k = 0; k < batch_size && !stop_pending(); k++) {
+        if (batch[k] != HANDLED && apply_event(batch[k], now_us)) {
+            heap_push(batch[k]);
+        }
+    }
+
+    return arm(now_us);
+}
+
+void PowerScheduler::apply_group(uint8_t *batch, size_t batch_size, int64_t now_us)
+{
+    uint64_t on_mask = 0;
+    uint64_t off_mask = 0;
+    for (size_t k = 0; k < batch_size; k++) {
+        const uint8_t pin = group_pin_[batch[k]];
+        if (pin == NO_PIN) {
+            continue;
+        }
+        if (on_[batch[k]]) {
+            off_mask |= 1ULL << pin;
+        }
+        else {
+            on_mask |= 1ULL << pin;
+        }
+    }
+    if ((on_mask | off_mask) == 0) {
+        return;
+    }
+
+    // Rails of the group that are not due keep their current state
+    const uint64_t target = (active_group_->snapshot().get_on_mask() & ~off_mask) | on_mask;
+    esp_err_t ret = active_group_->apply_profile(PowerProfile(target));
+    if (ret != ESP_OK) {
+        // One refused rail must not make the others miss their events
+        ESP_LOGW(TAG, "Group write failed (%s), switching the rails one by one", esp_err_to_name(ret));
+        return;
+    }
+    for (size_t k = 0; k < batch_size; k++) {
+        if (group_pin_[batch[k]] != NO_PIN) {
+            if (apply_event(batch[k], now_us, true)) {
+                heap_push(batch[k]);
+            }
+            batch[k] = HANDLED;
+        }
+    }
+}
+
+bool PowerScheduler::apply_event(size_t index, int64_t now_us, bool switched)
+{
+    const PowerSchedule &s = schedules_[index];
+    const bool turn_on = !on_[index];
+    esp_err_t ret = ESP_OK;
+    if (!switched) {
+        ret = turn_on ? s.rail->turn_on() : s.rail->turn_off();
+    }
+    if (ret != ESP_OK) {
+        // Keep the timing; the next event switches the rail again
+        ESP_LOGE(
+            TAG,
+            "Failed to switch schedule %u %s, error: %s",
+            static_cast<unsigned>(index),
+            turn_on ? "ON" : "OFF",
+            esp_err_to_name(ret));
+        error_count_++;
+    }
+    else {
+        rail_on_[index] = turn_on;
+    }
+    on_[index] = turn_on; // The phase moves on either way
+
+    if (turn_on) {
+        if (s.on_us == s.period_us) {
+            return false; // Always ON: nothing left to do
+        }
+        next_us_[index] += static_cast<int64_t>(s.on_us);
+        return true;
+    }
+
+    // Next cycle start; cycles that were missed entirely are skipped, not replayed
+    int64_t next = next_us_[index] + static_cast<int64_t>(s.period_us - s.on_us);
+    if (next + static_cast<int64_t>(s.on_us) <= now_us) {
+        const int64_t period = static_cast<int64_t>(s.period_us);
+        next += ((now_us - next) / period + 1) * period;
+    }
+    next_us_[index] = next;
+    return true;
+}
+
+esp_err_t PowerScheduler::arm(int64_t now_us)
+{
+    if (heap_size_ == 0) {
+        return ESP_OK;
+    }
+    const int64_t delay = next_us_[heap_[0]] - now_us;
+    esp_err_t ret = timer_.start_once(timer_handle_, delay > 0 ? static_cast<uint64_t>(delay) : 0);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to arm scheduler timer, error: %s", esp_err_to_name(ret));
+        error_count_++;
+    }
+    return ret;
+}
+
+void PowerScheduler::heap_push(uint8_t index)
+{
+    size_t pos = heap_size_++;
+    heap_[pos] = index;
+    while (pos > 0) {
+        const size_t parent = (pos - 1) / 2;
+        if (!heap_less(pos, parent)) {
+            break;
+        }
+        const uint8_t tmp = heap_[parent];
+        heap_[parent] = heap_[pos];
+        heap_[pos] = tmp;
+        pos = parent;
+    }
+}
+
+uint8_t PowerScheduler::heap_pop()
+{
+    const uint8_t top = heap_[0];
+    heap_[0] = heap_[--heap_size_];
+    size_t pos = 0;
+    while (true) {
+        const size_t left = 2 * pos + 1;
+        const size_t right = left + 1;
+        size_t smallest = pos;
+        if (left < heap_size_ && heap_less(left, smallest)) {
+            smallest = left;
+        }
+        if (right < heap_size_ && heap_less(right, smallest)) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        const uint8_t tmp = heap_[smallest];
+        heap_[smallest] = heap_[pos];
+        heap_[pos] = tmp;
+        pos = smallest;
+    }
+    return top;
+}
+
+void PowerScheduler::timer_cb(void *arg)
+{
+    PowerScheduler *self = static_cast<PowerScheduler *>(arg);
+    RunState expected = RunState::ARMED;
+    if (!self->state_.compare_exchange_strong(expected, RunState::IN_WAKE)) {
+        return; // Stopped
+    }
+    self->run(self->timer_.get_time_us());
+    self->end_wake();
+}
+
+} // namespace power_control
@@ -0,0 +1,172 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "power_sequencer.hpp"
+
+namespace power_control {
+
+static const char *TAG = "PowerSequencer";
+
+PowerSequencer::PowerSequencer(ITimerHAL &timer, const PowerSequenceStep *steps, size_t count)
+    : timer_(timer)
+    , steps_(steps)
+    , count_(count)
+{
+}
+
+PowerSequencer::~PowerSequencer()
+{
+    if (timer_handle_ != nullptr) {
+        timer_.stop(timer_handle_);
+        timer_.remove(timer_handle_);
+    }
+}
+
+esp_err_t PowerSequencer::power_up(done_callback_t callback, void *ctx)
+{
+    return start(true, callback, ctx);
+}
+
+esp_err_t PowerSequencer::power_down(done_callback_t callback, void *ctx)
+{
+    return start(false, callback, ctx);
+}
+
+esp_err_t PowerSequencer::start(bool forward, done_callback_t callback, void *ctx)
+{
+    if (running_) {
+        ESP_LOGE(TAG, "Sequence already running");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    for (size_t i = 0; i < count_; i++) {
+        if (steps_[i].rail == nullptr) {
+            ESP_LOGE(TAG, "Step %u has no rail", static_cast<unsigned>(i));
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    // Create the timer on first use; it is kept for later runs
+    if (timer_handle_ == nullptr) {
+        esp_err_t ret = timer_.create(timer_cb, this, &timer_handle_);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create sequence timer, error: %s", esp_err_to_name(ret));
+            timer_handle_ = nullptr;
+            return ret;
+        }
+    }
+
+    ESP_LOGD(
+        TAG,
+        "Starting %s sequence (%u steps)",
+        forward ? "power-up" : "power-down",
+        static_cast<unsigned>(count_));
+
+    forward_ = forward;
+    callback_ = callback;
+    ctx_ = ctx;
+    position_ = 0;
+    waited_ = false;
+    running_ = true;
+    run();
+    return ESP_OK;
+}
+
+esp_err_t PowerSequencer::cancel()
+{
+    if (!running_) {
+        return ESP_OK;
+    }
+    running_ = false;
+    waited_ = false;
+    ESP_LOGD(TAG, "Sequence cancelled at step %u", static_cast<unsigned>(position_));
+    return timer_.stop(timer_handle_);
+}
+
+void PowerSequencer::run()
+{
+    while (position_ < count_) {
+        // Arm the timer for the delay before this step and come back later
+        const uint32_t delay = delay_before(position_);
+        if (delay > 0 && !waited_) {
+            waited_ = true;
+            esp_err_t ret = timer_.start_once(timer_handle_, delay);
+            if (ret != ESP_OK) {
+                ESP_LOGE(
+                    TAG,
+                    "Failed to schedule step %u, error: %s",
+                    static_cast<unsigned>(position_),
+                    esp_err_to_name(ret));
+                finish(ret);
+            }
+            return;
+        }
+        waited_ = false;
+
+        esp_err_t ret = apply_step(position_, false);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Step %u failed, error: %s", static_cast<unsigned>(position_), esp_err_to_name(ret));
+            finish(ret);
+            return;
+        }
+        position_++;
+    }
+    finish(ESP_OK);
+}
+
+esp_err_t PowerSequencer::apply_step(size_t index, bool undo)
+{
+    const PowerSequenceStep &step = forward_ ? steps_[index] : steps_[count_ - 1 - index];
+    bool on = forward_ ? step.turn_on : !step.turn_on;
+    if (undo) {
+        on = !on;
+    }
+    return on ? step.rail->turn_on() : step.rail->turn_off();
+}
+
+uint32_t PowerSequencer::delay_before(size_t index) const
+{
+    if (forward_) {
+        return steps_[index].delay_us;
+    }
+    // In reverse, keep the spacing: undoing step i waits the delay that preceded step i + 1
+    return index == 0 ? 0 : steps_[count_ - index].delay_us;
+}
+
+void PowerSequencer::finish(esp_err_t result)
+{
+    // Unwind the rails already switched by this run, most recent first
+    if (result != ESP_OK) {
+        for (size_t i = position_; i > 0; i--) {
+            esp_err_t ret = apply_step(i - 1, true);
+            if (ret != ESP_OK) {
+                ESP_LOGE(
+                    TAG,
+                    "Failed to unwind step %u, error: %s",
+                    static_cast<unsigned>(i - 1),
+                    esp_err_to_name(ret));
+            }
+        }
+    }
+
+    running_ = false;
+    ESP_LOGD(TAG, "Sequence finished (status: %s)", result == ESP_OK ? "OK" : "unwound");
+
+    // Callback last: it may start a new run
+    if (callback_ != nullptr) {
+        callback_(result, ctx_);
+    }
+}
+
+void PowerSequencer::timer_cb(void *arg)
+{
+    PowerSequencer *self = static_cast<PowerSequencer *>(arg);
+    if (self->running_) {
+        self->run();
+    }
+}
+
+} // namespace power_control
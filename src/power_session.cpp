@@ -0,0 +1,114 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "power_session.hpp"
+
+namespace power_control {
+
+static const char *TAG = "PowerSession";
+
+PowerSession::PowerSession(PowerSession &&other)
+    : rail_(other.rail_)
+    , shared_(other.shared_)
+    , timer_(other.timer_)
+    , ready_at_us_(other.ready_at_us_)
+{
+    other.rail_ = nullptr;
+    other.shared_ = nullptr;
+}
+
+PowerSession &PowerSession::operator=(PowerSession &&other)
+{
+    if (this != &other) {
+        release();
+        rail_ = other.rail_;
+        shared_ = other.shared_;
+        timer_ = other.timer_;
+        ready_at_us_ = other.ready_at_us_;
+        other.rail_ = nullptr;
+        other.shared_ = nullptr;
+    }
+    return *this;
+}
+
+esp_err_t PowerSession::acquire(IPowerControl &rail, ITimerHAL &timer, uint32_t settle_us, PowerSession &session)
+{
+    session.release();
+
+    const bool was_on = rail.is_on();
+    esp_err_t ret = rail.turn_on();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to turn GPIO %d ON, error: %s", rail.get_pin(), esp_err_to_name(ret));
+        return ret;
+    }
+
+    session.rail_ = &rail;
+    session.timer_ = &timer;
+    session.ready_at_us_ = timer.get_time_us() + (was_on ? 0 : settle_us);
+    return ESP_OK;
+}
+
+esp_err_t PowerSession::acquire(SharedPowerControl &shared, ITimerHAL &timer, uint32_t settle_us, PowerSession &session)
+{
+    session.release();
+
+    // Held or lingering: another user powered it earlier
+    const bool was_on = shared.is_on();
+    esp_err_t ret = shared.acquire();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to acquire shared rail, error: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    session.shared_ = &shared;
+    session.timer_ = &timer;
+    session.ready_at_us_ = timer.get_time_us() + (was_on ? 0 : settle_us);
+    return ESP_OK;
+}
+
+int64_t PowerSession::get_remaining_us() const
+{
+    if (!is_active()) {
+        return 0;
+    }
+    const int64_t remaining = ready_at_us_ - timer_->get_time_us();
+    return remaining > 0 ? remaining : 0;
+}
+
+esp_err_t PowerSession::wait_ready()
+{
+    if (!is_active()) {
+        ESP_LOGE(TAG, "Session holds no rail");
+        return ESP_ERR_INVALID_STATE;
+    }
+    const int64_t remaining = get_remaining_us();
+    if (remaining > 0) {
+        timer_->delay_us(static_cast<uint32_t>(remaining));
+    }
+    return ESP_OK;
+}
+
+esp_err_t PowerSession::release()
+{
+    esp_err_t ret = ESP_OK;
+    if (shared_ != nullptr) {
+        ret = shared_->release();
+    }
+    else if (rail_ != nullptr) {
+        ret = rail_->turn_off();
+    }
+    else {
+        return ESP_OK;
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to end session, error: %s", esp_err_to_name(ret));
+    }
+    rail_ = nullptr;
+    shared_ = nullptr;
+    return ret;
+}
+
+} // namespace power_control
@@ -0,0 +1,326 @@
+#include <atomic>
+#include <cstring>
+
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "power_telemetry.hpp"
+
+#if CONFIG_POWER_CONTROL_TELEMETRY
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "esp_timer.h"
+#endif
+
+namespace power_control {
+
+namespace {
+
+/// Counters of a slot, as maintained by the writer
+struct SlotData
+{
+    uint64_t on_time_us; ///< Closed ON periods
+    int64_t on_since_us; ///< Start of the current ON period
+    uint32_t on_count;   ///< OFF -> ON transitions
+    uint8_t gpio;        ///< GPIO pin number
+    uint8_t on;          ///< Logical state (1 = ON)
+};
+
+/**
+ * @brief Table slot
+ *
+ * seq is odd while a writer holds the counters. Transitions are first posted to
+ * pending (count in bits 0-3, states in order from bit 4) and applied by whichever
+ * writer holds the slot, so a writer that interrupts another never waits for it.
+ * The fault is a single value and lives outside the seqlock.
+ */
+struct Slot
+{
+    std::atomic<uint32_t> seq;
+    std::atomic<uint16_t> pending;
+    std::atomic<uint8_t> fault;
+    SlotData data;
+};
+
+/// Transitions a slot can hold while it is being written
+constexpr uint32_t MAX_PENDING = 12;
+static_assert(sizeof(Slot) == 32, "Slot must stay 32 bytes");
+
+/// Reads of a slot before it is left out of the snapshot
+constexpr int READ_ATTEMPTS = 4;
+
+Slot slots[PowerTelemetry::MAX_RAILS];
+std::atomic<uint64_t> claimed{0};   ///< Slots owned by a rail
+std::atomic<uint64_t> published{0}; ///< Claimed slots whose counters are initialized
+
+#if CONFIG_IDF_TARGET_LINUX
+ITimerHAL *host_timer = nullptr;
+#endif
+
+inline int64_t IRAM_ATTR now_us()
+{
+#if CONFIG_IDF_TARGET_LINUX
+    return host_timer != nullptr ? host_timer->get_time_us() : 0;
+#else
+    return esp_timer_get_time();
+#endif
+}
+
+/// Claim the write section of a slot (even -> odd); fails if another writer holds it
+inline bool IRAM_ATTR write_begin(Slot &slot, uint32_t &seq)
+{
+    seq = slot.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) != 0 || !slot.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_seq_cst)) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    seq += 2;
+    return true;
+}
+
+inline void IRAM_ATTR write_end(Slot &slot, uint32_t seq)
+{
+    slot.seq.store(seq, std::memory_order_seq_cst);
+}
+
+inline void IRAM_ATTR apply_transition(SlotData &data, bool on, int64_t now)
+{
+    if (on) {
+        data.on_count++;
+        data.on_since_us = now;
+    }
+    else if (data.on != 0) {
+        data.on_time_us += static_cast<uint64_t>(now - data.on_since_us);
+        data.on_since_us = -1;
+    }
+    data.on = on ? 1 : 0;
+}
+
+/// Queue a transition for the writer that holds (or next claims) the slot
+inline void IRAM_ATTR post_transition(Slot &slot, bool on)
+{
+    uint16_t cur = slot.pending.load(std::memory_order_relaxed);
+    uint16_t next = 0;
+    do {
+        const uint32_t count = cur & 0xF;
+        if (count == MAX_PENDING) {
+            return; // Holder stalled for MAX_PENDING transitions: drop this one
+        }
+        next = static_cast<uint16_t>((cur | (on ? 1u << (4 + count) : 0u)) + 1);
+    } while (!slot.pending.compare_exchange_weak(cur, next, std::memory_order_seq_cst, std::memory_order_relaxed));
+}
+
+/**
+ * @brief Apply the posted transitions, unless another writer holds the slot
+ *
+ * The holder checks pending again after its write_end(), so a transition posted
+ * while it held the slot is never left behind.
+ */
+inline void IRAM_ATTR drain_transitions(Slot &slot)
+{
+    while (slot.pending.load(std::memory_order_seq_cst) != 0) {
+        uint32_t seq = 0;
+        if (!write_begin(slot, seq)) {
+            return; // The holder applies it
+        }
+        const uint16_t posted = slot.pending.exchange(0, std::memory_order_acquire);
+        const int64_t now = now_us();
+        for (uint32_t i = 0; i < (posted & 0xFu); i++) {
+            apply_transition(slot.data, (posted & (1u << (4 + i))) != 0, now);
+        }
+        write_end(slot, seq);
+    }
+}
+
+/**
+ * @brief Copy the counters of one slot, if they can be read consistently
+ */
+bool read_slot(const Slot &slot, SlotData &out)
+{
+    for (int attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+        const uint32_t seq = slot.seq.load(std::memory_order_acquire);
+        if ((seq & 1) != 0) {
+            continue; // Being written
+        }
+        std::memcpy(&out, &slot.data, sizeof(out));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == seq) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+void put_u64(uint8_t *p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+uint32_t get_u32(const uint8_t *p)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        v |= static_cast<uint32_t>(p[i]) << (8 * i);
+    }
+    return v;
+}
+
+uint64_t get_u64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    return v;
+}
+
+} // namespace
+
+uint8_t PowerTelemetry::attach(gpio_num_t gpio)
+{
+    for (size_t i = 0; i < MAX_RAILS; i++) {
+        const uint64_t bit = 1ULL << i;
+        if ((claimed.fetch_or(bit, std::memory_order_acq_rel) & bit) != 0) {
+            continue; // Owned by another rail
+        }
+        // No writer: the rail that owned the slot is gone. A reader may still be copying it
+        Slot &slot = slots[i];
+        uint32_t seq = 0;
+        write_begin(slot, seq);
+        slot.data = {};
+        slot.data.on_since_us = -1;
+        slot.data.gpio = static_cast<uint8_t>(gpio);
+        slot.pending.store(0, std::memory_order_relaxed);
+        slot.fault.store(static_cast<uint8_t>(PowerFault::NONE), std::memory_order_relaxed);
+        write_end(slot, seq);
+        published.fetch_or(bit, std::memory_order_release);
+        return static_cast<uint8_t>(i);
+    }
+    return NO_SLOT;
+}
+
+void PowerTelemetry::detach(uint8_t slot)
+{
+    if (slot >= MAX_RAILS) {
+        return;
+    }
+    const uint64_t bit = 1ULL << slot;
+    published.fetch_and(~bit, std::memory_order_release);
+    claimed.fetch_and(~bit, std::memory_order_release);
+}
+
+void IRAM_ATTR PowerTelemetry::record(uint8_t slot, bool on)
+{
+    if (slot >= MAX_RAILS) {
+        return;
+    }
+    post_transition(slots[slot], on);
+    drain_transitions(slots[slot]);
+}
+
+void IRAM_ATTR PowerTelemetry::record_fault(uint8_t slot, PowerFault fault)
+{
+    if (slot >= MAX_RAILS) {
+        return;
+    }
+    slots[slot].fault.store(static_cast<uint8_t>(fault), std::memory_order_release);
+}
+
+size_t PowerTelemetry::snapshot(PowerTelemetrySnapshot &out)
+{
+    const uint64_t mask = published.load(std::memory_order_acquire);
+    out.time_us = now_us();
+    out.rail_count = 0;
+    for (size_t i = 0; i < MAX_RAILS; i++) {
+        SlotData d;
+        if ((mask & (1ULL << i)) == 0 || !read_slot(slots[i], d)) {
+            continue;
+        }
+        const uint8_t fault = slots[i].fault.load(std::memory_order_acquire);
+        PowerTelemetryRail &r = out.rails[out.rail_count++];
+        r.on_time_us = d.on_time_us;
+        if (d.on != 0 && out.time_us > d.on_since_us) {
+            r.on_time_us += static_cast<uint64_t>(out.time_us - d.on_since_us);
+        }
+        r.on_count = d.on_count;
+        r.off_count = d.on_count - d.on;
+        r.gpio = d.gpio;
+        r.on = d.on;
+        r.fault = static_cast<PowerFault>(fault);
+    }
+    return out.rail_count;
+}
+
+size_t PowerTelemetry::serialize(const PowerTelemetrySnapshot &snapshot, uint8_t *buf, size_t len)
+{
+    const size_t count = snapshot.rail_count <= MAX_RAILS ? snapshot.rail_count : MAX_RAILS;
+    const size_t size = FRAME_HEADER_SIZE + count * FRAME_RAIL_SIZE;
+    if (buf == nullptr || len < size) {
+        return 0;
+    }
+
+    buf[0] = FRAME_VERSION;
+    buf[1] = static_cast<uint8_t>(count);
+    buf[2] = 0;
+    buf[3] = 0;
+    put_u64(&buf[4], static_cast<uint64_t>(snapshot.time_us));
+
+    uint8_t *p = buf + FRAME_HEADER_SIZE;
+    for (size_t i = 0; i < count; i++, p += FRAME_RAIL_SIZE) {
+        const PowerTelemetryRail &r = snapshot.rails[i];
+        p[0] = r.gpio;
+        p[1] = static_cast<uint8_t>((r.on != 0 ? 0x01 : 0x00) | (static_cast<uint8_t>(r.fault) << 4));
+        put_u32(&p[2], r.on_count);
+        put_u64(&p[6], r.on_time_us);
+    }
+    return size;
+}
+
+esp_err_t PowerTelemetry::deserialize(const uint8_t *buf, size_t len, PowerTelemetrySnapshot &out)
+{
+    if (buf == nullptr || len < FRAME_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (buf[0] != FRAME_VERSION) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    const size_t count = buf[1];
+    if (count > MAX_RAILS || len < FRAME_HEADER_SIZE + count * FRAME_RAIL_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    out.time_us = static_cast<int64_t>(get_u64(&buf[4]));
+    out.rail_count = static_cast<uint32_t>(count);
+    const uint8_t *p = buf + FRAME_HEADER_SIZE;
+    for (size_t i = 0; i < count; i++, p += FRAME_RAIL_SIZE) {
+        PowerTelemetryRail &r = out.rails[i];
+        r.gpio = p[0];
+        r.on = p[1] & 0x01;
+        r.fault = static_cast<PowerFault>(p[1] >> 4);
+        r.on_count = get_u32(&p[2]);
+        r.off_count = r.on_count - r.on;
+        r.on_time_us = get_u64(&p[6]);
+    }
+    return ESP_OK;
+}
+
+#if CONFIG_IDF_TARGET_LINUX
+void PowerTelemetry::set_timer(ITimerHAL *timer)
+{
+    host_timer = timer;
+}
+#endif
+
+} // namespace power_control
+
+#endif // CONFIG_POWER_CONTROL_TELEMETRY
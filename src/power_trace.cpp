@@ -0,0 +1,159 @@
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "power_trace.hpp"
+
+#if CONFIG_POWER_CONTROL_TRACE
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#endif
+
+#if CONFIG_APPTRACE_ENABLE
+#include "esp_app_trace.h"
+#endif
+
+namespace power_control {
+
+namespace {
+
+/// Ring slot; seq is index + 1 once the record is complete, 0 while it is written
+struct Slot
+{
+    std::atomic<uint32_t> seq;
+    PowerTraceRecord record;
+};
+
+constexpr uint32_t MASK = PowerTrace::DEPTH - 1;
+
+Slot slots[PowerTrace::DEPTH];
+std::atomic<uint32_t> head{0};
+
+#if CONFIG_IDF_TARGET_LINUX
+ITimerHAL *host_timer = nullptr;
+#endif
+
+/**
+ * @brief Read one slot, if it still holds record @p index
+ */
+bool read_slot(uint32_t index, PowerTraceRecord &out)
+{
+    const Slot &slot = slots[index & MASK];
+    if (slot.seq.load(std::memory_order_acquire) != index + 1) {
+        return false; // Overwritten or being written
+    }
+    std::memcpy(&out, &slot.record, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == index + 1;
+}
+
+} // namespace
+
+void IRAM_ATTR PowerTrace::record(gpio_num_t gpio, bool on, esp_err_t result)
+{
+    const uint32_t index = head.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots[index & MASK];
+
+    // Invalidate first so a concurrent reader cannot take a half-written record
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+#if CONFIG_IDF_TARGET_LINUX
+    slot.record.time_us = host_timer != nullptr ? host_timer->get_time_us() : 0;
+    slot.record.core = 0;
+#else
+    slot.record.time_us = esp_timer_get_time();
+    slot.record.core = static_cast<uint8_t>(esp_cpu_get_core_id());
+#endif
+    slot.record.index = index;
+    slot.record.result = result;
+    slot.record.gpio = static_cast<uint8_t>(gpio);
+    slot.record.on = on ? 1 : 0;
+
+    slot.seq.store(index + 1, std::memory_order_release);
+}
+
+size_t PowerTrace::snapshot(PowerTraceRecord *out, size_t max)
+{
+    const uint32_t end = head.load(std::memory_order_acquire);
+    const uint32_t begin = end > DEPTH ? end - DEPTH : 0;
+    size_t count = 0;
+    for (uint32_t i = begin; i != end && count < max; i++) {
+        if (read_slot(i, out[count])) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void PowerTrace::dump()
+{
+    const uint32_t end = head.load(std::memory_order_acquire);
+    const uint32_t begin = end > DEPTH ? end - DEPTH : 0;
+    printf("PowerTrace: %" PRIu32 " records, showing %" PRIu32 "\n", end, end - begin);
+    for (uint32_t i = begin; i != end; i++) {
+        PowerTraceRecord r;
+        if (!read_slot(i, r)) {
+            continue;
+        }
+        printf(
+            "  #%" PRIu32 " %lld us core %u GPIO %u %s%s%s\n",
+            r.index,
+            static_cast<long long>(r.time_us),
+            r.core,
+            r.gpio,
+            r.on ? "ON" : "OFF",
+            r.result == ESP_OK ? "" : " failed: ",
+            r.result == ESP_OK ? "" : esp_err_to_name(r.result));
+    }
+}
+
+#if CONFIG_APPTRACE_ENABLE
+esp_err_t PowerTrace::export_apptrace(uint32_t timeout_us)
+{
+    const uint32_t end = head.load(std::memory_order_acquire);
+    const uint32_t begin = end > DEPTH ? end - DEPTH : 0;
+    for (uint32_t i = begin; i != end; i++) {
+        PowerTraceRecord r;
+        if (!read_slot(i, r)) {
+            continue;
+        }
+        esp_err_t ret = esp_apptrace_write(ESP_APPTRACE_DEST_JTAG, &r, sizeof(r), timeout_us);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return esp_apptrace_flush(ESP_APPTRACE_DEST_JTAG, timeout_us);
+}
+#endif
+
+void PowerTrace::clear()
+{
+    for (Slot &slot : slots) {
+        slot.seq.store(0, std::memory_order_relaxed);
+    }
+    head.store(0, std::memory_order_release);
+}
+
+uint32_t PowerTrace::get_total()
+{
+    return head.load(std::memory_order_acquire);
+}
+
+#if CONFIG_IDF_TARGET_LINUX
+void PowerTrace::set_timer(ITimerHAL *timer)
+{
+    host_timer = timer;
+}
+#endif
+
+} // namespace power_control
+
+#endif // CONFIG_POWER_CONTROL_TRACE
@@ -0,0 +1,282 @@
+#include <cinttypes>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "ramped_power_control.hpp"
+
+namespace power_control {
+
+static const char *TAG = "RampedPowerControl";
+
+RampedPowerControl::RampedPowerControl(
+    IGpioHAL &hal,
+    ILedcHAL &ledc,
+    ITimerHAL &timer,
+    const gpio_num_t gpio,
+    const bool inverted_logic,
+    const bool initial_on,
+    const uint32_t ramp_time_ms)
+    : hal_(hal)
+    , ledc_(ledc)
+    , timer_(timer)
+    , gpio_(gpio)
+    , inverted_logic_(inverted_logic)
+    , initial_on_(initial_on)
+    , ramp_time_ms_(ramp_time_ms)
+{
+}
+
+RampedPowerControl::~RampedPowerControl()
+{
+    if (ramp_timer_ != nullptr) {
+        timer_.stop(ramp_timer_);
+        timer_.remove(ramp_timer_);
+    }
+}
+
+esp_err_t RampedPowerControl::init()
+{
+    if (initialized_) {
+        return ESP_OK;
+    }
+
+    ESP_LOGI(
+        TAG,
+        "Initializing ramped power control on GPIO %d (active_%s, ramp %" PRIu32 " ms)",
+        gpio_,
+        inverted_logic_ ? "low" : "high",
+        ramp_time_ms_);
+
+    // Reset GPIO before initialization
+    esp_err_t ret = hal_.reset_pin(gpio_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to reset GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Start OFF; an initial ON state is reached through the ramp
+    ret = drive_gpio(inverted_logic_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Created once; it survives deinit/init cycles
+    if (ramp_timer_ == nullptr) {
+        ret = timer_.create(ramp_timer_cb, this, &ramp_timer_);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create ramp timer for GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+            ramp_timer_ = nullptr;
+            return ret;
+        }
+    }
+
+    initialized_ = true;
+    is_on_.store(false, std::memory_order_release);
+
+    if (initial_on_) {
+        ret = turn_on();
+        if (ret != ESP_OK) {
+            initialized_ = false;
+            return ret;
+        }
+    }
+
+    ESP_LOGI(TAG, "Ramped power control initialized successfully");
+    return ESP_OK;
+}
+
+esp_err_t RampedPowerControl::deinit()
+{
+    if (!initialized_) {
+        return ESP_OK;
+    }
+
+    esp_err_t final_ret = ESP_OK;
+
+    // Force GPIO low before deinitialization for safety; a hand-off in progress sees the OFF request
+    is_on_.store(false);
+    esp_err_t ret = ESP_OK;
+    if (ramping_.exchange(false)) {
+        timer_.stop(ramp_timer_);
+        ret = end_ramp(false);
+    }
+    else {
+        ret = hal_.set_level(gpio_, false);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set GPIO low during deinit");
+        final_ret = ret; // Store error but continue
+    }
+
+    // Reset GPIO (returns to high-impedance state)
+    ret = hal_.reset_pin(gpio_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to reset GPIO during deinit");
+        if (final_ret == ESP_OK) {
+            final_ret = ret; // Only override if no previous error
+        }
+    }
+
+    // Mark as deinitialized regardless of hardware errors
+    initialized_ = false;
+    is_on_.store(false, std::memory_order_release);
+    ESP_LOGI(
+        TAG,
+        "Ramped power control deinitialized on GPIO %d (status: %s)",
+        gpio_,
+        final_ret == ESP_OK ? "OK" : "partial failure");
+
+    return final_ret;
+}
+
+esp_err_t RampedPowerControl::set_drive_capability(gpio_drive_cap_t strength)
+{
+    if (!initialized_) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = hal_.set_drive_capability(gpio_, strength);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set GPIO %d drive capability to %d", gpio_, strength);
+        return ret;
+    }
+    ESP_LOGD(TAG, "GPIO %d drive capability set to %d ", gpio_, strength);
+    return ret;
+}
+
+esp_err_t RampedPowerControl::turn_on()
+{
+    if (!initialized_) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (is_on()) {
+        return ESP_OK; // Already ON or ramping
+    }
+
+    const bool on_level = !inverted_logic_;
+    if (ramp_time_ms_ == 0) {
+        esp_err_t ret = hal_.set_level(gpio_, on_level);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to turn GPIO %d ON, error: %s", gpio_, esp_err_to_name(ret));
+            return ret;
+        }
+        is_on_.store(true, std::memory_order_release);
+        return ESP_OK;
+    }
+
+    esp_err_t ret = ledc_.start_ramp(gpio_, inverted_logic_, ramp_time_ms_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start ramp on GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        drive_gpio(!on_level); // Take the pin back from a half-configured channel
+        ledc_.stop(gpio_);
+        return ret;
+    }
+    ramping_.store(true, std::memory_order_release);
+    is_on_.store(true, std::memory_order_release);
+
+    ret = timer_.start_once(ramp_timer_, static_cast<uint64_t>(ramp_time_ms_) * 1000);
+    if (ret != ESP_OK) {
+        // Without the hand-off the pin would stay on PWM: finish the ramp now
+        ESP_LOGE(TAG, "Failed to start ramp timer on GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+        if (ramping_.exchange(false)) {
+            end_ramp(on_level);
+        }
+        return ret;
+    }
+
+    ESP_LOGD(TAG, "GPIO %d ramping up over %" PRIu32 " ms", gpio_, ramp_time_ms_);
+    return ESP_OK;
+}
+
+esp_err_t RampedPowerControl::turn_off()
+{
+    if (!initialized_) {
+        ESP_LOGE(TAG, "Power control not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Published before the hand-off is claimed: a timer callback that won it drives OFF after its write
+    const bool was_on = is_on_.exchange(false);
+    const bool off_level = inverted_logic_;
+    esp_err_t ret = ESP_OK;
+    if (ramping_.exchange(false)) {
+        timer_.stop(ramp_timer_);
+        ret = end_ramp(off_level);
+    }
+    else {
+        ret = hal_.set_level(gpio_, off_level);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to turn GPIO %d OFF, error: %s", gpio_, esp_err_to_name(ret));
+        is_on_.store(was_on);
+        return ret;
+    }
+
+    ESP_LOGD(TAG, "GPIO %d OFF", gpio_);
+    return ESP_OK;
+}
+
+esp_err_t RampedPowerControl::toggle()
+{
+    return is_on() ? turn_off() : turn_on();
+}
+
+esp_err_t RampedPowerControl::drive_gpio(bool level)
+{
+    // Load the output register first so the pin takes the right level when it is routed back
+    esp_err_t ret = hal_.set_level(gpio_, level);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    gpio_config_t io_conf = {};
+    io_conf.mode = GPIO_MODE_INPUT_OUTPUT;
+    io_conf.pin_bit_mask = 1ULL << gpio_;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    return hal_.config(io_conf);
+}
+
+esp_err_t RampedPowerControl::end_ramp(bool level)
+{
+    esp_err_t ret = drive_gpio(level);
+    if (ret != ESP_OK) {
+        ramping_.store(true); // Pin still on PWM: give the hand-off back so turn_off() can retry
+        return ret;
+    }
+
+    ret = ledc_.stop(gpio_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to stop PWM channel of GPIO %d, error: %s", gpio_, esp_err_to_name(ret));
+    }
+    return ESP_OK; // The pin is already back on GPIO
+}
+
+void RampedPowerControl::ramp_timer_cb(void *arg)
+{
+    auto *self = static_cast<RampedPowerControl *>(arg);
+    if (!self->ramping_.exchange(false)) {
+        return; // turn_off() or deinit() took the hand-off
+    }
+    esp_err_t ret = self->end_ramp(!self->inverted_logic_);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to hand GPIO %d back after ramp, error: %s", self->gpio_, esp_err_to_name(ret));
+        return;
+    }
+    if (!self->is_on_.load()) {
+        // Turned OFF while this callback drove the ON level: that write must not stay
+        self->drive_gpio(self->inverted_logic_);
+        ESP_LOGD(TAG, "GPIO %d turned OFF during the hand-off", self->gpio_);
+        return;
+    }
+    ESP_LOGD(TAG, "GPIO %d ramp complete", self->gpio_);
+}
+
+} // namespace power_control
@@ -0,0 +1,190 @@
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define LOG_LOCAL_LEVEL CONFIG_POWER_CONTROL_LOG_LEVEL
+#include "esp_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "shared_power_control.hpp"
+
+namespace power_control {
+
+static const char *TAG = "SharedPowerControl";
+
+/// Busy-wait iterations before yielding the CPU while another task switches the rail
+static constexpr uint32_t SPINS_BEFORE_YIELD = 64;
+
+SharedPowerControl::SharedPowerControl(IPowerControl &rail)
+    : rail_(rail)
+    , timer_(nullptr)
+    , linger_us_(0)
+{
+}
+
+SharedPowerControl::SharedPowerControl(IPowerControl &rail, ITimerHAL &timer, uint32_t linger_us)
+    : rail_(rail)
+    , timer_(&timer)
+    , linger_us_(linger_us)
+{
+}
+
+SharedPowerControl::~SharedPowerControl()
+{
+    if (linger_timer_ != nullptr) {
+        timer_->stop(linger_timer_);
+        timer_->remove(linger_timer_);
+    }
+    // Do not leave a lingering rail ON behind
+    switch_off_if_idle();
+}
+
+esp_err_t SharedPowerControl::acquire()
+{
+    uint32_t spins = 0;
+    uint32_t state = state_.load(std::memory_order_acquire);
+    while (true) {
+        if ((state & SWITCHING_BIT) != 0) {
+            wait_for_switch(spins);
+            state = state_.load(std::memory_order_acquire);
+            continue;
+        }
+        if ((state & REF_MASK) == REF_MASK) {
+            ESP_LOGE(TAG, "Reference count overflow");
+            return ESP_ERR_INVALID_STATE;
+        }
+        if ((state & ON_BIT) != 0) {
+            // Rail already ON (held or lingering): just take a reference
+            if (state_.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel)) {
+                return ESP_OK;
+            }
+            continue;
+        }
+        // Rail OFF: this task makes the 0 -> 1 transition
+        if (state_.compare_exchange_weak(state, (state + 1) | SWITCHING_BIT, std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    // Other tasks only wait while SWITCHING_BIT is set, so the state can be stored directly
+    esp_err_t ret = ESP_OK;
+    if (timer_ != nullptr && linger_us_ > 0 && linger_timer_ == nullptr) {
+        ret = timer_->create(linger_timer_cb, this, &linger_timer_);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create linger timer, error: %s", esp_err_to_name(ret));
+            linger_timer_ = nullptr;
+        }
+    }
+    if (ret == ESP_OK) {
+        ret = rail_.turn_on();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to turn shared rail ON, error: %s", esp_err_to_name(ret));
+        state_.store(state & REF_MASK, std::memory_order_release);
+        return ret;
+    }
+
+    state_.store(((state & REF_MASK) + 1) | ON_BIT, std::memory_order_release);
+    ESP_LOGD(TAG, "Shared rail ON");
+    return ESP_OK;
+}
+
+esp_err_t SharedPowerControl::release()
+{
+    uint32_t spins = 0;
+    uint32_t state = state_.load(std::memory_order_acquire);
+    while (true) {
+        if ((state & SWITCHING_BIT) != 0) {
+            wait_for_switch(spins);
+            state = state_.load(std::memory_order_acquire);
+            continue;
+        }
+        const uint32_t refs = state & REF_MASK;
+        if (refs == 0) {
+            ESP_LOGE(TAG, "Release without matching acquire");
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (refs > 1 || linger_timer_ != nullptr) {
+            // Not the last reference, or the rail lingers: the rail stays ON
+            if (!state_.compare_exchange_weak(state, state - 1, std::memory_order_acq_rel)) {
+                continue;
+            }
+            if (refs > 1) {
+                return ESP_OK;
+            }
+            // Restart the linger window. A concurrent release may have re-armed it already.
+            timer_->stop(linger_timer_);
+            esp_err_t ret = timer_->start_once(linger_timer_, linger_us_);
+            if (ret == ESP_OK || ret == ESP_ERR_INVALID_STATE) {
+                return ESP_OK;
+            }
+            ESP_LOGE(TAG, "Failed to start linger timer, error: %s", esp_err_to_name(ret));
+            switch_off_if_idle();
+            return ret;
+        }
+        // Last reference without linger: this task makes the 1 -> 0 transition
+        if (state_.compare_exchange_weak(state, (state - 1) | SWITCHING_BIT, std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    esp_err_t ret = rail_.turn_off();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to turn shared rail OFF, error: %s", esp_err_to_name(ret));
+        state_.store(ON_BIT, std::memory_order_release); // Still ON, the next last release retries
+        return ret;
+    }
+
+    state_.store(0, std::memory_order_release);
+    ESP_LOGD(TAG, "Shared rail OFF");
+    return ESP_OK;
+}
+
+esp_err_t SharedPowerControl::switch_off_if_idle()
+{
+    uint32_t spins = 0;
+    uint32_t state = state_.load(std::memory_order_acquire);
+    while (true) {
+        if ((state & SWITCHING_BIT) != 0) {
+            wait_for_switch(spins);
+            state = state_.load(std::memory_order_acquire);
+            continue;
+        }
+        // Re-acquired (or already OFF) since the linger started: nothing to do
+        if (state != ON_BIT) {
+            return ESP_OK;
+        }
+        if (state_.compare_exchange_weak(state, ON_BIT | SWITCHING_BIT, std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    esp_err_t ret = rail_.turn_off();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to turn lingering rail OFF, error: %s", esp_err_to_name(ret));
+        state_.store(ON_BIT, std::memory_order_release);
+        return ret;
+    }
+
+    state_.store(0, std::memory_order_release);
+    ESP_LOGD(TAG, "Shared rail OFF after linger");
+    return ESP_OK;
+}
+
+void SharedPowerControl::wait_for_switch(uint32_t &spins)
+{
+    // A switch is one GPIO write: spin briefly, then let a lower-priority owner on this core run
+    if (++spins < SPINS_BEFORE_YIELD) {
+        return;
+    }
+    spins = 0;
+    vTaskDelay(1);
+}
+
+void SharedPowerControl::linger_timer_cb(void *arg)
+{
+    static_cast<SharedPowerControl *>(arg)->switch_off_if_idle();
+}
+
+} // namespace power_control
@@ -0,0 +1,155 @@
+#include <cinttypes>
+#include <cstdio>
+
+#include "esp_cpu.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "concurrent_power_control.hpp"
+#include "dedic_gpio_hal.hpp"
+#include "fast_gpio_hal.hpp"
+#include "power_command_queue.hpp"
+#include "power_control.hpp"
+#include "power_group.hpp"
+#include "power_profile.hpp"
+#include "static_power_control.hpp"
+
+using namespace power_control;
+
+// Cycle-count microbenchmarks. Each result is printed as one JSON object per line,
+// e.g. `idf.py monitor | grep '^{' > results.jsonl`, so runs can be diffed between releases.
+
+static constexpr uint32_t ITERATIONS = 1000;
+
+/**
+ * @brief Time @p fn ITERATIONS times and print min/avg/max cycles
+ *
+ * @p setup runs before every iteration, outside the measured window.
+ */
+template <typename Setup, typename Fn>
+static void run(const char *name, Setup setup, Fn fn)
+{
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        setup();
+        const uint32_t start = esp_cpu_get_cycle_count();
+        fn();
+        const uint32_t cycles = esp_cpu_get_cycle_count() - start;
+        min = cycles < min ? cycles : min;
+        max = cycles > max ? cycles : max;
+        total += cycles;
+    }
+
+    printf(
+        "{\"bench\":\"%s\",\"iterations\":%" PRIu32 ",\"min_cycles\":%" PRIu32 ",\"avg_cycles\":%" PRIu32
+        ",\"max_cycles\":%" PRIu32 "}\n",
+        name,
+        ITERATIONS,
+        min,
+        static_cast<uint32_t>(total / ITERATIONS),
+        max);
+}
+
+template <typename Fn>
+static void run(const char *name, Fn fn)
+{
+    run(name, [] {}, fn);
+}
+
+extern "C" void app_main(void)
+{
+    // Let the boot log drain so it does not interleave with the results
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    printf(
+        "{\"target\":\"%s\",\"idf\":\"%s\",\"cpu_mhz\":%d}\n",
+        CONFIG_IDF_TARGET,
+        esp_get_idf_version(),
+        CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+
+    GpioHAL gpio_hal;
+    FastGpioHAL fast_hal;
+    IGpioHAL &hal = gpio_hal;
+
+    run("baseline", [] {});
+
+    // ---- GPIO access without PowerControl ----
+    gpio_reset_pin(GPIO_NUM_4);
+    gpio_set_direction(GPIO_NUM_4, GPIO_MODE_INPUT_OUTPUT);
+    run("gpio_set_level", [] { gpio_set_level(GPIO_NUM_4, 1); });
+    run("gpio_hal.set_level", [&] { hal.set_level(GPIO_NUM_4, true); });
+    run("gpio_hal.set_levels_mask", [&] { hal.set_levels_mask(1ULL << GPIO_NUM_4, 0); });
+
+    // ---- PowerControl (driver HAL) ----
+    PowerControl pc(gpio_hal, GPIO_NUM_4);
+    run("power_control.init", [&] { pc.deinit(); }, [&] { pc.init(); });
+    run("power_control.turn_on", [&] { pc.turn_on(); });
+    run("power_control.toggle", [&] { pc.toggle(); });
+
+    pc.set_idempotent(true);
+    pc.turn_on();
+    run("power_control.turn_on.idempotent", [&] { pc.turn_on(); });
+    pc.set_idempotent(false);
+
+#if CONFIG_POWER_CONTROL_ISR_API
+    run("power_control.turn_on_from_isr", [&] { pc.turn_on_from_isr(); });
+#endif
+    pc.deinit();
+
+    // ---- PowerControl (fast-path HAL) ----
+    PowerControl fast_pc(fast_hal, GPIO_NUM_4);
+    fast_pc.init();
+    run("power_control.fast_hal.turn_on", [&] { fast_pc.turn_on(); });
+    run("power_control.fast_hal.toggle", [&] { fast_pc.toggle(); });
+    fast_pc.deinit();
+
+    // ---- Lock-free concurrent variant ----
+    ConcurrentPowerControl concurrent_pc(gpio_hal, GPIO_NUM_4);
+    run("concurrent_power_control.init", [&] { concurrent_pc.deinit(); }, [&] { concurrent_pc.init(); });
+    run("concurrent_power_control.turn_on", [&] { concurrent_pc.turn_on(); });
+    run("concurrent_power_control.toggle", [&] { concurrent_pc.toggle(); });
+    concurrent_pc.deinit();
+
+    // ---- Compile-time variant ----
+    StaticPowerControl<GPIO_NUM_4, false> static_pc(gpio_hal);
+    run("static_power_control.init", [&] { static_pc.deinit(); }, [&] { static_pc.init(); });
+    run("static_power_control.turn_on", [&] { static_pc.turn_on(); });
+    run("static_power_control.toggle", [&] { static_pc.toggle(); });
+    static_pc.deinit();
+
+    // ---- Batched group of three rails ----
+    const PowerGroup::Rail rails[] = {
+        {GPIO_NUM_4, false},
+        {GPIO_NUM_5, true},
+        {GPIO_NUM_6, false},
+    };
+    PowerGroup group(gpio_hal, rails, 3);
+    run("power_group.init.3_rails", [&] { group.deinit(); }, [&] { group.init(); });
+    run("power_group.turn_on_all.3_rails", [&] { group.turn_on_all(); });
+    group.deinit();
+
+    // ---- Asynchronous front-end: enqueue cost only (no power task, drained outside the window) ----
+    PowerControl queued_pc(gpio_hal, GPIO_NUM_4);
+    queued_pc.init();
+    PowerControl *const queued_rails[] = {&queued_pc};
+    PowerProfileGroup queued_group(queued_rails);
+    PowerCommandQueue queue(queued_group);
+    run("power_command_queue.post", [&] { queue.drain(); }, [&] { queue.post(GPIO_NUM_4, PowerAction::TOGGLE); });
+    queued_pc.deinit();
+
+    // ---- Same group on a Dedicated GPIO bundle (GpioHAL writes without the peripheral) ----
+    const gpio_num_t bundle[] = {GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_6};
+    DedicGpioHAL dedic_hal(bundle);
+    PowerGroup dedic_group(dedic_hal, rails, 3);
+    dedic_group.init();
+    run("power_group.dedic_hal.turn_on_all.3_rails", [&] { dedic_group.turn_on_all(); });
+    run("dedic_hal.write_channels", [&] { dedic_hal.write_channels(0x7, 0x5); });
+    dedic_group.deinit();
+
+    printf("{\"done\":true}\n");
+}
@@ -1,4 +1,6 @@
+#include "fast_gpio_hal.hpp"
 #include "power_control.hpp"
+#include "static_power_control.hpp"
 
 using namespace power_control;
 
@@ -7,4 +9,11 @@ extern "C" void app_main(void)
     GpioHAL gpio_hal;
     PowerControl pc(gpio_hal, GPIO_NUM_4, false, false);
     pc.init();
+
+    StaticPowerControl<GPIO_NUM_5, false> static_pc(gpio_hal);
+    static_pc.init();
+
+    FastGpioHAL fast_hal;
+    PowerControl fast_pc(fast_hal, GPIO_NUM_6, false, false);
+    fast_pc.init();
 }